@@ -37,6 +37,9 @@ typedef unsigned char uint8_t;
 #define FALLING 2
 #define RISING 3
 
+#define LSBFIRST 0
+#define MSBFIRST 1
+
 #define DEFAULT 0
 #define EXTERNAL 1
 #define INTERNAL1V1 2
@@ -109,6 +112,18 @@ void analogWrite(uint8_t pin, int val);
 
 //endregion
 
+//region Advanced I/O
+
+unsigned long pulseIn(uint8_t pin, uint8_t state, unsigned long timeout);
+
+unsigned long pulseInLong(uint8_t pin, uint8_t state, unsigned long timeout);
+
+void shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t val);
+
+uint8_t shiftIn(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder);
+
+//endregion
+
 //region Timing
 
 void delay(unsigned long ms);
@@ -10,14 +10,17 @@
 #include <har/cargo_cell.hpp>
 #include <har/cell.hpp>
 #include <har/cell_base.hpp>
+#include <har/cell_batch.hpp>
 #include <har/co_queue.hpp>
 #include <har/coords.hpp>
 #include <har/exception.hpp>
+#include <har/field.hpp>
 #include <har/flags.hpp>
 #include <har/full_cell.hpp>
 #include <har/grid_cell.hpp>
 #include <har/model_info.hpp>
 #include <har/part.hpp>
+#include <har/part_type.hpp>
 #include <har/participant.hpp>
 #include <har/platform.hpp>
 #include <har/program.hpp>
@@ -6,6 +6,7 @@
 #define HAR_CELL_HPP
 
 #include <har/cell_base.hpp>
+#include <har/look.hpp>
 #include <har/part.hpp>
 #include <har/property.hpp>
 #include <har/traits.hpp>
@@ -23,6 +24,9 @@ namespace har {
 
     class grid_cell_base;
 
+    template<typename... Slots>
+    class typed_cell;
+
     class part;
 
     /// \brief Class for access to grid cell cell and cargo cells
@@ -32,6 +36,13 @@ namespace har {
         cell_base & _cell; ///<The cell from which the cargo is accessed
         cell_cat _cat; ///<Category of the cell
 
+        /// \brief Records a property written past <tt>har::property</tt> as changed and, if visual, to be drawn
+        /// \param [in] id ID of the written property
+        void written(of id);
+
+        template<typename... Slots>
+        friend class typed_cell;
+
     public:
 
         /// \brief Creates a base over a base for parts and participants to operate upon
@@ -65,6 +76,11 @@ namespace har {
         [[nodiscard]]
         const part & logic();
 
+        /// \brief Summarizes how the cell looks
+        /// \return The cell's part and the values of its visual properties, if its images may be shared
+        [[nodiscard]]
+        std::optional<look_t> look() const;
+
         /// \brief Checks for the category of this cell.
         /// \return The category of this cell
         ///
@@ -7,11 +7,16 @@
 #ifndef HAR_CELL_BASE_HPP
 #define HAR_CELL_BASE_HPP
 
+#include <array>
+#include <cstdint>
 #include <map>
+#include <optional>
 #include <sstream>
+#include <vector>
 
 #include <har/exception.hpp>
 #include <har/flags.hpp>
+#include <har/look.hpp>
 #include <har/part.hpp>
 #include <har/value.hpp>
 
@@ -19,6 +24,9 @@ namespace har {
 
     class part;
 
+    template<typename... Slots>
+    class typed_cell;
+
     namespace exception {
         class cell_format_error : public exception {
         private:
@@ -31,14 +39,62 @@ namespace har {
         };
     }
 
+    /// Properties defined in the property model of the assigned part are stored by their slot in the part's layout.
+    /// Each slot is double-buffered: One buffer holds the committed value, the other one the intermediate value.
+    /// Committing a cell flips the buffers of all slots with intermediate values at once.
+    /// Properties outside of the model are kept in maps.
     /// \brief Underlying data structure for cells in a simulation
     class cell_base {
     protected:
         using Map = map<of, value>;
+        using Mask = std::vector<std::uint64_t>;
 
         std::reference_wrapper<const part> _logic; ///<Currently assigned part
-        Map _properties; ///<Map of properties
-        Map _intermediate; ///<Map of temporary properties to be changed in a cycle
+        std::array<std::vector<value>, 2> _buffers; ///<Both state buffers by slot
+        Mask _front; ///<Buffer that holds the committed value of each slot
+        Mask _dirty; ///<Slots that hold an intermediate value
+        Map _loose; ///<Properties outside of the part's layout
+        Map _iloose; ///<Temporary properties outside of the part's layout
+
+        /// \brief Extends the slot storage to the current layout of the part
+        void fit();
+
+        /// \brief Moves all properties into the layout of another part
+        /// \param [in] pt The other part
+        void reslot(const part & pt);
+
+        [[nodiscard]]
+        static inline bool_t is_set(const Mask & mask, std::size_t slot) {
+            return (mask[slot / 64u] >> (slot % 64u)) & 1u;
+        }
+
+        [[nodiscard]]
+        inline const value & front(std::size_t slot) const {
+            return _buffers[is_set(_front, slot)][slot];
+        }
+
+        [[nodiscard]]
+        inline const value & back(std::size_t slot) const {
+            return _buffers[!is_set(_front, slot)][slot];
+        }
+
+        inline value & back(std::size_t slot) {
+            return _buffers[!is_set(_front, slot)][slot];
+        }
+
+        inline void mark_dirty(std::size_t slot) {
+            _dirty[slot / 64u] |= std::uint64_t(1u) << (slot % 64u);
+        }
+
+        [[noreturn]]
+        static void raise_missing(of id);
+
+        /// \brief Returns the IDs of the slotted properties of the cell's part
+        [[nodiscard]]
+        const std::vector<of> & layout() const;
+
+        template<typename... Slots>
+        friend class typed_cell;
 
     public:
         static cell_base & invalid(); ///<Invalid cell_base
@@ -59,18 +115,71 @@ namespace har {
         /// \return The part this cell is assigned to
         const part & logic() const;
 
-        /// \brief Gets the properties of the cell
-        /// \return The map of iproperties
-        const Map & properties() const;
+        /// \brief Summarizes how the cell looks
+        ///
+        /// Cells of the same part and placement with equal values for its visual properties look the same.
+        /// \param [in] placed Whether the cell is placed
+        /// \return The part and the values of its visual properties, if the part shares images
+        /// and none of the values is a special type or callback
+        [[nodiscard]]
+        std::optional<look_t> look(bool_t placed) const;
 
-        /// \brief Gets the intermediate properties of the cell
+        /// \brief Collects the properties of the cell
+        /// \return The map of properties
+        Map properties() const;
+
+        /// \brief Collects the intermediate properties of the cell
         /// \return The map of intermediate properties
-        const Map & intermediate() const;
+        Map intermediate() const;
+
+        /// \brief Invokes a function for every property of the cell
+        /// \param [in] fun Function taking the ID and the value of the property
+        template<typename F>
+        void for_each_property(F && fun) const {
+            const auto & layout = this->layout();
+            for (std::size_t i = 0; i < _buffers[0].size(); ++i) {
+                if (auto & val = front(i); val.index()) {
+                    fun(layout[i], val);
+                }
+            }
+            for (auto &[id, val] : _loose) {
+                fun(id, val);
+            }
+        }
+
+        /// \brief Invokes a function for every intermediate property of the cell
+        /// \param [in] fun Function taking the ID and the value of the property
+        template<typename F>
+        void for_each_intermediate(F && fun) const {
+            const auto & layout = this->layout();
+            for (std::size_t w = 0; w < _dirty.size(); ++w) {
+                for (std::size_t b = 0; b < 64u && (_dirty[w] >> b); ++b) {
+                    if ((_dirty[w] >> b) & 1u) {
+                        fun(layout[w * 64u + b], back(w * 64u + b));
+                    }
+                }
+            }
+            for (auto &[id, val] : _iloose) {
+                fun(id, val);
+            }
+        }
+
+        /// \brief Checks whether the cell holds intermediate properties
+        /// \return <tt>TRUE</tt>, if there are intermediate properties
+        [[nodiscard]]
+        bool_t has_intermediate() const;
 
         /// \brief Changes the part the cell is assigned to
         /// \param [in] pt New part
         void set_type(const part & pt);
 
+        /// \brief Returns whether the cell has a committed value for a property
+        /// \param [in] id ID of the property
+        /// \return <tt>TRUE</tt>, if <tt>get(id)</tt> returns a value
+        [[nodiscard]]
+        bool_t has(of id) const;
+
+        /// Without <tt>now</tt>, the committed value is read, even if an intermediate value was written in this cycle.
         /// \brief Gets the value of a property
         /// \param [in] id ID of the property
         /// \param [in] now <tt>TRUE</tt>, if intermediate properties, if existent, should be heeded
@@ -93,7 +202,7 @@ namespace har {
         /// \brief Removes all properties and intermediate properties from the cell
         void clear();
 
-        /// \brief Adopts all intermediate properties
+        /// \brief Adopts all intermediate properties by flipping the buffers of their slots
         void transit();
 
         /// \brief Adopts all properties of another cell
@@ -0,0 +1,65 @@
+#pragma once
+
+#ifndef HAR_CELL_BATCH_HPP
+#define HAR_CELL_BATCH_HPP
+
+#include <cstddef>
+
+#include <har/grid_cell.hpp>
+#include <har/types.hpp>
+
+namespace har {
+
+    class context;
+
+    class grid_cell_base;
+
+    /// The automaton hands a batch to <tt>har::part::part_delegates::cycle_batch</tt>
+    /// when cycling runs of adjacent cells of the same part in batches.
+    /// \brief Grid cells of the same part, cycled in one call
+    class cell_batch {
+    private:
+        context & _ctx; ///<Context of the cycling worker
+        grid_cell_base * const * _cells; ///<First cell of the batch
+        std::size_t _size; ///<Number of cells in the batch
+
+    public:
+        /// This constructor is only called by the automaton.
+        /// \brief Constructor
+        /// \param [in,out] ctx Context of the cycling worker
+        /// \param [in] cells First cell of the batch
+        /// \param [in] size Number of cells in the batch
+        cell_batch(context & ctx, grid_cell_base * const * cells, std::size_t size);
+
+        cell_batch(const cell_batch & ref) = delete;
+
+        /// \brief Returns the number of cells in the batch
+        /// \return The number of cells
+        [[nodiscard]]
+        std::size_t size() const;
+
+        /// \brief Accesses a cell of the batch
+        /// \param [in] i Index of the cell
+        /// \return The cell
+        [[nodiscard]]
+        grid_cell at(std::size_t i);
+
+        /// \brief Calls a function for every cell of the batch
+        /// \tparam F Type of the function, taking a <tt>har::cell &</tt>
+        /// \param [in] fun The function
+        template<typename F>
+        void for_each(F && fun) {
+            for (std::size_t i = 0u; i < _size; ++i) {
+                grid_cell gcl{ _ctx, *_cells[i] };
+                fun(static_cast<cell &>(gcl));
+            }
+        }
+
+        cell_batch & operator=(const cell_batch & ref) = delete;
+
+        /// \brief Default destructor
+        ~cell_batch() = default;
+    };
+}
+
+#endif //HAR_CELL_BATCH_HPP
@@ -8,131 +8,192 @@
 #define HAR_CO_QUEUE_HPP
 
 #include <atomic>
-#include <deque>
-#include <mutex>
+#include <cstddef>
+#include <initializer_list>
+#include <tuple>
+#include <utility>
 
 namespace har {
 
+    /// \brief Lock-free queue for many producers and a single consumer
     ///
-    /// \tparam T
+    /// Producers push onto a linked stack with a single compare-and-swap.
+    /// The consumer takes the whole stack in one atomic exchange
+    /// and processes the taken batch in the order it was pushed in, without touching shared state.
+    /// All members but <tt>push</tt> may only be called by the consumer.
+    /// \tparam T Type of the elements
     template<typename T>
     class co_queue {
     private:
-        mutable std::atomic<unsigned> _quewait; ///<
-        mutable std::mutex _queex; ///<
-        std::deque<T> _queue; ///<
-
-        static_assert(decltype(_quewait)::is_always_lock_free, "Atomic counter is not lock-free!");
+        /// \brief Node holding a pushed element
+        struct node {
+            T value; ///<The element
+            node * next; ///<Next node
+        };
+
+        std::atomic<node *> _head; ///<Node pushed last, links to the nodes pushed before
+        node * _batch; ///<Taken nodes in the order they were pushed in, only touched by the consumer
+
+        static_assert(decltype(_head)::is_always_lock_free, "Atomic pointer is not lock-free!");
+
+        /// \brief Links a chain of nodes in front of the stack
+        /// \param first Node pushed last in the chain
+        /// \param last Node pushed first in the chain
+        void link(node * first, node * last) {
+            last->next = _head.load(std::memory_order_relaxed);
+            while (!_head.compare_exchange_weak(last->next, first,
+                                                std::memory_order_release,
+                                                std::memory_order_relaxed));
+        }
 
-        ///
-        void lock() const {
-            _queex.lock();
+        /// \brief Takes the whole stack as the next batch, if the current batch is processed
+        /// \return <tt>true</tt>, if there are elements in the batch
+        bool fill() {
+            if (!_batch) {
+                node * taken = _head.exchange(nullptr, std::memory_order_acquire);
+                while (taken) {
+                    node * next = taken->next;
+                    taken->next = _batch;
+                    _batch = taken;
+                    taken = next;
+                }
+            }
+            return _batch;
         }
 
-        ///
-        void unlock() const {
-            _queex.unlock();
+        /// \brief Removes the first node of the batch
+        /// \return The element of the node
+        T take() {
+            node * first = _batch;
+            _batch = first->next;
+            T t{ std::move(first->value) };
+            delete first;
+            return t;
         }
 
     public:
 
         /// \brief Constructor
-        co_queue() : _quewait(0u),
-                     _queex(),
-                     _queue() {
+        co_queue() : _head(nullptr),
+                     _batch(nullptr) {
 
         }
 
-        ///
-        /// \return
+        co_queue(const co_queue & ref) = delete;
+
+        /// \brief Returns whether the queue is empty
+        /// \return <tt>true</tt>, if there are no elements to pop
         [[nodiscard]]
         bool empty() const {
-            lock();
-            bool empty = _queue.empty();
-            unlock();
-            return empty;
+            return !_batch && !_head.load(std::memory_order_acquire);
         }
 
-        ///
-        /// \param ref
+        /// \brief Pushes a copy of an element onto the queue
+        /// \param ref The element
         void push(const T & ref) {
-            lock();
-            _queue.push_front(ref);
-            unlock();
+            auto n = new node{ ref, nullptr };
+            link(n, n);
         }
 
-        ///
-        /// \param fref
+        /// \brief Pushes an element onto the queue
+        /// \param fref The element
         void push(T && fref) {
-            lock();
-            _queue.push_front(std::forward<T>(fref));
-            unlock();
+            auto n = new node{ std::forward<T>(fref), nullptr };
+            link(n, n);
         }
 
-        /// Pushes all elements in a range onto the queue
+        /// Pushes all elements in a range onto the queue at once
         /// \tparam Tp Iterator type
         /// \param begin Begin iterator
         /// \param end End iterator
         template<typename Tp>
         void push(Tp & begin, Tp & end) {
-            lock();
+            node * first = nullptr;
+            node * last = nullptr;
             for (; begin != end; begin++) {
-                _queue.push_front(*begin);
+                first = new node{ *begin, first };
+                if (!last) {
+                    last = first;
+                }
+            }
+            if (first) {
+                link(first, last);
             }
-            unlock();
         }
 
+        /// \brief Pops the element pushed first
         ///
-        /// \return
+        /// The queue must not be empty.
+        /// \return The element
         T pop() {
-            lock();
-            T t{ std::move(_queue.back()) };
-            _queue.pop_back();
-            unlock();
-            return t;
+            fill();
+            return take();
         }
 
+        /// \brief Pops the element pushed first and checks whether the queue got empty
         ///
-        /// \return
+        /// The queue must not be empty.
+        /// \return The element and whether the queue is empty now
         std::tuple<T, bool> pop_check() {
-            lock();
-            T t = _queue.back();
-            _queue.pop_back();
-            bool empty = _queue.empty();
-            unlock();
-            return std::make_tuple(t, empty);
+            T t = pop();
+            return std::make_tuple(std::move(t), empty());
         }
 
-        ///
-        /// \param consumer
-        void process_one(std::function<void(T &)> && consumer) {
-            lock();
-            if (!_queue.empty()) {
-                auto p = _queue.back();
-                _queue.pop_back();
-                unlock();
+        /// \brief Pops and processes the element pushed first, if any
+        /// \param consumer Function to process the element with
+        template<typename F>
+        void process_one(F && consumer) {
+            if (fill()) {
+                auto p = take();
                 consumer(p);
-                return;
             }
-            unlock();
         }
 
-        /// 
-        /// \param consumer
-        void process_all(std::function<void(T &)> && consumer) {
-            lock();
-            while (!_queue.empty()) {
-                auto p = _queue.back();
-                _queue.pop_back();
-                unlock();
+        /// \brief Pops and processes elements until the queue is empty
+        ///
+        /// Also processes elements pushed while processing.
+        /// \param consumer Function to process the elements with
+        template<typename F>
+        void process_all(F && consumer) {
+            while (fill()) {
+                auto p = take();
                 consumer(p);
-                lock();
             }
-            unlock();
         }
 
-        /// \brief Default destructor
-        ~co_queue() = default;
+        /// \brief Pops and processes all elements pushed so far
+        ///
+        /// Elements pushed while processing are left for the next call,
+        /// so producers can't keep the consumer busy.
+        /// \param consumer Function to process the elements with
+        /// \return Number of processed elements
+        template<typename F>
+        std::size_t drain(F && consumer) {
+            std::size_t count = 0u;
+            node * left = std::exchange(_batch, nullptr);
+            fill();
+            for (node * batch : { left, std::exchange(_batch, nullptr) }) {
+                while (batch) {
+                    //Takes ownership first, so the consumer may pop further elements
+                    node * first = batch;
+                    batch = first->next;
+                    T t{ std::move(first->value) };
+                    delete first;
+                    consumer(t);
+                    ++count;
+                }
+            }
+            return count;
+        }
+
+        co_queue & operator=(const co_queue & ref) = delete;
+
+        /// \brief Destructor
+        ~co_queue() {
+            while (fill()) {
+                take();
+            }
+        }
     };
 }
 
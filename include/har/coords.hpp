@@ -1048,6 +1048,25 @@ namespace std {
                    std::size_t(gc.pos.y);
         }
     };
+
+    /// Specialization of <tt>std::hash</tt> for cell handles
+    template<>
+    struct hash<har::cell_h> {
+        std::size_t operator()(const har::cell_h & hnd) const noexcept {
+            switch (hnd.index()) {
+                case har::cell_cat::GRID_CELL: {
+                    return hash<har::gcoords>()(hnd.coords());
+                }
+                case har::cell_cat::CARGO_CELL: {
+                    return ~hash<har::cargo_h>()(hnd.id());
+                }
+                case har::cell_cat::INVALID_CELL:
+                default: {
+                    return 0u;
+                }
+            }
+        }
+    };
 }
 
 #endif //HAR_COORDS_HPP
@@ -5,7 +5,15 @@
 #ifndef HAR_DUINO_HPP
 #define HAR_DUINO_HPP
 
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <vector>
 
 #include <har/program.hpp>
 
@@ -20,28 +28,111 @@ extern void loop();
 namespace har {
 
     /// \brief Provides a runtime for Arduino sketches
+    ///
+    /// Pin writes are buffered and applied in a single request at the next read, delay or call of <tt>loop</tt>.
+    /// Reads are answered from the pin states the simulation publishes after every cycle, without requesting it.
     class duino : public har::program {
     private:
+        /// \brief Kinds of buffered pin writes
+        enum class pin_op : ushort_t {
+            MODE,      ///<Sets the mode of a digital pin
+            DIGITAL,   ///<Sets a digital pin <tt>HIGH</tt> or <tt>LOW</tt>
+            ANALOG,    ///<Sets the duty cycle of a digital pin
+            REFERENCE, ///<Sets the reference voltage of an analog pin
+            INTERRUPT  ///<Sets the handler of an interrupt
+        };
+
+        /// \brief Pin write buffered until the next flush
+        struct pin_write {
+            pin_op op; ///<Kind of the write
+            uint8_t pin; ///<Pin or interrupt number
+            double_t val; ///<Written value
+            void (* fun)(); ///<Written interrupt handler
+        };
+
+        /// \brief States of the board's pins, as read in a single request
+        struct pin_snapshot {
+            std::array<double_t, 14> digital; ///<Voltage on the digital pins
+            std::array<double_t, 6> analog; ///<Voltage on the analog pins
+            std::array<double_t, 6> reference; ///<Reference voltage of the analog pins
+            double_t aref; ///<Voltage on the <tt>AREF</tt> pin
+        };
+
+        static constexpr uint_t PROBES = 27u; ///<Number of properties in a pin snapshot
+
+        static constexpr uint_t NEVER = std::numeric_limits<uint_t>::max(); ///<Cycle of a snapshot never taken
+
         std::chrono::time_point<har::clock> _start; ///<Timepoint of start of the runtime
         std::atomic<uint_t> _setup;
+        bool_t _virtual; ///<Whether time is counted in cycles instead of measured
+        std::chrono::microseconds _tick; ///<Simulated time per cycle
+        std::atomic<uint_t> _cycles; ///<Cycles since the runtime was attached
+        std::atomic<uint_t> _epoch; ///<Cycle the runtime was started in
+        std::mutex _tickex;
+        std::condition_variable _ticked; ///<Notified after every cycle
+        std::mutex _pinex; ///<Guards the buffered writes and the pin snapshot
+        std::vector<pin_write> _writes; ///<Pin writes not flushed yet
+        pin_snapshot _pins; ///<Pin states of the last read
+        uint_t _snapped; ///<Cycle the pin states were read in
+        std::array<void (*)(), 2> _handlers; ///<Attached interrupt handlers
+        bool_t _interrupting; ///<Whether interrupt handlers are running
+        std::function<bool_t(context &)> _job; ///<Pin operation stepped once every cycle until it is done
+        std::mt19937_64 _random; ///<Source of random numbers of the sketch
 
         /// \brief Maps an Arduino pin number to the appropriate "digital pin" cell in the corresponding model
-        /// \param [in] ctx Participant context
         /// \param [in] pin Pin number
-        /// \return The appropriate cell
-        static full_grid_cell map_cell_digital(context & ctx, uint8_t pin);
+        /// \return Position of the appropriate cell
+        static gcoords_t map_digital(uint8_t pin);
 
         /// \brief Maps an Arduino pin number to the appropriate "analog pin" cell in the corresponding model
+        /// \param [in] pin Pin number, either counted from <tt>A0</tt> or from <tt>0</tt>
+        /// \return Position of the appropriate cell
+        static gcoords_t map_analog(uint8_t pin);
+
+        /// \brief Maps an Arduino interrupt number to the appropriate cell in the corresponding model
+        /// \param [in] num Interrupt number
+        /// \return Position of the appropriate cell
+        static gcoords_t map_interrupt(uint8_t num);
+
+        /// \brief Buffers a pin write until the next flush
+        /// \param [in] write Pin write
+        void write(const pin_write & write);
+
+        /// \brief Applies the buffered pin writes
+        /// \param [in] ctx Participant context
+        void apply(context & ctx);
+
+        /// \brief Returns the properties of a pin snapshot in the order they are probed in
+        /// \return The probed properties
+        static std::vector<std::pair<gcoords_t, entry_h>> board_probes();
+
+        /// \brief Returns the pin states of the current cycle
+        ///
+        /// Flushes the buffered writes and takes the pin states published after the last cycle.
+        /// Until the first cycle, reads all pins in a single request,
+        /// unless the pins were read in the current cycle already.
+        /// \return The pin states
+        pin_snapshot read();
+
+        /// \brief Runs a pin operation that takes several cycles and waits for it to finish
+        ///
+        /// Flushes the buffered writes first.
+        /// The operation is stepped at the beginning of every cycle with the cycle's context,
+        /// so it does not request the simulation by itself.
+        /// \param [in] job Steps the operation, returns <tt>TRUE</tt> once the operation is done
+        void run(std::function<bool_t(context &)> && job);
+
+        /// \brief Returns whether a digital pin is <tt>HIGH</tt>
         /// \param [in] ctx Participant context
         /// \param [in] pin Pin number
-        /// \return The appropriate cell
-        static full_grid_cell map_cell_analog(context & ctx, uint8_t pin);
+        /// \return <tt>TRUE</tt>, if the pin is <tt>HIGH</tt>
+        static bool_t is_high(context & ctx, uint8_t pin);
 
-        /// \brief Maps an Arduino interrupt number to the appropriate cell in the corresponding model
+        /// \brief Sets a digital pin <tt>HIGH</tt> or <tt>LOW</tt>
         /// \param [in] ctx Participant context
         /// \param [in] pin Pin number
-        /// \return The appropriate cell
-        static full_grid_cell map_cell_interrupt(context & ctx, uint8_t num);
+        /// \param [in] high <tt>TRUE</tt> for <tt>HIGH</tt>
+        static void set_high(context & ctx, uint8_t pin, bool_t high);
 
     public:
         class parts {
@@ -109,6 +200,11 @@ namespace har {
         /// \brief Sets the start timepoint for the runtime and calls the <tt>setup</tt> function
         void on_model_loaded() override;
 
+        /// \brief Counts the cycle, which advances the simulated time and invalidates the read pin states,
+        /// and steps the running pin operation
+        /// \param [in] ctx Participant context
+        void on_cycle(participant::context & ctx) override;
+
         /// \brief Creates an exclusive context, if the participant is attached.
         /// Terminates the calling thread otherwise.
         /// \return A context
@@ -121,6 +217,32 @@ namespace har {
 
         void maybe_setup();
 
+        /// \brief Returns the time elapsed since the runtime was started
+        ///
+        /// With virtual time, this is the number of cycles since the start times the simulated time per cycle.
+        /// \return The elapsed time
+        [[nodiscard]]
+        std::chrono::microseconds elapsed() const;
+
+        /// \brief Pauses the calling thread for a duration
+        ///
+        /// Flushes the buffered pin writes first.
+        /// With virtual time, this waits until the simulation has cycled long enough.
+        /// Handlers of raised interrupts run after every cycle meanwhile.
+        /// Terminates the calling thread, if the participant gets detached meanwhile.
+        /// \param [in] duration Duration to pause for
+        void delay(std::chrono::microseconds duration);
+
+        /// \brief Applies all buffered pin writes in a single request
+        void flush();
+
+        /// \brief Runs the handlers of the interrupts raised since the last call
+        ///
+        /// The simulation detects the changes of the interrupt pins after every cycle,
+        /// so the handlers run once for every detected change.
+        /// Must be called by the sketch's thread, which does at every pin operation, during delays and after <tt>loop</tt>.
+        void service();
+
         /// \brief Reads the value from a specified digital pin, either <tt>HIGH</tt> or <tt>LOW</tt>.
         /// \param [in] pin the Arduino pin number you want to read
         /// \return <tt>HIGH</tt> or <tt>LOW</tt>
@@ -152,12 +274,43 @@ namespace har {
         /// \param [in] val the duty cycle: between 0 (always off) and 255 (always on)
         void analogWrite(uint8_t pin, int val);
 
+        /// \brief Reads a pulse (either <tt>HIGH</tt> or <tt>LOW</tt>) on a pin
+        ///
+        /// Waits for the pin to go to the state, measures until it leaves the state again
+        /// and ignores a pulse that was already going on.
+        /// The pin is sampled once every cycle, so the length is a multiple of a cycle's length.
+        /// \param [in] pin the number of the Arduino pin on which you want to read the pulse
+        /// \param [in] state type of pulse to read: either <tt>HIGH</tt> or <tt>LOW</tt>
+        /// \param [in] timeout the number of microseconds to wait for the pulse to be completed
+        /// \return The length of the pulse in microseconds or <tt>0</tt>, if no complete pulse was received within the timeout
+        unsigned long pulseIn(uint8_t pin, uint8_t state, unsigned long timeout);
+
+        /// \brief Shifts out a byte of data one bit at a time
+        ///
+        /// Every bit takes two cycles, one with the data set and the clock pin <tt>HIGH</tt> and one with the clock pin <tt>LOW</tt>.
+        /// \param [in] dataPin the pin on which to output each bit
+        /// \param [in] clockPin the pin to toggle once the dataPin has been set to the correct value
+        /// \param [in] bitOrder which order to shift out the bits; either <tt>MSBFIRST</tt> or <tt>LSBFIRST</tt>
+        /// \param [in] val the data to shift out
+        void shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t val);
+
+        /// \brief Shifts in a byte of data one bit at a time
+        ///
+        /// Every bit takes two cycles, one with the clock pin <tt>HIGH</tt> and one that reads the bit and sets the clock pin <tt>LOW</tt>.
+        /// \param [in] dataPin the pin on which to input each bit
+        /// \param [in] clockPin the pin to toggle to signal a read from dataPin
+        /// \param [in] bitOrder which order to shift in the bits; either <tt>MSBFIRST</tt> or <tt>LSBFIRST</tt>
+        /// \return The value read
+        uint8_t shiftIn(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder);
+
         ///
         /// \param [in] pin
         /// \return
         static uint8_t digitalPinToInterrupt(uint8_t pin);
 
+        /// \brief Sets the handler of an interrupt
         ///
+        /// The handler runs on the sketch's thread at the next call of <tt>service</tt>.
         /// \param [in] interruptNum the number of the interrupt
         /// \param [in] userFunc the ISR to call when the interrupt occurs
         /// \param [in] mode defines when the interrupt should be triggered <br/>
@@ -173,6 +326,24 @@ namespace har {
         /// \param [in] interruptNum the number of the interrupt to disable
         void detachInterrupt(uint8_t interruptNum);
 
+        /// \brief Returns a pseudo-random number
+        /// \param [in] max upper bound of the random value, exclusive
+        /// \return A random number between <tt>0</tt> and <tt>max - 1</tt>
+        long randomMax(long max);
+
+        /// \brief Returns a pseudo-random number
+        /// \param [in] min lower bound of the random value, inclusive
+        /// \param [in] max upper bound of the random value, exclusive
+        /// \return A random number between <tt>min</tt> and <tt>max - 1</tt>
+        long randomMinMax(long min, long max);
+
+        /// \brief Initializes the pseudo-random number generator
+        ///
+        /// The generator is seeded with <tt>--seed</tt>, if given, or randomly otherwise.
+        /// A seed of <tt>0</tt> is ignored, as on the Arduino.
+        /// \param [in] seed number to initialize the pseudo-random sequence
+        void randomSeed(unsigned long seed);
+
         /// \brief Default destructor
         ~duino() noexcept override;
     };
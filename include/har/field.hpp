@@ -0,0 +1,152 @@
+#pragma once
+
+#ifndef HAR_FIELD_HPP
+#define HAR_FIELD_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+#include <har/coords.hpp>
+#include <har/types.hpp>
+
+namespace har {
+
+    /// A part may cycle one of its properties as a field, see <tt>har::part::set_field</tt>.
+    /// The values are stored in row-major order, cells of other parts are left out by the mask.
+    /// \brief Dense values of a property of all cells of a part on a grid
+    /// \tparam T Type of the property's values, <tt>har::bool_t</tt> or <tt>har::double_t</tt>
+    template<typename T>
+    class field {
+    public:
+        static_assert(std::is_same_v<T, bool_t> || std::is_same_v<T, double_t>,
+                      "Fields hold boolean or floating point values");
+
+        /// \brief Type of the stored values, booleans are stored as 0 or 1
+        using element_t = std::conditional_t<std::is_same_v<T, bool_t>, std::uint8_t, T>;
+
+    private:
+        dcoords_t _dim; ///<Dimension of the grid
+        std::vector<element_t> _values; ///<Values of the cells
+        std::vector<std::uint8_t> _mask; ///<1 for every cell of the part, 0 otherwise
+
+    public:
+        /// \brief Constructor
+        field() : _dim(),
+                  _values(),
+                  _mask() {
+
+        }
+
+        /// \brief Resizes the field to a grid and clears all values and the mask
+        /// \param [in] dim Dimension of the grid
+        void reset(const dcoords_t & dim) {
+            _dim = dim;
+            _values.assign(dim.size(), element_t());
+            _mask.assign(dim.size(), 0u);
+        }
+
+        /// \brief Returns the dimension of the grid
+        /// \return The dimension of the grid
+        [[nodiscard]]
+        const dcoords_t & dim() const {
+            return _dim;
+        }
+
+        /// \brief Returns the number of cells in a row
+        /// \return The width of the grid
+        [[nodiscard]]
+        std::size_t width() const {
+            return std::size_t(_dim.x.v);
+        }
+
+        /// \brief Returns the number of rows
+        /// \return The height of the grid
+        [[nodiscard]]
+        std::size_t height() const {
+            return std::size_t(_dim.y.v);
+        }
+
+        /// \brief Returns the number of cells of the grid
+        /// \return The number of cells
+        [[nodiscard]]
+        std::size_t size() const {
+            return _values.size();
+        }
+
+        /// \brief Returns the values of a row
+        /// \param [in] y Index of the row
+        /// \return Pointer to the first value of the row
+        [[nodiscard]]
+        element_t * row(std::size_t y) {
+            return _values.data() + y * width();
+        }
+
+        /// \brief Returns the values of a row
+        /// \param [in] y Index of the row
+        /// \return Pointer to the first value of the row
+        [[nodiscard]]
+        const element_t * row(std::size_t y) const {
+            return _values.data() + y * width();
+        }
+
+        /// \brief Returns the mask of a row
+        /// \param [in] y Index of the row
+        /// \return Pointer to the mask of the first cell of the row
+        [[nodiscard]]
+        std::uint8_t * mask(std::size_t y) {
+            return _mask.data() + y * width();
+        }
+
+        /// \brief Returns the mask of a row
+        /// \param [in] y Index of the row
+        /// \return Pointer to the mask of the first cell of the row
+        [[nodiscard]]
+        const std::uint8_t * mask(std::size_t y) const {
+            return _mask.data() + y * width();
+        }
+
+        /// \brief Accesses the value of a cell
+        /// \param [in] n Index of the cell in row-major order
+        /// \return The value
+        element_t & operator[](std::size_t n) {
+            return _values[n];
+        }
+
+        /// \brief Accesses the value of a cell
+        /// \param [in] n Index of the cell in row-major order
+        /// \return The value
+        const element_t & operator[](std::size_t n) const {
+            return _values[n];
+        }
+
+        /// \brief Returns whether a cell is of the part
+        /// \param [in] n Index of the cell in row-major order
+        /// \return <tt>TRUE</tt>, if the cell is of the part
+        [[nodiscard]]
+        bool_t covers(std::size_t n) const {
+            return _mask[n];
+        }
+
+        /// \brief Default destructor
+        ~field() = default;
+    };
+
+    /// The kernel computes the next values of all cells of a part on a grid from their committed values.
+    /// <tt>out</tt> holds the committed values when the kernel is called,
+    /// so the kernel only needs to write the values that change.
+    /// \brief Kernel cycling the field of a part
+    template<typename T>
+    using field_kernel = std::function<void(const field<T> & in, field<T> & out)>;
+
+    /// The counts use AVX2, if the library was configured with <tt>HAR_AVX2</tt>, or SSE2 on x86-64.
+    /// \brief Counts the set cells in the Moore neighborhood of every cell in a row of a boolean field
+    /// \param [in] in The field
+    /// \param [in] y Index of the row
+    /// \param [out] counts Counts of the row, as wide as the field
+    void moore_count(const field<bool_t> & in, std::size_t y, std::uint8_t * counts);
+}
+
+#endif //HAR_FIELD_HPP
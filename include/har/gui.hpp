@@ -45,6 +45,11 @@ namespace har {
         [[nodiscard]]
         har::image_t process_image(har::cell_h hnd, har::image_t & img) override;
 
+        [[nodiscard]]
+        std::optional<har::image_t> find_image(const cell_h & hnd, const look_t & look) override;
+
+        void keep_image(const cell_h & hnd, const look_t & look, const har::image_t & img) override;
+
         istream & input() override;
 
         ostream & output() override;
@@ -77,6 +82,10 @@ namespace har {
 
         void on_redraw(const cell_h & hnd, har::image_t && img, bool_t commit) override;
 
+        void on_selection_update_batch(span<const update_t> batch) override;
+
+        void on_redraw_batch(span<redraw_t> batch) override;
+
         void on_connection_added(const gcoords_t & from, const gcoords_t & to, direction_t use) override;
 
         void on_connection_removed(const gcoords_t & from, direction_t use) override;
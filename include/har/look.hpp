@@ -0,0 +1,44 @@
+#pragma once
+
+#ifndef HAR_LOOK_HPP
+#define HAR_LOOK_HPP
+
+#include <vector>
+
+#include <har/value.hpp>
+
+namespace har {
+
+    /// Cells of the same part with equal values for its visual properties look alike,
+    /// if the part declares that their images depend on nothing else, see <tt>har::part::set_shared_images</tt>.
+    /// Placed cells never look like cells that aren't, as parts draw them apart, e.g. in the bank.
+    /// \brief Describes how a cell looks
+    struct look_t {
+        part_h part; ///<ID of the cell's part
+        bool_t placed; ///<Whether the cell is placed, see <tt>har::cell::is_placed</tt>
+        std::vector<value> visuals; ///<Values of the part's visual properties in ascending order of their IDs
+        std::size_t hash; ///<Hash of the part, the placement and the values
+
+        /// \brief Compares two looks for equality, NaN equals NaN
+        /// \param [in] rhs Other look
+        /// \return <tt>TRUE</tt>, if both looks are of the same part and placement with the same values
+        bool_t operator==(const look_t & rhs) const;
+
+        /// \brief Compares two looks for inequality
+        /// \param [in] rhs Other look
+        /// \return <tt>FALSE</tt>, if both looks are of the same part and placement with the same values
+        bool_t operator!=(const look_t & rhs) const;
+    };
+}
+
+namespace std {
+    /// Specialization of <tt>std::hash</tt> for looks of cells
+    template<>
+    struct hash<har::look_t> {
+        std::size_t operator()(const har::look_t & look) const noexcept {
+            return look.hash;
+        }
+    };
+}
+
+#endif //HAR_LOOK_HPP
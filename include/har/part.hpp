@@ -12,8 +12,10 @@
 #include <utility>
 #include <set>
 #include <variant>
+#include <vector>
 
 #include <har/cell.hpp>
+#include <har/field.hpp>
 #include <har/property.hpp>
 #include <har/traits.hpp>
 #include <har/value.hpp>
@@ -24,6 +26,12 @@ namespace har {
 
     class cell_base;
 
+    class cell_batch;
+
+    class context;
+
+    class grid_cell_base;
+
     ///
     enum ui_access : ushort_t {
         INVISIBLE = 0u, ///<Invisible in UIs
@@ -181,8 +189,23 @@ namespace har {
         std::map<direction_t, string_t> _conn_use; ///<Names for designated connections
         std::set<of> _visual; ///<Properties that the visuals of the cell depend on
         std::set<of> _waking; ///<Properties that wake this part on change
+        std::vector<of> _layout; ///<Property IDs in the order of their slots
+        std::vector<ushort_t> _slots; ///<Slot of each property ID, indexed by ID
+        of _field; ///<Property cycled as a field, or <tt>har::of::VOID</tt>
+        of _net_drive; ///<Property driving the electrical net of a cell, or <tt>har::of::VOID</tt>
+        of _net_sense; ///<Property receiving the voltage of the electrical net of a cell, or <tt>har::of::VOID</tt>
+        bool_t _netted; ///<Whether cells of the part take part in electrical nets
+        bool_t _joining; ///<Whether connections to cells of the part join electrical nets
+        bool_t _shared_images; ///<Whether images of cells of the part may be reused among cells that look alike
+
+        /// \brief Assigns a slot to a property ID, if it has none yet
+        /// \param [in] id ID of the property
+        void assign_slot(of id);
 
     public:
+        static constexpr ushort_t NO_SLOT = ushort_t(~0u); ///<Slot of property IDs outside of the layout
+        static constexpr uint_t MAX_SLOTTED_ID = 1u << 12u; ///<Property IDs from here on are never slotted
+
         static part & invalid(); ///<
 
         /// \brief Contains the function delegates that define the behaviour of the part
@@ -203,6 +226,11 @@ namespace har {
             /// \brief Delegate called to change the state of the cell
             /// \param [in,out] cl The cell
             std::function<void(cell & cl)> cycle;
+            /// The automaton calls it instead of <tt>cycle</tt> for runs of adjacent grid cells of the part,
+            /// if it cycles cells in batches.
+            /// \brief Delegate called to change the state of many cells at once
+            /// \param [in,out] cells The cells
+            std::function<void(cell_batch & cells)> cycle_batch;
             /// \brief Delegate called to move cargo on the cell
             /// \param [in,out] cl The cell
             std::function<void(cell & cl)> move;
@@ -224,6 +252,17 @@ namespace har {
             /// \param [in] id ID of the changed property
             /// \param [in] prop Changed property
             std::function<void(cell & cl, of id, const property & prop)> regulate;
+
+            /// Set by <tt>har::part_type::bind</tt> for parts defined as C++ types.
+            /// The automaton prefers it over <tt>cycle</tt> for grid cells.
+            /// \brief Cycles a grid cell without type erasure
+            /// \param [in,out] ctx Context of the cycling worker
+            /// \param [in,out] gclb The cell
+            void (* cycle_static)(context & ctx, grid_cell_base & gclb) = nullptr;
+            /// Set by <tt>har::part::set_field</tt>.
+            /// The automaton calls it instead of <tt>cycle</tt> once per cycle and grid.
+            /// \brief Kernel cycling a property of all cells of the part on a grid at once
+            std::variant<std::monostate, field_kernel<bool_t>, field_kernel<double_t>> cycle_field;
         } delegates;
 
         /// \brief Constructor
@@ -326,6 +365,17 @@ namespace har {
         [[nodiscard]]
         const decltype(_visual) & visual() const;
 
+        /// Only declare this, if the <tt>draw</tt> delegate reads nothing but the visual properties of the drawn cell,
+        /// i.e. neither invisible properties nor neighbors.
+        /// \brief Sets whether images of cells of this part may be reused among cells that look alike
+        /// \param [in] shared <tt>TRUE</tt>, if the images depend on the part and the visual properties only
+        void set_shared_images(bool_t shared = true);
+
+        /// \brief Returns whether images of cells of this part may be reused among cells that look alike
+        /// \return <tt>TRUE</tt>, if the images depend on the part and the visual properties only
+        [[nodiscard]]
+        bool_t shares_images() const;
+
         /// \brief Adds a property ID, which's change in neighbored and connected cells wakes up cells of this part
         /// \param id ID of the property
         void add_waking(entry_h id);
@@ -339,6 +389,75 @@ namespace har {
         [[nodiscard]]
         const decltype(_waking) & waking() const;
 
+        /// The property is gathered into a dense field of all cells of this part on a grid,
+        /// which the kernel cycles at once instead of the cycle delegate of every cell.
+        /// Only the changed values are written back into the cells.
+        /// \brief Cycles a boolean property of the cells of this part as a field
+        /// \param [in] id ID of the property, which has to be slotted and hold booleans
+        /// \param [in] kernel Kernel computing the next values of the field
+        void set_field(of id, field_kernel<bool_t> kernel);
+
+        /// \brief Cycles a floating point property of the cells of this part as a field
+        /// \param [in] id ID of the property, which has to be slotted and hold floating point values
+        /// \param [in] kernel Kernel computing the next values of the field
+        void set_field(of id, field_kernel<double_t> kernel);
+
+        /// \brief Returns the property cycled as a field
+        /// \return ID of the property, or <tt>har::of::VOID</tt>, if the part has no field
+        [[nodiscard]]
+        of field_id() const;
+
+        /// Cells joined by connections form electrical nets, which the automaton resolves once per cycle.
+        /// The voltage of a net is the mean of the voltages its members drive,
+        /// or NaN, if none of them drives it, and is written to all members that sense it.
+        /// Only connections between cells of joining parts join them,
+        /// so components with several terminals keep the nets on their terminals apart.
+        /// Cells of a part that doesn't join only sense the highest voltage among the nets they are connected to.
+        /// \brief Makes cells of this part take part in their electrical net
+        /// \param [in] drive ID of the floating point property whose value the cells drive their net with,
+        /// NaN if they don't, or <tt>har::of::VOID</tt>, if cells of this part never drive
+        /// \param [in] sense ID of the floating point property the voltage of the net is written to,
+        /// or <tt>har::of::VOID</tt>, if cells of this part don't sense
+        /// \param [in] joining Whether connections to cells of this part join nets,
+        /// cells of parts that don't join never drive
+        void set_net(of drive = of::VOID, of sense = of::VOID, bool_t joining = true);
+
+        /// \brief Returns whether cells of this part take part in electrical nets
+        /// \return <tt>TRUE</tt>, if <tt>har::part::set_net</tt> was called on this part
+        [[nodiscard]]
+        bool_t in_net() const;
+
+        /// \brief Returns whether connections to cells of this part join electrical nets
+        /// \return <tt>TRUE</tt>, if the cells take part in nets and join them
+        [[nodiscard]]
+        bool_t joins_nets() const;
+
+        /// \brief Returns the property cells of this part drive their electrical net with
+        /// \return ID of the property, or <tt>har::of::VOID</tt>, if the cells don't drive
+        [[nodiscard]]
+        of net_drive() const;
+
+        /// \brief Returns the property the voltage of the electrical net of a cell of this part is written to
+        /// \return ID of the property, or <tt>har::of::VOID</tt>, if the cells don't sense
+        [[nodiscard]]
+        of net_sense() const;
+
+        /// Slots are assigned to the entries of the property model in order of their addition
+        /// and are kept, even if the entry is removed afterwards.
+        /// Therefore, the slots of cells of this part stay valid, when the property model grows.
+        /// \brief Returns the property IDs in order of their slots
+        /// \return The slot layout of this part
+        [[nodiscard]]
+        const decltype(_layout) & layout() const;
+
+        /// \brief Returns the slot of a property in the layout of this part
+        /// \param [in] id ID of the property
+        /// \return The slot of the property, or <tt>har::part::NO_SLOT</tt>, if it has none
+        [[nodiscard]]
+        inline ushort_t slot_of(of id) const {
+            return uint_t(id) < _slots.size() ? _slots[id] : NO_SLOT;
+        }
+
         /// \brief Initializes a cell with standard values
         /// \param [out] cell The cell
         void init_standard(cell_base & base) const;
@@ -359,6 +478,20 @@ namespace har {
         /// \param [in,out] cl The cell
         void cycle(cell & cl) const;
 
+        ///  \brief Invokes the batch cycle delegate
+        /// \param [in,out] cells The cells
+        void cycle(cell_batch & cells) const;
+
+        ///  \brief Invokes the field kernel of a boolean field
+        /// \param [in] in Committed values of the field
+        /// \param [in,out] out Next values of the field
+        void cycle(const field<bool_t> & in, field<bool_t> & out) const;
+
+        ///  \brief Invokes the field kernel of a floating point field
+        /// \param [in] in Committed values of the field
+        /// \param [in,out] out Next values of the field
+        void cycle(const field<double_t> & in, field<double_t> & out) const;
+
         ///  \brief Invokes the move delegate
         /// \param [in,out] cl The cell
         void move(cell & cl) const;
@@ -0,0 +1,262 @@
+#pragma once
+
+#ifndef HAR_PART_TYPE_HPP
+#define HAR_PART_TYPE_HPP
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <har/cell.hpp>
+#include <har/cell_base.hpp>
+#include <har/cell_batch.hpp>
+#include <har/exception.hpp>
+#include <har/grid_cell.hpp>
+#include <har/part.hpp>
+#include <har/value.hpp>
+
+namespace har {
+
+    /// \brief Property of a statically typed part
+    /// \tparam Id ID of the property
+    /// \tparam T Type of the property's values
+    template<of Id, typename T>
+    struct static_slot {
+        static_assert(is_value_type<T>::value, "Statically typed properties must hold value types");
+        static_assert(uint_t(Id) < part::MAX_SLOTTED_ID, "Statically typed properties must be slotted");
+
+        static constexpr of id = Id; ///<ID of the property
+        using type = T; ///<Type of the property's values
+    };
+
+    /// \brief Cell of a statically typed part
+    ///
+    /// Reads and writes the properties of the part by their slots, which are known at compile time.
+    /// \tparam Slots The properties of the part, in the order of their slots
+    template<typename... Slots>
+    class typed_cell {
+    private:
+        cell & _cl; ///<The accessed cell
+
+        /// \brief Returns the slot of a property
+        template<typename S, std::size_t I = 0u, typename First, typename... Rest>
+        static constexpr ushort_t index_of() {
+            if constexpr (std::is_same_v<S, First>) {
+                return ushort_t(I);
+            } else {
+                static_assert(sizeof...(Rest) > 0u, "Property is not part of the typed cell");
+                return index_of<S, I + 1u, Rest...>();
+            }
+        }
+
+    public:
+        /// \brief Slot of a property in the layout of the part
+        /// \tparam S The property
+        template<typename S>
+        static constexpr ushort_t slot_of = index_of<S, 0u, Slots...>();
+
+        /// \brief Constructor
+        /// \param [in,out] cl Cell of the statically typed part
+        explicit typed_cell(cell & cl) : _cl(cl) {
+
+        }
+
+        typed_cell(const typed_cell & ref) = delete;
+
+        /// \brief Returns the underlying cell, e.g. to access neighbors or connected cells
+        /// \return The underlying cell
+        [[nodiscard]]
+        cell & get_cell() {
+            return _cl;
+        }
+
+        /// \brief Gets the committed value of a property
+        /// \tparam S The property
+        /// \return The committed value
+        template<typename S>
+        [[nodiscard]]
+        const typename S::type & get() const {
+            return har::get<typename S::type>(_cl._cell.front(slot_of<S>));
+        }
+
+        /// \brief Sets a value of a property intermediately
+        /// \tparam S The property
+        /// \param [in] val New value
+        template<typename S>
+        void set(const typename S::type & val) {
+            constexpr auto slot = slot_of<S>;
+            _cl._cell.back(slot) = val;
+            _cl._cell.mark_dirty(slot);
+            _cl.written(S::id);
+        }
+
+        /// \brief Sets a value of a property intermediately, if it differs from the committed value
+        /// \tparam S The property
+        /// \param [in] val New value
+        template<typename S>
+        void replace(const typename S::type & val) {
+            if (get<S>() != val) {
+                set<S>(val);
+            }
+        }
+
+        typed_cell & operator=(const typed_cell & ref) = delete;
+
+        /// \brief Default destructor
+        ~typed_cell() = default;
+    };
+
+    /// Derive a part type as in <tt>struct lamp : part_type<lamp, static_slot<of::VALUE, bool_t>></tt>
+    /// and define any of the static member functions
+    /// <tt>cycle(view &)</tt>, <tt>move(view &)</tt>, <tt>draw(view &, image_t &)</tt>,
+    /// <tt>press(view &, const ccoords_t &)</tt> and <tt>release(view &, const ccoords_t &)</tt>.
+    /// <tt>bind</tt> installs them as the delegates of a part, whose property model begins with the listed properties.
+    /// The automaton then cycles cells of the part without type erasure
+    /// and the delegates access the properties by slots that are known at compile time.
+    /// If cells are cycled in batches, runs of them are cycled in one loop,
+    /// or by <tt>cycle_batch(cell_batch &)</tt>, if defined.
+    /// \brief CRTP base for parts defined as C++ types
+    /// \tparam Derived The part type
+    /// \tparam Slots The properties accessed by the delegates, in the order of their slots
+    template<typename Derived, typename... Slots>
+    class part_type {
+    private:
+        template<typename D, typename = void>
+        struct has_cycle : std::false_type {
+        };
+
+        template<typename D>
+        struct has_cycle<D, std::void_t<decltype(D::cycle(std::declval<typed_cell<Slots...> &>()))>>
+                : std::true_type {
+        };
+
+        template<typename D, typename = void>
+        struct has_cycle_batch : std::false_type {
+        };
+
+        template<typename D>
+        struct has_cycle_batch<D, std::void_t<decltype(D::cycle_batch(std::declval<cell_batch &>()))>>
+                : std::true_type {
+        };
+
+        template<typename D, typename = void>
+        struct has_move : std::false_type {
+        };
+
+        template<typename D>
+        struct has_move<D, std::void_t<decltype(D::move(std::declval<typed_cell<Slots...> &>()))>>
+                : std::true_type {
+        };
+
+        template<typename D, typename = void>
+        struct has_draw : std::false_type {
+        };
+
+        template<typename D>
+        struct has_draw<D, std::void_t<decltype(D::draw(std::declval<typed_cell<Slots...> &>(),
+                                                        std::declval<image_t &>()))>> : std::true_type {
+        };
+
+        template<typename D, typename = void>
+        struct has_press : std::false_type {
+        };
+
+        template<typename D>
+        struct has_press<D, std::void_t<decltype(D::press(std::declval<typed_cell<Slots...> &>(),
+                                                          std::declval<const ccoords_t &>()))>> : std::true_type {
+        };
+
+        template<typename D, typename = void>
+        struct has_release : std::false_type {
+        };
+
+        template<typename D>
+        struct has_release<D, std::void_t<decltype(D::release(std::declval<typed_cell<Slots...> &>(),
+                                                              std::declval<const ccoords_t &>()))>>
+                : std::true_type {
+        };
+
+        /// \brief Cycles a grid cell of the part, called by the automaton without type erasure
+        static void cycle_static(context & ctx, grid_cell_base & gclb) {
+            grid_cell gcl{ ctx, gclb };
+            view cl{ gcl };
+            TRY_CATCH({
+                          Derived::cycle(cl);
+                      }, (std::exception & e), {
+                          raise(exception::delegate_error("har::part_type::cycle", e));
+                      })
+        }
+
+    public:
+        using view = typed_cell<Slots...>; ///<Cell of the part, as passed to the delegates
+
+        /// \brief Slot of a property in the layout of the part
+        /// \tparam S The property
+        template<typename S>
+        static constexpr ushort_t slot_of = view::template slot_of<S>;
+
+        /// \brief Installs the delegates of the part type into a part
+        ///
+        /// The entries of the listed properties have to be the first ones added to the part, in the listed order.
+        /// \param [in,out] pt The part
+        static void bind(part & pt) {
+            ushort_t slot = 0u;
+            bool_t valid = ((pt.slot_of(Slots::id) == slot++ &&
+                             pt.model().count(Slots::id) &&
+                             pt.model().at(Slots::id).type_and_default.typed_index() ==
+                             type_index<typename Slots::type>()) && ...);
+            if (!valid) {
+                raise(std::invalid_argument("har::part_type::bind: the property model of part " +
+                                            std::string(pt.unique_name().begin(), pt.unique_name().end()) +
+                                            " does not begin with the properties of the part type"));
+            }
+
+            if constexpr (has_cycle<Derived>::value) {
+                pt.delegates.cycle = [](cell & cl) {
+                    view tcl{ cl };
+                    Derived::cycle(tcl);
+                };
+                pt.delegates.cycle_static = &cycle_static;
+            }
+            if constexpr (has_cycle_batch<Derived>::value) {
+                pt.delegates.cycle_batch = [](cell_batch & cells) {
+                    Derived::cycle_batch(cells);
+                };
+            } else if constexpr (has_cycle<Derived>::value) {
+                pt.delegates.cycle_batch = [](cell_batch & cells) {
+                    cells.for_each([](cell & cl) {
+                        view tcl{ cl };
+                        Derived::cycle(tcl);
+                    });
+                };
+            }
+            if constexpr (has_move<Derived>::value) {
+                pt.delegates.move = [](cell & cl) {
+                    view tcl{ cl };
+                    Derived::move(tcl);
+                };
+            }
+            if constexpr (has_draw<Derived>::value) {
+                pt.delegates.draw = [](cell & cl, image_t & im) {
+                    view tcl{ cl };
+                    Derived::draw(tcl, im);
+                };
+            }
+            if constexpr (has_press<Derived>::value) {
+                pt.delegates.press = [](cell & cl, const ccoords_t & pos) {
+                    view tcl{ cl };
+                    Derived::press(tcl, pos);
+                };
+            }
+            if constexpr (has_release<Derived>::value) {
+                pt.delegates.release = [](cell & cl, const ccoords_t & pos) {
+                    view tcl{ cl };
+                    Derived::release(tcl, pos);
+                };
+            }
+        }
+    };
+}
+
+#endif //HAR_PART_TYPE_HPP
@@ -7,6 +7,12 @@
 #ifndef HAR_PARTICIPANT_HPP
 #define HAR_PARTICIPANT_HPP
 
+#include <filesystem>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
 #include <har/coords.hpp>
 #include <har/full_cell.hpp>
 #include <har/part.hpp>
@@ -31,12 +37,28 @@ namespace har {
         UI = 1
     };
 
+    /// \brief Formats a model can be stored in
+    enum class model_format : bool_t {
+        TEXT = false, ///<Human readable text format
+        BINARY = true ///<Compact binary format that is loaded in place
+    };
+
+    /// \brief Changes of a probed property that raise a trigger
+    enum class edge : ushort_t {
+        LEVEL_LOW, ///<Raised after every cycle the property is low
+        BOTH,      ///<Raised when the property goes from low to high or from high to low
+        FALL,      ///<Raised when the property goes from high to low
+        RISE       ///<Raised when the property goes from low to high
+    };
+
     ///Participants are used for interaction with HAR simulations.
     class participant {
     public:
         class context;
 
         using callback_t = std::function<void(participant::context &)>;
+        using update_t = std::tuple<cell_h, entry_h, value>; ///<Updated property of a selected cell
+        using redraw_t = std::pair<cell_h, image_t>; ///<Redrawn image of a cell
 
     private:
         inner_participant * _iparti; ///<Pointer to inner participant (if attached)
@@ -70,6 +92,64 @@ namespace har {
         /// All changes on the selected cell will be reported to the participant via callbacks
         void select(const cell_h & hnd);
 
+        /// \brief Restricts the cells of a grid drawn for this participant to a rectangle
+        ///
+        /// Drawing cells outside of the rectangle is deferred until they are displayed again
+        /// \param [in] grid Grid of the rectangle
+        /// \param [in] from Top left corner of the rectangle
+        /// \param [in] to Bottom right corner of the rectangle, exclusive
+        void set_viewport(grid_t grid, const dcoords_t & from, const dcoords_t & to);
+
+        /// \brief Lets every cell of a grid be drawn for this participant
+        ///
+        /// \param [in] grid Grid to draw entirely
+        void reset_viewport(grid_t grid);
+
+        /// \brief Sets whether anything is drawn for this participant, e.g. while its window is hidden
+        ///
+        /// \param [in] drawing <tt>FALSE</tt>, if drawing should be deferred entirely
+        void set_drawing(bool_t drawing);
+
+        /// \brief Sets whether the participant is called back at the beginning of every cycle
+        ///
+        /// \param [in] cycling <tt>TRUE</tt>, if <tt>on_cycle</tt> should be called every cycle
+        void set_cycling(bool_t cycling);
+
+        /// \brief Sets properties of grid cells to publish to the participant after every cycle
+        ///
+        /// Published properties can be read with <tt>read_probes</tt> without requesting the simulation.
+        /// \param [in] probes Grid cells and their numeric properties
+        void set_probes(const std::vector<std::pair<gcoords_t, entry_h>> & probes);
+
+        /// \brief Reads the probed properties as published after the last cycle
+        ///
+        /// Never waits for the simulation.
+        /// Properties that are not numeric or do not exist are read as <tt>NaN</tt>.
+        /// \param [out] values Target for the values, in the order of the probes
+        /// \return The number of cycles published so far, <tt>0</tt> if nothing was published yet
+        uint_t read_probes(span<double_t> values) const;
+
+        /// \brief Sets a trigger that is raised by changes of a property of a grid cell
+        ///
+        /// Changes are detected after every cycle, so a property changes at most once between two detections.
+        /// \param [in] num Number of the trigger
+        /// \param [in] target Grid cell and its numeric property
+        /// \param [in] kind Changes that raise the trigger
+        /// \param [in] threshold Value the property is high above
+        void set_trigger(uint_t num, const std::pair<gcoords_t, entry_h> & target, edge kind, double_t threshold);
+
+        /// \brief Removes a trigger
+        ///
+        /// \param [in] num Number of the trigger
+        void clear_trigger(uint_t num);
+
+        /// \brief Takes how often a trigger was raised since it was last taken
+        ///
+        /// Never waits for the simulation.
+        /// \param [in] num Number of the trigger
+        /// \return The number of times the trigger was raised
+        uint_t take_trigger(uint_t num);
+
         /// \brief Attempts to include a new part into the simulation
         ///
         /// \param [in] pt The part to include
@@ -90,6 +170,12 @@ namespace har {
         /// \param [in] is An input stream that supplies a serialized HAR model
         void load_model(istream & is);
 
+        /// \brief Loads a model from a file
+        ///
+        /// Models in the binary format are mapped into memory and loaded without copying the file.
+        /// \param [in] path Path of a file that contains a serialized HAR model in any format
+        void load_model(const std::filesystem::path & path);
+
         /// \brief Serializes the simulation's current model into a string
         ///
         /// \param [out] ser The target for the serialized model
@@ -100,6 +186,12 @@ namespace har {
         /// \param [out] os The target for the serialized model
         void store_model(ostream & os);
 
+        /// \brief Serializes the simulation's current model into an output stream
+        ///
+        /// \param [out] os The target for the serialized model, should be opened in binary mode
+        /// \param [in] format Format to serialize the model in
+        void store_model(ostream & os, model_format format);
+
         /// \brief Schedules a redraw of all cells in the current model
         void redraw_all();
 
@@ -144,6 +236,13 @@ namespace har {
         [[nodiscard]]
         virtual image_t get_image_base(const cell_h & hnd) = 0;
 
+        /// \brief Returns whether the participant wants cells drawn for it
+        ///
+        /// If no attached participant wants images, the automaton skips drawing entirely.
+        /// \return <tt>TRUE</tt> by default
+        [[nodiscard]]
+        virtual bool_t wants_images() const;
+
         /// \brief Processes an image painted by a parts <tt>draw</tt> delegate for display in the participant
         ///
         /// \param [in] hnd Handle of the cell
@@ -152,6 +251,24 @@ namespace har {
         /// \return The processed image
         virtual har::image_t process_image(har::cell_h hnd, har::image_t & img) = 0;
 
+        /// \brief Retrieves an image processed earlier for a cell that looked the same
+        ///
+        /// If an image is returned, the cell's <tt>draw</tt> delegate is not called.
+        /// May be called concurrently by the workers of the automaton.
+        /// \param [in] hnd Handle of the cell
+        /// \param [in] look How the cell looks, see <tt>har::cell_base::look</tt>
+        /// \return The processed image, if the participant kept one for <tt>look</tt>
+        [[nodiscard]]
+        virtual std::optional<image_t> find_image(const cell_h & hnd, const look_t & look);
+
+        /// \brief Offers a processed image to be reused for cells that look the same
+        ///
+        /// May be called concurrently by the workers of the automaton.
+        /// \param [in] hnd Handle of the cell
+        /// \param [in] look How the cell looks, see <tt>har::cell_base::look</tt>
+        /// \param [in] img The processed image
+        virtual void keep_image(const cell_h & hnd, const look_t & look, const image_t & img);
+
         /// \brief Retrieves the input stream of the participant
         ///
         /// \return Input stream of the participant
@@ -162,7 +279,7 @@ namespace har {
         /// \return Output stream of the participant
         virtual ostream & output() = 0;
 
-        /// \brief Called once every cycle
+        /// \brief Called at the beginning of every cycle, if the participant is cycling
         virtual void on_cycle(participant::context & ctx) = 0;
 
         /// \brief Called once, when the participant is added to the simulation
@@ -248,6 +365,18 @@ namespace har {
             on_redraw(hnd, std::forward<image_t>(img), true);
         }
 
+        /// \brief Called once per cycle with the updated properties of the selected cell
+        ///
+        /// Forwards every update to on_selection_update by default.
+        /// \param [in] batch Handles of the selected cell, IDs and new values of the properties
+        virtual void on_selection_update_batch(span<const update_t> batch);
+
+        /// \brief Called once per cycle with all cells redrawn in it
+        ///
+        /// Forwards every image to on_redraw by default. The images may be moved from.
+        /// \param [in] batch Handles of the cells and their images
+        virtual void on_redraw_batch(span<redraw_t> batch);
+
         /// \brief Called when a connection is added to a grid cell
         ///
         /// \param [in] from Position of the observing end of the connection
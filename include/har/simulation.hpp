@@ -8,6 +8,8 @@
 #define HAR_SIMULATION_HPP
 
 #include <deque>
+#include <istream>
+#include <ostream>
 
 #include <har/part.hpp>
 #include <har/participant.hpp>
@@ -57,6 +59,36 @@ namespace har {
 
         void commence();
 
+        /// \brief Sets whether only active cells are cycled
+        ///
+        /// In sparse mode, only cells that changed in the last cycle
+        /// or were woken by a change to one of their part's waking properties
+        /// in an adjacent or connected cell are cycled
+        /// \param [in] sparse <tt>TRUE</tt>, if only active cells should be cycled
+        void set_sparse(bool_t sparse);
+
+        /// \brief Sets whether runs of cells of the same part are cycled in batches
+        ///
+        /// Runs of adjacent cells of a part that defines <tt>har::part::part_delegates::cycle_batch</tt>
+        /// are handed to it in a single call, which pays off for large areas of the same part
+        /// \param [in] batched <tt>TRUE</tt>, if runs of cells should be cycled in batches
+        void set_batched(bool_t batched);
+
+        /// \brief Records the requests of all participants to a binary log
+        ///
+        /// Every property write and every added or removed connection is recorded
+        /// along with the cycle it was committed before.
+        /// \param [in] os Stream to record to, must outlive the simulation
+        void record(std::ostream & os);
+
+        /// \brief Replays the requests recorded by another simulation
+        ///
+        /// The recorded changes are applied before the cycle they were recorded for,
+        /// so the run can be reproduced without the participants that made the requests.
+        /// The same model has to be loaded for the replay to be meaningful.
+        /// \param [in] is Stream to replay from, must outlive the simulation
+        void replay(std::istream & is);
+
         ///
         /// \param fref
         /// \return
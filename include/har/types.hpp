@@ -71,6 +71,53 @@ namespace har {
             typename Alloc = std::allocator<Tp>>
     using set = std::unordered_set<Tp, Hash, Pred, Alloc>;
 
+    /// \brief Non-owning view of contiguous elements
+    /// \tparam Tp Type of the elements
+    template<typename Tp>
+    class span {
+    private:
+        Tp * _data;
+        std::size_t _size;
+
+    public:
+        using element_type = Tp;
+        using iterator = Tp *;
+
+        constexpr span() noexcept : _data(nullptr), _size(0u) { }
+
+        constexpr span(Tp * data, std::size_t size) noexcept : _data(data), _size(size) { }
+
+        template<typename Container>
+        constexpr span(Container & cont) noexcept : _data(cont.data()), _size(cont.size()) { } //NOLINT
+
+        [[nodiscard]]
+        constexpr Tp * data() const noexcept {
+            return _data;
+        }
+
+        [[nodiscard]]
+        constexpr std::size_t size() const noexcept {
+            return _size;
+        }
+
+        [[nodiscard]]
+        constexpr bool empty() const noexcept {
+            return _size == 0u;
+        }
+
+        constexpr Tp & operator[](std::size_t i) const noexcept {
+            return _data[i];
+        }
+
+        constexpr iterator begin() const noexcept {
+            return _data;
+        }
+
+        constexpr iterator end() const noexcept {
+            return _data + _size;
+        }
+    };
+
     typedef std::size_t participant_h; ///<Unique ID of a participant
 
     typedef std::basic_istream<char_t> istream;           ///<Input stream type
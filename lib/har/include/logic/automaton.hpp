@@ -7,17 +7,26 @@
 #ifndef HAR_AUTOMATON_HPP
 #define HAR_AUTOMATON_HPP
 
+#include <array>
 #include <atomic>
 #include <mutex>
 #include <thread>
+#include <tuple>
+#include <vector>
 
 #include <har/co_queue.hpp>
+#include <har/field.hpp>
 #include <har/participant.hpp>
 #include <har/types.hpp>
 
 #include "logic/barrier.hpp"
+#include "logic/carrier.hpp"
 #include "logic/context.hpp"
+#include "logic/journal.hpp"
+#include "logic/nets.hpp"
 #include "logic/process_tab.hpp"
+#include "logic/scheduler.hpp"
+#include "logic/viewport.hpp"
 #include "world/grid_cell_base.hpp"
 
 namespace har {
@@ -31,34 +40,93 @@ namespace har {
             STOP  ///<Automaton is stopped
         };
 
+        enum class schedule : bool_t {
+            DENSE = false, ///<Every cell is cycled
+            SPARSE = true  ///<Only cells active in the process tab are cycled
+        };
+
     private:
         class dispatcher;
 
         class worker {
         private:
             automaton & _auto; ///<Underlying automaton
-            std::mutex _workex; ///<Lock the worker thread waits on
             context _ctx; ///<The workers context
+            std::vector<gcoords_t> _woken; ///<Cells woken by the changes this worker committed
+            std::vector<std::vector<participant::update_t>> _updates; ///<Committed values of selected cells by recipient
+            std::vector<std::vector<participant::redraw_t>> _images; ///<Drawn images by recipient
+            std::vector<std::vector<cell_h>> _deferred; ///<Cells not drawn as they are not displayed by recipient
+            std::vector<grid_cell_base *> _chunk; ///<Cells of the current chunk, if cells are cycled in batches
 
             /// \brief Entry function for the worker threads
             void work();
 
-            /// \brief Begins the task assigned by the automaton
+            /// \brief Waits on the automaton's barrier for the next task to begin
             void begin();
 
             /// \brief Reports finishing the assigned task to the automaton
             void done();
 
-            /// \brief Cycles all grid cells in the grid without committing
-            void process_grid(grid & grid);
+            /// \brief Cycles a grid cell, without type erasure if its part is statically typed
+            void cycle(grid_cell_base & gclb);
+
+            /// \brief Cycles the chunks of grid cells the scheduler hands out without committing
+            void process_grids(world & world);
+
+            /// \brief Cycles the chunks of scheduled cells of the process tab the scheduler hands out without committing
+            void process_active();
+
+            /// \brief Cycles the runs of cells of the same part in the current chunk
+            ///
+            /// Runs of a part with a batch cycle delegate are cycled in one call.
+            void process_batches();
+
+            /// \brief Cycles the fields of all parts that have one on the model grid without committing
+            ///
+            /// In sparse mode, only fields with at least one active cell are cycled.
+            void cycle_fields();
 
-            /// \brief Moves all cargo cells (if applicable) without committing
-            void process_cargo(world & world);
+            /// \brief Cycles the field of a part on a grid without committing
+            ///
+            /// \tparam T Type of the field's values
+            /// \param [in] pt The part
+            /// \param [in,out] gd The grid
+            template<typename T>
+            void cycle_field(const part & pt, grid & gd);
+
+            /// \brief Cycles the cargo and moves it by the cells under it without committing
+            ///
+            /// Every worker takes part in all rounds of resolving overlaps.
+            void process_cargo();
 
             /// \brief Commits all changes to cells in the context and emit draw callbacks (if applicable)
             void request_commit_and_draw(context & ctx);
 
-            void cycle_commit_and_draw(context & ctx);
+            /// \brief Commits and draws the changes of all workers' contexts in parallel
+            void cycle_commit_and_draw();
+
+            /// \brief Merges the contexts of all workers into the automaton's self worker's context
+            ///
+            /// Every worker takes part in all rounds of the reduction.
+            void reduce();
+
+            /// \brief Commits a range of the gathered changed cells
+            ///
+            /// \param [in] first Index of the first cell
+            /// \param [in] last Index after the last cell
+            void commit(uint_t first, uint_t last);
+
+            /// \brief Draws a range of the gathered cells to redraw for every recipient
+            ///
+            /// \param [in] ctx Context to draw the cells in
+            /// \param [in] first Index of the first cell
+            /// \param [in] last Index after the last cell
+            void draw(context & ctx, uint_t first, uint_t last);
+
+            /// \brief Notes a changed cell and the cells its changes wake up
+            ///
+            /// \param [in] gclb Changed cell before committing
+            void wake_affected(const grid_cell_base & gclb);
 
             void wait_for_next_step();
 
@@ -68,7 +136,7 @@ namespace har {
                 REQUEST = true
             };
 
-            const ushort_t offset; ///<The serial number of the worker thread and it's offset for working on cells
+            const ushort_t offset; ///<The serial number of the worker thread
 
             std::thread _thread{ }; ///<The thread that an object of this class acts as closure for
             volatile bool_t _valid; ///<<tt>TRUE</tt>, if the thread should continue working
@@ -94,8 +162,16 @@ namespace har {
             /// \brief Resets the worker's context
             void clean(step_type type);
 
-            /// \brief Unblocks the worker thread to continue work
-            void unblock();
+            /// \brief Wakes the cells noted while committing in the process tab
+            void update_tab();
+
+            /// \brief Hands the updates and images of all workers to every recipient in one batch each
+            /// \return <tt>TRUE</tt>, if anything was handed over
+            bool_t deliver();
+
+            /// \brief Returns the worker's context
+            /// \return The worker's context
+            context & get_context();
 
             /// \brief Standard destructor
             ~worker();
@@ -113,18 +189,50 @@ namespace har {
         inner_simulation & _sim; ///<Associated simulation
 
         state _state; ///<State of the automaton
+        schedule _schedule; ///<How cells are selected for cycling
+        bool_t _batched; ///<Whether runs of cells of the same part are cycled in batches
         volatile substep _substep; ///<Current substep
+        uint_t _cycles; ///<Number of completed cycles
 
         const uint_t _threads; ///<Number of threads
         worker _self_worker; ///<First worker that works in the thread the automaton is called in
         std::unique_ptr<worker[]> _workers; ///<Contains additional worker threads and their data
 
-        barrier _barrier;
+        barrier _barrier; ///<Synchronizes the automaton's thread and all worker threads around every substep
+        scheduler _scheduler; ///<Hands out chunks of cells to cycle to the workers
+        scheduler _committer; ///<Hands out chunks of cells to commit and draw to the workers
+        scheduler _shipper; ///<Hands out chunks of cargo to move to the workers
+        carrier _carrier; ///<Moves the cargo of the model
+        std::array<std::atomic<bool_t>, 2> _reblocked; ///<Whether cargo got blocked, alternating by round
+        journal _journal; ///<Records or replays the requests of the participants
+        nets _nets; ///<Electrical nets of the cells joined by connections
+
+        /// \brief Field of a part on the model grid, kept between cycles
+        struct field_state {
+            std::vector<uint_t> cells; ///<Indices of the cells of the part
+            std::tuple<std::pair<field<bool_t>, field<bool_t>>,
+                       std::pair<field<double_t>, field<double_t>>> fields; ///<Committed and next values
+        };
+
+        map<part_h, field_state> _fields; ///<Fields by the part they are of
+        bool_t _fields_valid; ///<Whether the kept fields may still cover the cells of their parts
 
         std::mutex _autoex;
         std::mutex _cyclex;
 
         process_tab _tab;
+        std::vector<gcoords_t> _scheduled; ///<Cells to cycle in the current sparse cycle
+
+        std::vector<cell_h> _committing; ///<Deduplicated cells changed in the current batch
+        std::vector<cell_h> _drawing; ///<Deduplicated cells to redraw in the current batch
+        std::vector<participant *> _recipients; ///<Participants notified about the current batch
+        std::vector<inner_participant *> _irecipients; ///<Inner participants of the recipients
+        std::vector<viewport> _views; ///<Viewports of the recipients for the current batch
+        std::set<cell_h> _revealed; ///<Deferred cells that came into view for the current batch
+        std::vector<std::size_t> _painters; ///<Indices of recipients that want images drawn
+        map<cell_h, std::vector<std::size_t>> _selections; ///<Indices of recipients by the cell they selected
+        std::vector<cargo_h> _spawned_cargo; ///<Cargo added to the model in the current batch
+        std::vector<cargo_h> _destroyed_cargo; ///<Cargo removed from the model in the current batch
 
         co_queue<std::pair<participant_h, participant::callback_t>> _queue;
 
@@ -133,14 +241,47 @@ namespace har {
         /// \param step Step to execute
         inline void do_step(automaton::substep step);
 
+        /// \brief Unblocks all worker threads to begin the current substep
+        void unblock_workers();
+
         /// \brief Called by workers when their assigned task is finished
         void i_am_done();
 
         /// \brief Waits for all worker threads to finish their assigned tasks
         void wait_for_all();
 
+        /// \brief Waits for all worker threads to reach the same point within a substep
+        void sync();
+
+        /// \brief Adds spawned and removes destroyed cargo of a context to and from the model
+        ///
+        /// \param [in,out] ctx Context to take the cargo from
+        void ship(context & ctx);
+
+        /// \brief Gathers the changed cells and cells to redraw into one batch
+        ///
+        /// \param [in,out] ctx Context to gather the cells from
+        void gather(context & ctx);
+
+        /// \brief Notifies every recipient once about the current batch
+        ///
+        /// \param [in] ctx Context to take the messages from
+        void notify(const context & ctx);
+
         void inner_exec(std::pair<participant_h, participant::callback_t> & fun);
 
+        /// \brief Collects the cells to cycle from the process tab
+        void prepare_tab();
+
+        /// \brief Tires idle cells, wakes affected ones and applies the process tab
+        void settle_tab();
+
+        /// \brief Resolves the voltages of all electrical nets without committing
+        ///
+        /// The voltages are written in the context of the automaton's self worker before the cells are cycled,
+        /// so they are committed along with the changes of the cycle.
+        void resolve_nets();
+
     public:
         /// \brief Constructor
         ///
@@ -172,8 +313,70 @@ namespace har {
         /// \return Old state
         enum state set_state(participant_h id, enum state to);
 
+        /// \brief Returns how cells are selected for cycling
+        /// \return The automaton's schedule
+        schedule schedule();
+
+        /// \brief Sets how cells are selected for cycling
+        ///
+        /// \param [in] to New schedule
+        ///
+        /// \return Old schedule
+        enum schedule set_schedule(enum schedule to);
+
+        /// \brief Returns whether runs of cells of the same part are cycled in batches
+        /// \return <tt>TRUE</tt>, if the cells are cycled in batches
+        [[nodiscard]]
+        bool_t batched() const;
+
+        /// \brief Sets whether runs of cells of the same part are cycled in batches
+        ///
+        /// Every chunk the scheduler hands out is split into runs of adjacent cells of the same part,
+        /// each cycled in a single call if the part has a batch cycle delegate.
+        /// The cells keep their order, so cells of different parts aren't reordered
+        /// \param [in] to <tt>TRUE</tt>, if the cells should be cycled in batches
+        ///
+        /// \return Whether the cells were cycled in batches before
+        bool_t set_batched(bool_t to);
+
+        /// \brief Returns the number of completed cycles
+        /// \return The number of cycles since the automaton was created
+        [[nodiscard]]
+        uint_t cycles() const;
+
+        /// \brief Returns the journal recording or replaying the requests of the participants
+        /// \return The automaton's journal
+        journal & get_journal();
+
+        /// \brief Returns the electrical nets of the model
+        /// \return The automaton's nets
+        nets & get_nets();
+
+        /// \brief Makes the electrical nets be built anew before the next cycle
+        ///
+        /// Has to be called whenever the cells of the model are replaced or reallocated.
+        void invalidate_nets();
+
+        /// \brief Notifies participants about cargo removed from the model outside of a cycle with the next batch
+        ///
+        /// \param [in] num Handle of the removed cargo
+        void destroyed_cargo(cargo_h num);
+
+        /// \brief Makes the cells of every field be looked up anew before it is cycled next
+        ///
+        /// Has to be called whenever the cells of the model are replaced or reallocated.
+        void invalidate_fields();
+
         process_tab & get_tab();
 
+        /// \brief Returns the scheduler distributing cells among the workers
+        /// \return The automaton's scheduler
+        [[nodiscard]]
+        const scheduler & get_scheduler() const;
+
+        /// \brief Discards the process tab and wakes every cell in the model
+        void refill_tab();
+
         std::mutex & get_autoex();
 
         void resize_tab(const gcoords_t & from, const gcoords_t & to);
@@ -6,6 +6,7 @@
 #define HAR_BARRIER_HPP
 
 #include <atomic>
+#include <condition_variable>
 #include <cstddef>
 #include <mutex>
 
@@ -13,26 +14,49 @@
 
 namespace har {
 
+    /// \brief Reusable, sense-reversing barrier
+    ///
+    /// Threads arriving before the last one spin for a bounded number of iterations,
+    /// yield a few times and park on a condition variable afterwards.
+    /// The last thread to arrive flips the sense and thereby releases the phase.
     class barrier {
     private:
-        std::atomic<std::ptrdiff_t> _count;
-        const std::ptrdiff_t _expected;
+        static constexpr uint_t YIELDS = 16u; ///<Times to yield after spinning before parking
+
+        std::atomic<std::ptrdiff_t> _count; ///<Threads yet to arrive in the current phase
+        const std::ptrdiff_t _expected; ///<Threads taking part in every phase
+        std::atomic<bool_t> _sense; ///<Flips every time a phase completes
+        std::atomic<uint_t> _parked; ///<Threads currently parked on the condition variable
+        const uint_t _spin; ///<Iterations to spin before parking
 
         std::mutex _mutex;
+        std::condition_variable _cv;
 
-        [[nodiscard]]
-        bool_t finished() const;
+        /// \brief Waits for the sense to reach a value
+        ///
+        /// \param [in] sense Sense of the next phase
+        void wait_for(bool_t sense);
 
     public:
-        explicit barrier(std::ptrdiff_t expected);
-
-        void arrive(std::ptrdiff_t n = 1);
+        /// \brief Default number of spin iterations
+        ///
+        /// \return <tt>0</tt> on single core systems, a small bound otherwise
+        [[nodiscard]]
+        static uint_t default_spin();
 
-        void wait();
+        /// \brief Constructor
+        ///
+        /// \param [in] expected Threads taking part in every phase
+        /// \param [in] spin Iterations to spin before parking
+        explicit barrier(std::ptrdiff_t expected, uint_t spin = default_spin());
 
-        void arrive_and_wait(std::ptrdiff_t n);
+        /// \brief Arrives at the barrier and blocks until every participating thread arrived
+        void arrive_and_wait();
 
-        void reset();
+        /// \brief Returns the number of threads taking part in every phase
+        /// \return The number of threads taking part in every phase
+        [[nodiscard]]
+        std::ptrdiff_t expected() const;
 
         ~barrier() noexcept;
     };
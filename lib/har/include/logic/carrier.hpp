@@ -0,0 +1,115 @@
+#pragma once
+
+#ifndef HAR_CARRIER_HPP
+#define HAR_CARRIER_HPP
+
+#include <atomic>
+#include <limits>
+#include <vector>
+
+#include <har/coords.hpp>
+#include <har/types.hpp>
+
+#include "logic/context.hpp"
+#include "world/cargo_cell_base.hpp"
+#include "world/cargo_index.hpp"
+#include "world/world.hpp"
+
+namespace har {
+
+    /// \brief Moves the cargo of a world by the grid cells under it without letting cargo overlap
+    ///
+    /// Moving cargo is done in three phases:
+    /// <ol>
+    /// <li>Every cargo proposes its new position from its own movement and
+    /// the <tt>of::MOVED_*</tt> properties of the grid cell under it.</li>
+    /// <li>Cargo that would overlap other cargo is blocked in rounds until no more cargo gets blocked.
+    /// In each round, cargo only sees blocks of previous rounds, so the outcome does not depend on the workers.</li>
+    /// <li>The unblocked cargo is moved and the overlays of the grid cells are updated.</li>
+    /// </ol>
+    /// The first two phases can be run by several workers on disjoint ranges of cargo.
+    class carrier {
+    public:
+        static constexpr double_t MAX_STEP = 1.0; ///<Maximum distance cargo moves per axis in one cycle
+
+    private:
+        static constexpr uint_t FREE = std::numeric_limits<uint_t>::max(); ///<Round of unblocked cargo
+
+        /// \brief Movement of a single cargo in the current cycle
+        struct shipment {
+            cargo_cell_base * cargo; ///<Moved cargo
+            ccoords_t from; ///<Position before moving
+            ccoords_t to; ///<Proposed position
+            ccoords_t extent; ///<Half of the cargo's extent on each axis
+            std::atomic<uint_t> blocked; ///<Round the cargo got blocked in
+
+            explicit shipment(cargo_cell_base & cclb);
+
+            shipment(shipment && fref) noexcept;
+        };
+
+        std::vector<shipment> _shipments; ///<Movement of every cargo in the order of the cargo pool
+        cargo_index _index; ///<Index of the shipments by their original position
+        ccoords_t _reach; ///<Largest extent of any cargo plus the largest step
+        std::vector<cargo_h> _delivered; ///<Cargo that changed its position
+
+        /// \brief Returns whether cargo overlaps other cargo
+        [[nodiscard]]
+        static bool_t overlap(const ccoords_t & lhs, const ccoords_t & lext,
+                              const ccoords_t & rhs, const ccoords_t & rext);
+
+    public:
+        /// \brief Returns the half extent cargo has on the grid
+        ///
+        /// Cargo's corners are rounded by its radius, so it may come as close as its size minus its radius.
+        /// \param [in] cclb Cargo
+        /// \return The half extent on each axis
+        [[nodiscard]]
+        static ccoords_t extent_of(const cargo_cell_base & cclb);
+
+        /// \brief Constructor
+        carrier();
+
+        /// \brief Collects the cargo of a world for the next movement
+        ///
+        /// \param [in] world World to move the cargo of
+        void prepare(world & world);
+
+        /// \brief Returns the number of collected cargo
+        /// \return The number of shipments
+        [[nodiscard]]
+        uint_t size() const;
+
+        /// \brief Cycles a range of the cargo and proposes its new positions
+        ///
+        /// \param [in] ctx Context of the calling worker
+        /// \param [in] world World of the cargo
+        /// \param [in] first Index of the first shipment
+        /// \param [in] last Index after the last shipment
+        void propose(context & ctx, world & world, uint_t first, uint_t last);
+
+        /// \brief Blocks cargo in a range that would overlap other cargo
+        ///
+        /// \param [in] round Number of the round, starting at 1
+        /// \param [in] first Index of the first shipment
+        /// \param [in] last Index after the last shipment
+        /// \return <tt>TRUE</tt>, if any cargo got blocked
+        bool_t resolve(uint_t round, uint_t first, uint_t last);
+
+        /// \brief Moves all unblocked cargo and clears the shipments
+        ///
+        /// \param [in] world World of the cargo
+        /// \param [in] ctx Context to note the cargo to redraw in
+        void settle(world & world, context & ctx);
+
+        /// \brief Returns the cargo that changed its position since last cleared
+        /// \return The handles of the moved cargo
+        decltype(_delivered) & delivered();
+
+        /// \brief Standard destructor
+        ~carrier();
+    };
+
+}
+
+#endif //HAR_CARRIER_HPP
@@ -9,6 +9,7 @@
 
 #include <deque>
 #include <queue>
+#include <vector>
 
 #include <har/property.hpp>
 #include <har/value.hpp>
@@ -27,7 +28,7 @@ namespace har {
         std::set<cell_h> _redraw;
         std::deque<unresolved_connection> _connected;
         std::deque<unresolved_connection> _disconnected;
-        std::deque<cargo_cell_base *> _spawned;
+        std::vector<cargo_h> _spawned; ///<Cargo reserved in the model, but not added yet
         std::set<cargo_h> _moved;
         std::set<cargo_h> _destroyed;
         std::deque<std::array<string_t, 2>> _messages;
@@ -93,7 +94,12 @@ namespace har {
 
         void disconnect(unresolved_connection && conn);
 
-        cargo_cell_base & spawn(cargo_cell_base && cell);
+        /// \brief Reserves new cargo in the model to be added when the changes are committed
+        ///
+        /// \param [in] pt Part of the cargo
+        /// \param [in] pos Position of the cargo on the model grid
+        /// \return The reserved cargo
+        cargo_cell_base & spawn(const part & pt, const ccoords_t & pos);
 
         void move(cargo_h num);
 
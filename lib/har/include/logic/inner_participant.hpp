@@ -9,13 +9,15 @@
 
 #include <deque>
 #include <mutex>
-
+#include <set>
 
 #include <har/participant.hpp>
 #include <har/full_cell.hpp>
 
 #include "logic/automaton.hpp"
 #include "logic/context.hpp"
+#include "logic/probe.hpp"
+#include "logic/viewport.hpp"
 #include "world/cargo_cell_base.hpp"
 #include "world/grid_cell_base.hpp"
 #include "world/model.hpp"
@@ -57,8 +59,20 @@ namespace har {
 
         cell_h _selected;
 
+        std::mutex _viewex; ///<Guards the viewport and the deferred cells
+        viewport _viewport; ///<Part of the simulation the participant displays
+        std::set<cell_h> _deferred; ///<Cells that changed their looks while not being displayed
+        std::atomic<bool_t> _revealed; ///<<tt>TRUE</tt>, if the viewport grew since the last batch
+
+        probe _probe; ///<Properties published to the participant after every cycle
+
         asymmetric_lock _alock;
 
+        /// \brief Draws deferred cells that came into view while the automaton is stopped
+        ///
+        /// A running automaton draws them with its next batch instead.
+        void draw_revealed();
+
     public:
         explicit inner_participant(participant_h id, inner_simulation & simulation);
 
@@ -84,6 +98,39 @@ namespace har {
 
         bool_t do_draw(bool_t draw);
 
+        /// \brief Restricts the displayed area of a grid
+        ///
+        /// If the automaton is stopped, revealed cells are drawn right away.
+        /// \param [in] grid Grid of the area
+        /// \param [in] from Top left corner of the area
+        /// \param [in] to Bottom right corner of the area, exclusive
+        void set_viewport(grid_t grid, const dcoords_t & from, const dcoords_t & to);
+
+        /// \brief Displays a grid entirely
+        ///
+        /// \param [in] grid Grid to display
+        void reset_viewport(grid_t grid);
+
+        /// \brief Returns a copy of the participant's viewport
+        /// \return The participant's viewport
+        [[nodiscard]]
+        viewport get_viewport();
+
+        /// \brief Notes cells whose drawing was deferred
+        ///
+        /// \param [in] cells Handles of the cells
+        void defer(const std::vector<cell_h> & cells);
+
+        /// \brief Takes the deferred cells that are displayed by now
+        ///
+        /// \param [out] into Set to insert the cells into
+        void reveal(std::set<cell_h> & into);
+
+        /// \brief Returns the properties published to the participant after every cycle
+        /// \return The participant's probe
+        [[nodiscard]]
+        probe & get_probe();
+
         [[nodiscard]]
         bool_t has_request() const;
 
@@ -115,10 +162,14 @@ namespace har {
 
         void load_model(istream & is);
 
+        void load_model(const std::filesystem::path & path);
+
         void store_model(string_t & ser);
 
         void store_model(ostream & os);
 
+        void store_model(ostream & os, model_format format);
+
         void resize_grid(const gcoords_t & to);
 
         void redraw_all();
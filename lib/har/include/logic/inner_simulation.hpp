@@ -58,6 +58,9 @@ namespace har {
 
         std::function<void()> _exit_fun;
 
+        /// \brief Replaces the current model with a loaded one and notifies all participants
+        void adopt_model(model && loaded);
+
     public:
         inner_simulation(int argc, char * argv[], char * envp[]);
 
@@ -105,8 +108,12 @@ namespace har {
 
         void load_model(context & ctx, istream & is);
 
+        void load_model(context & ctx, const std::filesystem::path & path);
+
         void store_model(ostream & os);
 
+        void store_model(ostream & os, model_format format);
+
         void send_message(const string_t & header, const string_t & content);
 
         void commence();
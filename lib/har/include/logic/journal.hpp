@@ -0,0 +1,136 @@
+#pragma once
+
+#ifndef HAR_JOURNAL_HPP
+#define HAR_JOURNAL_HPP
+
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <string>
+
+#include <har/coords.hpp>
+#include <har/types.hpp>
+#include <har/value.hpp>
+
+#include "logic/context.hpp"
+#include "world/world.hpp"
+
+namespace har {
+
+    /// \brief Records the requests of participants to a binary log and replays them
+    ///
+    /// The log starts with the magic bytes <tt>HARJ</tt> and the format version.
+    /// It then holds one frame for every committed request that changed anything,
+    /// consisting of the number of the cycle the request was committed before,
+    /// the number of records and the records themselves.
+    /// A record is either a property write, an added or a removed connection.
+    /// All numbers are stored in the byte order of the recording machine.
+    ///
+    /// Replaying applies all records of a cycle before the cycle,
+    /// in the order they were recorded in, so no participant has to be attached.
+    /// Spawned and destroyed cargo and properties of types without a value representation are not recorded.
+    class journal {
+    public:
+        static constexpr std::array<char, 4> MAGIC{ 'H', 'A', 'R', 'J' }; ///<Magic bytes of a log
+        static constexpr std::uint16_t VERSION = 1u; ///<Current version of the format
+
+        /// \brief Kinds of records
+        enum class change : std::uint8_t {
+            PROPERTY = 0u,  ///<A property of a cell was written
+            CONNECT = 1u,   ///<A connection was added to a grid cell
+            DISCONNECT = 2u ///<A connection was removed from a grid cell
+        };
+
+    private:
+        static constexpr uint_t NEVER = std::numeric_limits<uint_t>::max(); ///<Cycle after the last frame
+
+        std::ostream * _out; ///<Stream to record to
+        std::istream * _in; ///<Stream to replay from
+        std::string _frame; ///<Records of the frame being recorded
+        std::uint32_t _records; ///<Number of records in the frame being recorded
+        uint_t _next; ///<Cycle of the next frame to replay
+
+        /// \brief Appends a number to the frame being recorded
+        template<typename T>
+        void put(T num) {
+            _frame.append(reinterpret_cast<const char *>(&num), sizeof(T));
+        }
+
+        /// \brief Reads a number from the replayed stream
+        template<typename T>
+        T take() {
+            T num{ };
+            _in->read(reinterpret_cast<char *>(&num), sizeof(T));
+            return num;
+        }
+
+        /// \brief Appends a handle of a cell to the frame being recorded
+        void put_cell(const cell_h & hnd);
+
+        /// \brief Reads a handle of a cell from the replayed stream
+        cell_h take_cell();
+
+        /// \brief Appends a value to the frame being recorded
+        /// \return <tt>TRUE</tt>, if the value could be represented
+        bool_t put_value(const value & val);
+
+        /// \brief Reads a value from the replayed stream
+        value take_value();
+
+        /// \brief Reads the cycle of the next frame, if any
+        void advance();
+
+        /// \brief Returns whether a handle addresses an existing cell of a world
+        [[nodiscard]]
+        static bool_t exists(const world & world, const cell_h & hnd);
+
+    public:
+        /// \brief Constructor
+        journal();
+
+        /// \brief Starts recording to a stream
+        ///
+        /// Writes the header of the log.
+        /// \param [in] os Stream to record to, must outlive the recording
+        void record(std::ostream & os);
+
+        /// \brief Starts replaying from a stream
+        ///
+        /// Reads the header of the log.
+        /// \param [in] is Stream to replay from, must outlive the replay
+        void replay(std::istream & is);
+
+        /// \brief Returns whether requests are recorded
+        /// \return <tt>TRUE</tt>, if a stream to record to is set
+        [[nodiscard]]
+        bool_t recording() const;
+
+        /// \brief Returns whether recorded requests remain to be replayed
+        /// \return <tt>TRUE</tt>, if a stream to replay from is set and not exhausted
+        [[nodiscard]]
+        bool_t replaying() const;
+
+        /// \brief Records the changes of a request before they get committed
+        ///
+        /// \param [in] cycle Number of the cycle the request is committed before
+        /// \param [in] ctx Context of the request
+        /// \param [in] world World the request changed
+        void write(uint_t cycle, const context & ctx, const world & world);
+
+        /// \brief Applies the recorded changes of a cycle to a context
+        ///
+        /// \param [in] cycle Number of the cycle to be cycled next
+        /// \param [in,out] ctx Context to apply the changes in
+        /// \param [in,out] world World to apply the changes to
+        /// \return <tt>TRUE</tt>, if any changes were applied
+        bool_t apply(uint_t cycle, context & ctx, world & world);
+
+        /// \brief Standard destructor
+        ~journal();
+    };
+
+}
+
+#endif //HAR_JOURNAL_HPP
@@ -0,0 +1,143 @@
+#pragma once
+
+#ifndef HAR_NETS_HPP
+#define HAR_NETS_HPP
+
+#include <vector>
+
+#include <har/types.hpp>
+
+#include "logic/context.hpp"
+#include "world/grid_cell_base.hpp"
+#include "world/world.hpp"
+
+namespace har {
+
+    /// \brief Groups grid cells joined by connections into electrical nets and resolves their voltages
+    ///
+    /// The nets are kept in a union-find structure over the connected cells of a world.
+    /// Only connections between cells of joining parts join them, see <tt>har::part::set_net</tt>.
+    /// Cells of parts that take part in nets without joining them are endpoints,
+    /// which sense the highest voltage among the nets they are connected to.
+    /// Added connections join nets right away. Removed connections and rewired cells mark their nets,
+    /// which are partitioned anew from the current connections of their members before they are resolved next.
+    /// Once per cycle, every net resolves the voltage its members drive and writes it to all members that sense it,
+    /// so a voltage reaches every cell of a net within one cycle, regardless of how the cells are wired.
+    class nets {
+    private:
+        map<grid_cell_base *, grid_cell_base *> _parent; ///<Parent of every member, roots are their own parent
+        map<grid_cell_base *, std::vector<grid_cell_base *>> _members; ///<Members of every net by its root
+        set<grid_cell_base *> _dirty; ///<Cells whose nets have to be partitioned anew
+        std::vector<grid_cell_base *> _floating; ///<Former members that are no longer in any net
+        set<grid_cell_base *> _endpoints; ///<Cells that sense a net without joining it
+        bool_t _valid; ///<Whether the nets match the connections of the world
+
+        /// \brief Returns the root of a member's net, making a new net of a cell that isn't a member
+        ///
+        /// \param [in] gclb Cell
+        /// \return Root of the cell's net
+        grid_cell_base * root_of(grid_cell_base * gclb);
+
+        /// \brief Joins the nets of two cells
+        ///
+        /// \param [in] a First cell
+        /// \param [in] b Second cell
+        void join(grid_cell_base * a, grid_cell_base * b);
+
+        /// \brief Returns whether a connection between two cells joins their nets
+        ///
+        /// \param [in] from First cell
+        /// \param [in] to Second cell
+        /// \return <tt>TRUE</tt>, if the parts of both cells join nets
+        [[nodiscard]]
+        static bool_t conducts(const grid_cell_base & from, const grid_cell_base & to);
+
+        /// \brief Joins the net of a cell with the nets of all cells it shares a conducting connection with
+        ///
+        /// \param [in] gclb Cell
+        void join_connected(grid_cell_base & gclb);
+
+        /// \brief Adds a cell to the endpoints, if its part senses nets without joining them, or removes it
+        ///
+        /// \param [in] gclb Cell
+        void enlist(grid_cell_base & gclb);
+
+        /// \brief Returns the voltage an endpoint senses
+        ///
+        /// \param [in] gclb Endpoint
+        /// \param [in] voltages Resolved voltages of the nets by their roots
+        /// \return The highest voltage among the nets of the connected cells of joining parts,
+        /// or NaN, if none of them is driven
+        double_t sensed_by(const grid_cell_base & gclb, map<grid_cell_base *, double_t> & voltages);
+
+        /// \brief Returns the voltage a cell drives its net with
+        ///
+        /// \param [in] gclb Cell
+        /// \return The voltage, or NaN, if the cell doesn't drive
+        [[nodiscard]]
+        static double_t drive_of(const grid_cell_base & gclb);
+
+        /// \brief Partitions the nets of the dirty cells anew
+        void partition();
+
+        /// \brief Writes a voltage to a cell, if it senses its net and its voltage differs
+        ///
+        /// \param [in,out] ctx Context to write the voltage in
+        /// \param [in] gclb Cell
+        /// \param [in] voltage Voltage of the cell's net
+        static void sense(context & ctx, grid_cell_base & gclb, double_t voltage);
+
+    public:
+        /// \brief Constructor
+        nets();
+
+        /// \brief Makes the nets be built anew from all connections of the world before they are resolved next
+        void invalidate();
+
+        /// \brief Joins the nets of two cells a connection was added between
+        ///
+        /// \param [in] from Cell the connection was added to
+        /// \param [in] to Connected cell
+        void connect(grid_cell_base & from, grid_cell_base & to);
+
+        /// \brief Marks the net of two cells a connection was removed between
+        ///
+        /// \param [in] from Cell the connection was removed from
+        /// \param [in] to Formerly connected cell
+        void disconnect(grid_cell_base & from, grid_cell_base & to);
+
+        /// \brief Marks the net of a changed cell, if it may have been rewired
+        ///
+        /// \param [in] gclb Changed cell
+        void touch(grid_cell_base & gclb);
+
+        /// \brief Brings the nets up to date with the connections of a world
+        ///
+        /// \param [in] world World the nets span
+        void settle(world & world);
+
+        /// \brief Resolves the voltage of every net and writes it to the members that sense it
+        ///
+        /// Cells that were left outside of any net since the last resolution and unconnected endpoints are written NaN.
+        /// \param [in,out] ctx Context to write the voltages in
+        void resolve(context & ctx);
+
+        /// \brief Returns the number of nets
+        /// \return The number of nets
+        [[nodiscard]]
+        std::size_t size() const;
+
+        /// \brief Returns whether two cells are in the same net
+        ///
+        /// \param [in] a First cell
+        /// \param [in] b Second cell
+        /// \return <tt>TRUE</tt>, if both cells are members of the same net
+        [[nodiscard]]
+        bool_t joined(grid_cell_base & a, grid_cell_base & b);
+
+        /// \brief Default destructor
+        ~nets() = default;
+    };
+}
+
+#endif //HAR_NETS_HPP
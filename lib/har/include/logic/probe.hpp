@@ -0,0 +1,128 @@
+#pragma once
+
+#ifndef HAR_PROBE_HPP
+#define HAR_PROBE_HPP
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <har/coords.hpp>
+#include <har/participant.hpp>
+#include <har/types.hpp>
+#include <har/value.hpp>
+
+#include "world/world.hpp"
+
+namespace har {
+
+    /// \brief Properties of grid cells a participant reads without requesting the simulation
+    ///
+    /// The automaton publishes the values of the probed properties after every cycle, guarded by a sequence number.
+    /// Readers copy the values and retry, if a publication happened meanwhile, so they never block the automaton.
+    /// Buffers of previous targets are kept until the probe is destroyed, so readers never touch freed memory.
+    /// Each buffer stores its own length and is published as one pointer, so readers never read past its end.
+    ///
+    /// On publishing, the probe also detects changes of the properties of its triggers
+    /// and counts how often each trigger was raised until the participant takes it.
+    class probe {
+    public:
+        using target_t = std::pair<gcoords_t, entry_h>; ///<Probed property of a grid cell
+
+        static constexpr uint_t MAX_TRIGGERS = 16u; ///<Number of triggers per probe
+
+    private:
+        /// \brief Property of a grid cell whose changes are counted
+        struct trigger {
+            target_t target; ///<Watched property
+            edge kind; ///<Changes that raise the trigger
+            double_t threshold; ///<Value the property is high above
+            bool_t armed; ///<Whether the trigger is set
+            bool_t primed; ///<Whether the property was read before
+            bool_t high; ///<Whether the property was high when last read
+            std::atomic<uint_t> raised; ///<Number of times raised since last taken
+        };
+
+        /// \brief Values of one set of targets
+        struct buffer {
+            uint_t size; ///<Number of values
+            std::unique_ptr<std::atomic<double_t>[]> values; ///<Values in the order of the targets
+
+            /// \brief Constructor
+            /// \param [in] size Number of values
+            explicit buffer(uint_t size);
+        };
+
+        std::mutex _probex; ///<Guards the targets and the buffers
+        std::vector<target_t> _targets; ///<Probed properties
+        std::vector<std::unique_ptr<buffer>> _buffers; ///<Current buffer at the back, retired before
+        std::atomic<uint_t> _sequence; ///<Twice the number of publications, odd while publishing
+        std::atomic<const buffer *> _published; ///<Buffer of the published values
+        std::array<trigger, MAX_TRIGGERS> _triggers; ///<Triggers, guarded by the mutex except for their counts
+
+        /// \brief Returns a trigger by its number
+        /// \throws std::out_of_range if the number is too large
+        [[nodiscard]]
+        trigger & trigger_at(uint_t num);
+
+        /// \brief Detects changes of the properties of all armed triggers
+        void detect(const world & world);
+
+        /// \brief Returns the value of a probed property as a number
+        [[nodiscard]]
+        static double_t value_of(const world & world, const target_t & target);
+
+    public:
+        /// \brief Constructor
+        probe();
+
+        /// \brief Sets the probed properties
+        ///
+        /// Takes effect with the next publication.
+        /// \param [in] targets Grid cells and their properties
+        void set_targets(const std::vector<target_t> & targets);
+
+        /// \brief Publishes the current values of the probed properties
+        ///
+        /// Must only be called by one thread at a time that may read the world.
+        /// \param [in] world World to read the properties from
+        void publish(const world & world);
+
+        /// \brief Copies the values of the last publication
+        ///
+        /// Properties that are not numeric or do not exist are read as <tt>NaN</tt>,
+        /// as are values that were not published.
+        /// \param [out] values Values in the order of the targets
+        /// \return The number of publications so far, <tt>0</tt> if nothing was published yet
+        uint_t read(span<double_t> values) const;
+
+        /// \brief Sets a trigger
+        ///
+        /// \param [in] num Number of the trigger
+        /// \param [in] target Watched property
+        /// \param [in] kind Changes that raise the trigger
+        /// \param [in] threshold Value the property is high above
+        void set_trigger(uint_t num, const target_t & target, edge kind, double_t threshold);
+
+        /// \brief Removes a trigger and discards its count
+        ///
+        /// \param [in] num Number of the trigger
+        void clear_trigger(uint_t num);
+
+        /// \brief Takes how often a trigger was raised since it was last taken
+        ///
+        /// May be called concurrently to publishing.
+        /// \param [in] num Number of the trigger
+        /// \return The number of times raised
+        uint_t take_trigger(uint_t num);
+
+        /// \brief Standard destructor
+        ~probe();
+    };
+
+}
+
+#endif //HAR_PROBE_HPP
@@ -73,6 +73,16 @@ namespace har {
         /// \param [in] pos Handle of the cell
         void remove(const gcoords_t & pos);
 
+        /// \brief Removes all cells from the process tab
+        void clear();
+
+        /// \brief Refers the tabs on cells of a grid to the grid's current cells
+        ///
+        /// Reshaping a grid moves its cells, so the references have to be renewed afterwards.
+        /// \param [in] grid Grid whose cells moved
+        /// \param [in] at Returns the cell at a position
+        void rebind(grid_t grid, const std::function<cell_base &(const gcoords_t &)> & at);
+
         /// \brief Returns the number of tabs on cells
         ///
         /// \return The number of tabs on cells
@@ -0,0 +1,114 @@
+#pragma once
+
+#ifndef HAR_SCHEDULER_HPP
+#define HAR_SCHEDULER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include <har/types.hpp>
+
+namespace har {
+
+    /// \brief Distributes contiguous chunks of cells among workers and lets idle workers steal chunks
+    class scheduler {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        /// \brief Statistics of a single worker
+        struct worker_stats {
+        public:
+            uint_t chunks_done; ///<Chunks the worker has processed
+            uint_t chunks_stolen; ///<Chunks the worker has taken from other workers
+            std::chrono::nanoseconds idle; ///<Time the worker waited for others to finish
+        };
+
+        static constexpr uint_t CHUNK_SIZE = 64u; ///<Maximum number of cells in a chunk
+        static constexpr uint_t CHUNKS_PER_WORKER = 4u; ///<Minimum number of chunks per worker, if enough cells
+
+    private:
+        /// \brief Chunks assigned to a single worker
+        ///
+        /// The range of chunk indices is packed into one word, the worker pops from the front, thieves from the back.
+        struct alignas(64) queue {
+        public:
+            std::atomic<std::uint64_t> range; ///<Lower half is the first, upper half one after the last chunk
+            clock::time_point finished; ///<Point of time the worker ran out of chunks
+            worker_stats stats; ///<Statistics of the worker
+        };
+
+        const ushort_t _workers; ///<Number of workers
+        std::unique_ptr<queue[]> _queues; ///<Chunks for every worker
+        uint_t _size; ///<Number of cells to process
+        uint_t _chunk; ///<Number of cells in a chunk
+
+        static inline std::uint64_t pack(std::uint32_t first, std::uint32_t last) {
+            return std::uint64_t(first) | (std::uint64_t(last) << 32u);
+        }
+
+        /// \brief Takes a chunk from the front of a worker's own queue
+        bool_t pop(ushort_t worker, uint_t & chunk);
+
+        /// \brief Takes a chunk from the back of another worker's queue
+        bool_t steal(ushort_t worker, uint_t & chunk);
+
+    public:
+        /// \brief Constructor
+        ///
+        /// \param [in] workers Number of workers, including the automaton's own thread
+        explicit scheduler(ushort_t workers);
+
+        /// \brief Splits cells into chunks and assigns them to the workers
+        ///
+        /// Must not be called while workers process chunks.
+        /// \param [in] size Number of cells to process
+        void distribute(uint_t size);
+
+        /// \brief Processes chunks until none are left
+        ///
+        /// \param [in] worker Serial number of the calling worker
+        /// \param [in] fun Function to process the cells with indices in <tt>[first, last)</tt>
+        template<typename F>
+        void run(ushort_t worker, F && fun) {
+            auto & q = _queues[worker];
+            uint_t chunk;
+            while (pop(worker, chunk)) {
+                fun(chunk * _chunk, std::min((chunk + 1u) * _chunk, _size));
+                ++q.stats.chunks_done;
+            }
+            while (steal(worker, chunk)) {
+                fun(chunk * _chunk, std::min((chunk + 1u) * _chunk, _size));
+                ++q.stats.chunks_done;
+                ++q.stats.chunks_stolen;
+            }
+            q.finished = clock::now();
+        }
+
+        /// \brief Accounts the time every worker waited after running out of chunks
+        ///
+        /// Must be called after all workers finished.
+        void settle();
+
+        /// \brief Returns the statistics of a worker
+        ///
+        /// \param [in] worker Serial number of the worker
+        /// \return The worker's statistics
+        [[nodiscard]]
+        const worker_stats & stats_of(ushort_t worker) const;
+
+        /// \brief Returns the number of workers
+        /// \return The number of workers
+        [[nodiscard]]
+        ushort_t workers() const;
+
+        /// \brief Sets the statistics of all workers back to zero
+        void reset_stats();
+
+        ~scheduler();
+    };
+
+}
+
+#endif //HAR_SCHEDULER_HPP
@@ -0,0 +1,40 @@
+#pragma once
+
+#ifndef HAR_VIEWPORT_HPP
+#define HAR_VIEWPORT_HPP
+
+#include <array>
+#include <optional>
+#include <utility>
+
+#include <har/coords.hpp>
+#include <har/types.hpp>
+
+namespace har {
+
+    /// \brief Part of a simulation a participant displays
+    struct viewport {
+    public:
+        using area_t = std::optional<std::pair<dcoords_t, dcoords_t>>;
+
+        bool_t drawing; ///<<tt>FALSE</tt>, if the participant displays nothing at the moment
+        std::array<area_t, 2> areas; ///<Displayed areas of the model and the bank grid, unbounded if empty
+
+        /// \brief Returns the area of a grid
+        ///
+        /// \param [in] grid Grid of the area
+        /// \return The area of the grid
+        [[nodiscard]]
+        area_t & area(grid_t grid);
+
+        /// \brief Returns whether a cell is displayed
+        ///
+        /// \param [in] hnd Handle of the cell
+        /// \return <tt>TRUE</tt>, if the cell is displayed
+        [[nodiscard]]
+        bool_t contains(const cell_h & hnd) const;
+    };
+
+}
+
+#endif //HAR_VIEWPORT_HPP
@@ -20,6 +20,10 @@ namespace har {
 
     class grid_cell_base;
 
+    class cargo_pool;
+
+    class world;
+
     class cargo_cell_base : public cell_base {
     private:
         cargo_h _id;
@@ -60,6 +64,15 @@ namespace har {
         [[nodiscard]]
         ccoords_t move_delta() const;
 
+        /// \brief Returns the movement requested for this cycle and discards it
+        /// \return The requested movement
+        ccoords_t take_move_delta();
+
+        /// \brief Returns the grid cells the cargo overlays
+        /// \return The overlaid cells by position
+        [[nodiscard]]
+        const decltype(_overlays) & overlays() const;
+
         void move_by(ccoords_t delta);
 
         void move_by(dcoords_t delta);
@@ -70,6 +83,10 @@ namespace har {
 
         ~cargo_cell_base();
 
+        friend class cargo_pool;
+
+        friend class world;
+
         friend ostream & operator<<(ostream & os, const cargo_cell_base & ref);
 
         friend std::tuple<istream &, const std::map<part_h, part> &>
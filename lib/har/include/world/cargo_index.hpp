@@ -0,0 +1,80 @@
+#pragma once
+
+#ifndef HAR_CARGO_INDEX_HPP
+#define HAR_CARGO_INDEX_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+#include <har/coords.hpp>
+#include <har/types.hpp>
+
+namespace har {
+
+    /// \brief Uniform grid over the model grid to find cargo near a position
+    ///
+    /// Every cell of the model grid is one bucket of the index.
+    /// The buckets are stored contiguously, so a lookup only touches the buckets around the position.
+    class cargo_index {
+    private:
+        dcoords_t _dim; ///<Dimension of the indexed grid
+        std::vector<uint_t> _starts; ///<Index of the first entry of every bucket, one past the last bucket at the end
+        std::vector<uint_t> _entries; ///<Indexed items ordered by bucket
+
+        /// \brief Returns the bucket a position falls in
+        [[nodiscard]]
+        uint_t bucket_of(const ccoords_t & pos) const;
+
+    public:
+        /// \brief Constructor
+        cargo_index();
+
+        /// \brief Indexes a number of items by their position
+        ///
+        /// Positions outside the grid are indexed in the closest bucket.
+        /// \param [in] dim Dimension of the indexed grid
+        /// \param [in] size Number of items
+        /// \param [in] position_of Returns the position of the nth item
+        void rebuild(const dcoords_t & dim, uint_t size, const std::function<ccoords_t(uint_t)> & position_of);
+
+        /// \brief Returns the number of indexed items
+        /// \return The number of indexed items
+        [[nodiscard]]
+        uint_t size() const;
+
+        /// \brief Calls a function for every item in the buckets within reach of a position
+        ///
+        /// May include items further away than the reach, but never misses an item within it.
+        /// \tparam F Type of the function
+        /// \param [in] center Position to search around
+        /// \param [in] reach Distance on each axis to search within
+        /// \param [in] fun Function taking the number of the item
+        template<typename F>
+        void for_each_near(const ccoords_t & center, const ccoords_t & reach, F && fun) const {
+            if (_entries.empty()) {
+                return;
+            }
+            auto lo = [](double_t v, int_t dim) {
+                return int_t(std::clamp(std::floor(v), 0., double_t(dim - 1)));
+            };
+            int_t x0 = lo((center.x - reach.x).v, _dim.x.v);
+            int_t x1 = lo((center.x + reach.x).v, _dim.x.v);
+            int_t y0 = lo((center.y - reach.y).v, _dim.y.v);
+            int_t y1 = lo((center.y + reach.y).v, _dim.y.v);
+            for (int_t y = y0; y <= y1; ++y) {
+                auto row = uint_t(y * _dim.x.v);
+                for (uint_t i = _starts[row + x0], end = _starts[row + x1 + 1]; i < end; ++i) {
+                    fun(_entries[i]);
+                }
+            }
+        }
+
+        /// \brief Standard destructor
+        ~cargo_index();
+    };
+
+}
+
+#endif //HAR_CARGO_INDEX_HPP
@@ -0,0 +1,234 @@
+#pragma once
+
+#ifndef HAR_CARGO_POOL_HPP
+#define HAR_CARGO_POOL_HPP
+
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include <har/coords.hpp>
+#include <har/types.hpp>
+
+#include "world/cargo_cell_base.hpp"
+
+namespace har {
+
+    /// \brief Slab of cargo cells addressed by generation-tagged handles
+    ///
+    /// Cargo is stored in blocks of slots that are never moved, so references to cargo stay valid until it is released.
+    /// A handle holds the index of the slot and the generation of the slot,
+    /// which changes every time the slot is released, so handles of released cargo are never valid again.
+    /// Released slots are reused before new ones are created, so spawning does not allocate once the pool is warm.
+    ///
+    /// Cargo is reserved first, which may be done by several threads at once, and is admitted afterwards.
+    /// Only admitted cargo is found and iterated, densely in the order of its admission.
+    class cargo_pool {
+    public:
+        static constexpr uint_t SLOT_BITS = 20u; ///<Bits of a handle used for the slot index
+        static constexpr uint_t GENERATION_BITS = 12u; ///<Bits of a handle used for the generation
+        static constexpr uint_t BLOCK_SIZE = 256u; ///<Slots per block
+        static constexpr uint_t MAX_SLOTS = 1u << SLOT_BITS; ///<Maximum number of cargo
+
+    private:
+        static constexpr uint_t NONE = std::numeric_limits<uint_t>::max();
+
+        enum class slot_state : ushort_t {
+            FREE,     ///<Slot holds no cargo
+            RESERVED, ///<Slot holds cargo not admitted yet
+            ADMITTED  ///<Slot holds admitted cargo
+        };
+
+        struct slot {
+            std::aligned_storage_t<sizeof(cargo_cell_base), alignof(cargo_cell_base)> storage;
+            uint_t generation; ///<Current generation of the slot
+            uint_t dense; ///<Index in the dense array, if admitted
+            slot_state state;
+
+            inline cargo_cell_base & cargo() {
+                return *std::launder(reinterpret_cast<cargo_cell_base *>(&storage));
+            }
+        };
+
+        std::unique_ptr<std::unique_ptr<slot[]>[]> _blocks; ///<Blocks of slots, allocated on demand
+        std::atomic<uint_t> _slots; ///<Number of slots in allocated blocks, published after their block
+        std::vector<uint_t> _free; ///<Released slots to reuse
+        std::vector<uint_t> _dense; ///<Slots of admitted cargo
+        std::mutex _poolex; ///<Guards reserving slots
+
+        /// \brief Returns a slot by its index
+        [[nodiscard]]
+        inline slot & slot_at(uint_t index) const {
+            return _blocks[index / BLOCK_SIZE][index % BLOCK_SIZE];
+        }
+
+        /// \brief Returns the slot a handle refers to, if it holds cargo of the handle's generation
+        [[nodiscard]]
+        slot * lookup(cargo_h num) const;
+
+        /// \brief Takes a free slot for new cargo and assigns its handle
+        /// \return Index of the slot
+        uint_t take();
+
+        /// \brief Destroys all cargo and releases all slots
+        void destroy();
+
+    public:
+        template<bool_t C>
+        class basic_iterator {
+        private:
+            using pool_t = std::conditional_t<C, const cargo_pool, cargo_pool>;
+
+            pool_t * _pool;
+            std::vector<uint_t>::const_iterator _it;
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = cargo_cell_base;
+            using difference_type = std::ptrdiff_t;
+            using pointer = std::conditional_t<C, const cargo_cell_base *, cargo_cell_base *>;
+            using reference = std::conditional_t<C, const cargo_cell_base &, cargo_cell_base &>;
+
+            basic_iterator(pool_t & pool, std::vector<uint_t>::const_iterator it) : _pool(&pool), _it(it) { }
+
+            reference operator*() const {
+                return _pool->slot_at(*_it).cargo();
+            }
+
+            pointer operator->() const {
+                return &operator*();
+            }
+
+            basic_iterator & operator++() {
+                ++_it;
+                return *this;
+            }
+
+            bool_t operator==(const basic_iterator & rhs) const {
+                return _it == rhs._it;
+            }
+
+            bool_t operator!=(const basic_iterator & rhs) const {
+                return _it != rhs._it;
+            }
+        };
+
+        using iterator = basic_iterator<false>;
+        using const_iterator = basic_iterator<true>;
+
+        /// \brief Creates a handle from a slot index and a generation
+        [[nodiscard]]
+        static constexpr cargo_h handle_of(uint_t index, uint_t generation) {
+            return cargo_h(index | (generation << SLOT_BITS));
+        }
+
+        /// \brief Returns the slot index of a handle
+        [[nodiscard]]
+        static constexpr uint_t index_of(cargo_h num) {
+            return uint_t(num) & (MAX_SLOTS - 1u);
+        }
+
+        /// \brief Returns the generation of a handle
+        [[nodiscard]]
+        static constexpr uint_t generation_of(cargo_h num) {
+            return (uint_t(num) >> SLOT_BITS) & ((1u << GENERATION_BITS) - 1u);
+        }
+
+        /// \brief Constructor
+        cargo_pool();
+
+        cargo_pool(const cargo_pool &) = delete;
+
+        /// \brief Move constructor
+        cargo_pool(cargo_pool && fref) noexcept;
+
+        /// \brief Reserves a slot and constructs new cargo in it
+        ///
+        /// May be called by several threads at once.
+        /// \param [in] pt Part of the cargo
+        /// \param [in] pos Position of the cargo
+        /// \return The reserved cargo with its handle assigned
+        cargo_cell_base & reserve(const part & pt, const ccoords_t & pos);
+
+        /// \brief Reserves a slot and moves existing cargo into it
+        ///
+        /// May be called by several threads at once.
+        /// \param [in] cclb Cargo to move into the pool
+        /// \return The reserved cargo with its handle assigned
+        cargo_cell_base & reserve(cargo_cell_base && cclb);
+
+        /// \brief Admits reserved cargo
+        ///
+        /// \param [in] num Handle of reserved cargo
+        /// \return The admitted cargo
+        cargo_cell_base & admit(cargo_h num);
+
+        /// \brief Destroys reserved or admitted cargo and releases its slot
+        ///
+        /// \param [in] num Handle of the cargo
+        /// \return <tt>TRUE</tt>, if there was cargo with the handle
+        bool_t release(cargo_h num);
+
+        /// \brief Returns admitted cargo
+        ///
+        /// \param [in] num Handle of the cargo
+        /// \return Pointer to the cargo or <tt>nullptr</tt>, if there is no admitted cargo with the handle
+        [[nodiscard]]
+        cargo_cell_base * find(cargo_h num) const;
+
+        /// \brief Returns admitted or reserved cargo
+        ///
+        /// \param [in] num Handle of the cargo
+        /// \return The cargo
+        /// \throws std::out_of_range if there is no cargo with the handle
+        [[nodiscard]]
+        cargo_cell_base & at(cargo_h num) const;
+
+        /// \brief Returns the number of admitted cargo with a handle
+        [[nodiscard]]
+        uint_t count(cargo_h num) const;
+
+        /// \brief Returns the number of admitted cargo
+        [[nodiscard]]
+        uint_t size() const;
+
+        [[nodiscard]]
+        bool_t empty() const;
+
+        /// \brief Returns the admitted cargo at an index of the dense iteration order
+        [[nodiscard]]
+        cargo_cell_base & nth(uint_t index) const;
+
+        /// \brief Returns the number of slots created so far
+        [[nodiscard]]
+        uint_t capacity() const;
+
+        /// \brief Destroys all cargo, but keeps the slots for reuse
+        void clear();
+
+        iterator begin();
+
+        [[nodiscard]]
+        const_iterator begin() const;
+
+        iterator end();
+
+        [[nodiscard]]
+        const_iterator end() const;
+
+        cargo_pool & operator=(const cargo_pool &) = delete;
+
+        /// \brief Move assignment
+        cargo_pool & operator=(cargo_pool && fref) noexcept;
+
+        /// \brief Destructor
+        ~cargo_pool();
+    };
+
+}
+
+#endif //HAR_CARGO_POOL_HPP
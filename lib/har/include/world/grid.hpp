@@ -7,6 +7,8 @@
 #ifndef HAR_GRID_HPP
 #define HAR_GRID_HPP
 
+#include <vector>
+
 #include <har/coords.hpp>
 
 #include "world/grid_cell_base.hpp"
@@ -17,10 +19,30 @@ namespace har {
         grid_t _cat;
         dcoords_t _size;
         string_t _title;
-        map<dcoords_t, grid_cell_base> _data;
+        std::vector<std::pair<const dcoords_t, grid_cell_base>> _data; ///<Cells in row-major order
 
         grid_cell_base create_cell(const part &, const dcoord_t & x, const dcoord_t & y);
 
+        /// \brief Returns the index of a position in the row-major storage
+        /// \param [in] pos Position in the grid
+        /// \return Index of the position's slot
+        [[nodiscard]]
+        inline uint_t slot(const dcoords_t & pos) const {
+            return uint_t(pos.y * _size.x + pos.x);
+        }
+
+        /// \brief Rebuilds the storage in a new dimension
+        ///
+        /// \param [in] pt Part of newly created cells
+        /// \param [in] to New dimension of the grid
+        /// \param [in] source Maps each new position to the position it is moved from.
+        ///                    Positions outside of the current dimension are newly created
+        template<typename F>
+        void reshape(const part & pt, const dcoords_t & to, F && source);
+
+        /// \brief Sets the neighbors of all cells according to their slot
+        void link();
+
     public:
         grid();
 
@@ -39,6 +61,18 @@ namespace har {
         [[nodiscard]]
         const grid_cell_base & at(const dcoords_t & pos) const;
 
+        /// \brief Returns the n-th cell in row-major order
+        /// \param [in] n Index of the cell
+        /// \return The n-th cell
+        [[nodiscard]]
+        grid_cell_base & nth(uint_t n);
+
+        /// \brief Returns the n-th cell in row-major order
+        /// \param [in] n Index of the cell
+        /// \return The n-th cell
+        [[nodiscard]]
+        const grid_cell_base & nth(uint_t n) const;
+
         [[nodiscard]]
         dcoords_t dim() const;
 
@@ -157,11 +157,11 @@ namespace har {
 
         void remove_connection(direction_t use);
 
-        void add_cargo(cargo_h num, artifact && arti);
+        artifact & add_cargo(cargo_h num, artifact && arti);
 
         artifact remove_cargo(cargo_h num);
 
-        void add_artifact(artifact_h num, artifact && arti);
+        artifact & add_artifact(artifact_h num, artifact && arti);
 
         artifact remove_artifact(artifact_h num);
 
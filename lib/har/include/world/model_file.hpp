@@ -0,0 +1,191 @@
+#pragma once
+
+#ifndef HAR_MODEL_FILE_HPP
+#define HAR_MODEL_FILE_HPP
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <vector>
+
+#include <har/part.hpp>
+#include <har/types.hpp>
+
+#include "world/model.hpp"
+
+namespace har {
+
+    /// \brief Binary format of models
+    ///
+    /// A stored model consists of a header and five dense arrays, each aligned to eight bytes:
+    /// <ol>
+    /// <li>the part table, naming every part used in the model once,</li>
+    /// <li>the grid cells that are not empty, referring to their part, property slots and connections,</li>
+    /// <li>the cargo cells, referring to their part and property slots,</li>
+    /// <li>the property slots of all cells, holding scalar values inline,</li>
+    /// <li>the connections of all grid cells.</li>
+    /// </ol>
+    /// Texts and other values that don't fit into a slot are stored in a trailing blob.
+    /// All numbers are stored in the byte order of the storing machine.
+    ///
+    /// The format holds the same information as the text format, property by property,
+    /// so models convert between both formats without losses.
+    /// Loading reads the arrays in place, so a memory mapped file is loaded without copying it first.
+    class model_file {
+    public:
+        static constexpr std::array<char, 4> MAGIC{ '\x89', 'H', 'A', 'M' }; ///<Magic bytes of a stored model
+        static constexpr std::uint16_t VERSION = 1u; ///<Current version of the format
+        static constexpr std::uint16_t ORDER = 0x0102u; ///<Reads as stored on machines with the same byte order
+
+        /// \brief Bytes of a file, mapped into memory where supported
+        class mapping {
+        private:
+            const char * _data; ///<Begin of the bytes
+            std::size_t _size; ///<Number of bytes
+            std::vector<char> _buffer; ///<Bytes read from the file, if it could not be mapped
+            bool_t _mapped; ///<Whether the bytes are mapped
+
+        public:
+            /// \brief Maps a file into memory
+            ///
+            /// Reads the file instead, if it cannot be mapped.
+            /// \param [in] path Path of the file
+            explicit mapping(const std::filesystem::path & path);
+
+            mapping(const mapping & ref) = delete;
+
+            /// \brief Returns the bytes of the file
+            /// \return The bytes of the file, empty if the file could not be read
+            [[nodiscard]]
+            span<const char> bytes() const;
+
+            mapping & operator=(const mapping & ref) = delete;
+
+            /// \brief Unmaps the file
+            ~mapping();
+        };
+
+    private:
+        /// \brief Reference to a text in the blob
+        struct text_ref {
+            std::uint32_t offset; ///<Offset in the blob
+            std::uint32_t size; ///<Number of characters
+        };
+
+        /// \brief Header of a stored model
+        struct header {
+            std::array<char, 4> magic; ///<Magic bytes
+            std::uint16_t version; ///<Version of the format
+            std::uint16_t order; ///<Byte order marker
+            std::uint32_t parts; ///<Number of entries in the part table
+            std::uint32_t cells; ///<Number of grid cells
+            std::uint32_t cargo; ///<Number of cargo cells
+            std::uint32_t slots; ///<Number of property slots
+            std::uint32_t wires; ///<Number of connections
+            std::uint32_t reserved; ///<Unused
+            std::uint64_t blob; ///<Size of the blob in bytes
+            text_ref title; ///<Title of the model
+            text_ref author; ///<Author of the model
+            text_ref description; ///<Description of the model
+            text_ref model_title; ///<Title of the model grid
+            text_ref bank_title; ///<Title of the bank grid
+            std::int32_t model_x; ///<Width of the model grid
+            std::int32_t model_y; ///<Height of the model grid
+            std::int32_t bank_x; ///<Width of the bank grid
+            std::int32_t bank_y; ///<Height of the bank grid
+            std::uint8_t editable; ///<Whether the model is editable
+            std::array<std::uint8_t, 7> padding; ///<Unused
+        };
+
+        /// \brief Entry of the part table
+        struct part_record {
+            std::uint64_t id; ///<ID of the part
+            text_ref name; ///<Unique name of the part
+        };
+
+        /// \brief Grid cell that is not empty
+        struct cell_record {
+            std::int32_t grid; ///<Grid of the cell
+            std::int32_t x; ///<Column of the cell
+            std::int32_t y; ///<Row of the cell
+            std::uint32_t part; ///<Index of the part in the part table
+            std::uint32_t first_slot; ///<Index of the first property slot
+            std::uint32_t slots; ///<Number of property slots
+            std::uint32_t first_wire; ///<Index of the first connection
+            std::uint32_t wires; ///<Number of connections
+        };
+
+        /// \brief Cargo cell
+        struct cargo_record {
+            double_t x; ///<Horizontal position of the cargo
+            double_t y; ///<Vertical position of the cargo
+            std::uint32_t part; ///<Index of the part in the part table
+            std::uint32_t first_slot; ///<Index of the first property slot
+            std::uint32_t slots; ///<Number of property slots
+            std::uint32_t reserved; ///<Unused
+        };
+
+        /// \brief Serialized property of a cell
+        struct slot {
+            std::uint64_t id; ///<ID of the property
+            std::uint32_t type; ///<Datatype of the value, or <tt>TEXT</tt>
+            std::uint32_t size; ///<Number of characters or bytes in the blob
+            std::uint64_t data; ///<Scalar value or offset in the blob
+        };
+
+        /// \brief Connection of a grid cell
+        struct wire {
+            std::int64_t use; ///<Pin the connection uses
+            std::int32_t grid; ///<Grid of the connected cell
+            std::int32_t x; ///<Column of the connected cell
+            std::int32_t y; ///<Row of the connected cell
+            std::int32_t reserved; ///<Unused
+        };
+
+        static_assert(sizeof(header) % 8u == 0u && sizeof(part_record) % 8u == 0u &&
+                      sizeof(cell_record) % 8u == 0u && sizeof(cargo_record) % 8u == 0u &&
+                      sizeof(slot) % 8u == 0u && sizeof(wire) % 8u == 0u,
+                      "Records of a stored model must keep the arrays aligned");
+
+        static constexpr std::uint32_t TEXT = 0xffu; ///<Type of slots holding the text representation of a value
+
+        /// \brief Appends the serialized properties of a cell to the slots and the blob
+        static std::uint32_t store_slots(const cell_base & clb, std::vector<slot> & slots, std::vector<char> & blob);
+
+        /// \brief Loads the properties of a cell from its slots
+        static bool_t load_slots(cell_base & clb, span<const slot> slots, span<const char> blob);
+
+    public:
+        /// \brief Returns whether bytes start with a model in the binary format
+        /// \param [in] bytes Bytes to check
+        /// \return <tt>TRUE</tt>, if the bytes start with the magic bytes
+        [[nodiscard]]
+        static bool_t is_binary(span<const char> bytes);
+
+        /// \brief Returns whether a stream supplies a model in the binary format
+        ///
+        /// Only peeks at the stream.
+        /// \param [in] is Stream to check
+        /// \return <tt>TRUE</tt>, if the next character is the first magic byte
+        [[nodiscard]]
+        static bool_t is_binary(istream & is);
+
+        /// \brief Stores a model in the binary format
+        ///
+        /// \param [out] os Stream to store to
+        /// \param [in] model Model to store
+        static void store(ostream & os, const model & model);
+
+        /// \brief Loads a model stored in the binary format
+        ///
+        /// \param [in] bytes Stored model, must be aligned to eight bytes
+        /// \param [out] model Model to load into
+        /// \param [in] inv Parts of the simulation
+        /// \return <tt>TRUE</tt>, if the model was loaded
+        static bool_t load(span<const char> bytes, model & model, const std::map<part_h, part> & inv);
+    };
+
+}
+
+#endif //HAR_MODEL_FILE_HPP
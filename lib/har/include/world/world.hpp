@@ -7,6 +7,7 @@
 #ifndef HAR_WORLD_HPP
 #define HAR_WORLD_HPP
 
+#include "world/cargo_pool.hpp"
 #include "world/grid.hpp"
 #include "world/grid_cell_base.hpp"
 
@@ -34,7 +35,13 @@ namespace har {
         grid _model;
         grid _bank;
 
-        map<cargo_h, cargo_cell_base> _cargo;
+        cargo_pool _cargo; ///<Cargo on the model grid
+
+        /// \brief Registers cargo in the overlays of the grid cells it covers
+        void place(cargo_cell_base & cclb);
+
+        /// \brief Removes cargo from the overlays of the grid cells it covers
+        void lift(cargo_cell_base & cclb);
 
     public:
         world();
@@ -69,13 +76,62 @@ namespace har {
 
         const cargo_cell_base & at(cargo_h num) const;
 
+        /// \brief Reserves new cargo without adding it to the model grid yet
+        ///
+        /// May be called by several threads at once.
+        /// \param [in] pt Part of the cargo
+        /// \param [in] pos Position of the cargo on the model grid
+        /// \return The reserved cargo
+        cargo_cell_base & reserve_cargo(const part & pt, const ccoords_t & pos);
+
+        /// \brief Adds reserved cargo to the model grid
+        ///
+        /// \param [in] num Handle of the reserved cargo
+        /// \return The added cargo
+        cargo_cell_base & add_cargo(cargo_h num);
+
+        /// \brief Adds new cargo to the model grid
+        ///
+        /// \param [in] pt Part of the cargo
+        /// \param [in] pos Position of the cargo on the model grid
+        /// \return The added cargo
+        cargo_cell_base & add_cargo(const part & pt, const ccoords_t & pos);
+
+        /// \brief Adds cargo to the model grid under a new handle
+        ///
+        /// Model files hold no handles, so loaded cargo is numbered in the order it is read.
+        /// \param [in] cclb Cargo to add
+        /// \return The added cargo
+        cargo_cell_base & add_cargo(cargo_cell_base && cclb);
+
+        /// \brief Moves cargo to a new position on the model grid and updates the overlays of the covered cells
+        ///
+        /// The position is clamped to the bounds of the model grid.
+        /// \param [in,out] cclb Cargo to move
+        /// \param [in] to New position
+        /// \return <tt>TRUE</tt>, if the cargo changed its position
+        bool_t move_cargo(cargo_cell_base & cclb, const ccoords_t & to);
+
+        /// \brief Removes added or reserved cargo from the model grid
+        ///
+        /// \param [in] num Handle of the cargo
+        /// \return <tt>TRUE</tt>, if there was cargo with the handle
+        bool_t remove_cargo(cargo_h num);
+
         cell_base & at(const cell_h & hnd);
 
         const cell_base & at(const cell_h & hnd) const;
 
-        void resize(grid_t grid, const part & pt, const dcoords_t & to);
+        /// \brief Resizes a grid
+        ///
+        /// Cargo left outside of a shrunk model grid is removed.
+        /// \param [in] grid Grid to resize
+        /// \param [in] pt Part of new cells
+        /// \param [in] to New dimension of the grid
+        /// \return Handles of the removed cargo
+        std::vector<cargo_h> resize(grid_t grid, const part & pt, const dcoords_t & to);
 
-        void resize(grid_t grid, const part & pt, dcoords_t && to);
+        std::vector<cargo_h> resize(grid_t grid, const part & pt, dcoords_t && to);
 
         void minimize(grid_t grid);
 
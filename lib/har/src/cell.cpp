@@ -32,6 +32,10 @@ const part & cell::logic() {
     return _cell.logic();
 }
 
+std::optional<look_t> cell::look() const {
+    return _cell.look(is_placed());
+}
+
 cell_cat cell::cat() const {
     return _cat;
 }
@@ -85,6 +89,22 @@ void cell::message(const string_t & header, const string_t & content) {
     }
 }
 
+void cell::written(of id) {
+    if (_cat == cell_cat::GRID_CELL && &_ctx != &context::invalid()) {
+        _ctx.change(static_cast<grid_cell_base &>(_cell).position());
+    } else {
+        _ctx.change(static_cast<cargo_cell_base &>(_cell).id());
+    }
+    auto & visual = _cell.logic().visual();
+    if (visual.find(id) != visual.end()) {
+        if (_cat == cell_cat::GRID_CELL && &_ctx != &context::invalid()) {
+            _ctx.draw(static_cast<grid_cell_base &>(_cell).position());
+        } else {
+            _ctx.draw(static_cast<cargo_cell_base &>(_cell).id());
+        }
+    }
+}
+
 void cell::redraw() {
     if (is_placed()) {
         switch (_cat) {
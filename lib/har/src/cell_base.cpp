@@ -2,6 +2,9 @@
 // Created by Johannes on 09.06.2020.
 //
 
+#include <algorithm>
+#include <cmath>
+
 #include <har/cell_base.hpp>
 
 using namespace har;
@@ -23,6 +26,37 @@ exception::cell_format_error::~cell_format_error() noexcept = default;
 
 //endregion
 
+//region look_t
+
+bool_t look_t::operator==(const look_t & rhs) const {
+    if (part != rhs.part || placed != rhs.placed || hash != rhs.hash || visuals.size() != rhs.visuals.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < visuals.size(); ++i) {
+        auto & lhv = visuals[i];
+        auto & rhv = rhs.visuals[i];
+        if (lhv.type() != rhv.type()) {
+            return false;
+        }
+        if (lhv.type() == value::datatype::DOUBLE) {
+            auto l = har::get<double_t>(lhv);
+            auto r = har::get<double_t>(rhv);
+            if (l != r && !(std::isnan(l) && std::isnan(r))) {
+                return false;
+            }
+        } else if (lhv != rhv) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool_t look_t::operator!=(const look_t & rhs) const {
+    return !operator==(rhs);
+}
+
+//endregion
+
 //region cell_base
 
 cell_base & cell_base::invalid() {
@@ -31,99 +65,284 @@ cell_base & cell_base::invalid() {
 }
 
 cell_base::cell_base(const part & pt) : _logic(pt),
-                                        _properties(),
-                                        _intermediate() {
+                                        _buffers(),
+                                        _front(),
+                                        _dirty(),
+                                        _loose(),
+                                        _iloose() {
+    fit();
     _logic.get().init_standard(*this);
     transit();
 
 }
 
 cell_base::cell_base(const cell_base & ref) : _logic(ref._logic),
-                                              _properties(ref._properties),
-                                              _intermediate(ref._intermediate) {
+                                              _buffers(ref._buffers),
+                                              _front(ref._front),
+                                              _dirty(ref._dirty),
+                                              _loose(ref._loose),
+                                              _iloose(ref._iloose) {
 
 }
 
 cell_base::cell_base(cell_base && fref) noexcept: _logic(fref._logic),
-                                                  _properties(std::forward<Map>(fref._properties)),
-                                                  _intermediate(std::forward<Map>(fref._intermediate)) {
+                                                  _buffers(std::move(fref._buffers)),
+                                                  _front(std::move(fref._front)),
+                                                  _dirty(std::move(fref._dirty)),
+                                                  _loose(std::move(fref._loose)),
+                                                  _iloose(std::move(fref._iloose)) {
+
+}
+
+void cell_base::fit() {
+    auto size = _logic.get().layout().size();
+    if (_buffers[0].size() < size) {
+        _buffers[0].resize(size);
+        _buffers[1].resize(size);
+        _front.resize((size + 63u) / 64u, 0u);
+        _dirty.resize((size + 63u) / 64u, 0u);
+    }
+}
 
+void cell_base::reslot(const part & pt) {
+    Map props = properties();
+    Map inter = intermediate();
+    _logic = pt;
+    _buffers[0].clear();
+    _buffers[1].clear();
+    _front.clear();
+    _dirty.clear();
+    _loose.clear();
+    _iloose.clear();
+    fit();
+    for (auto &[id, val] : props) {
+        if (auto slot = pt.slot_of(id); slot != part::NO_SLOT) {
+            _buffers[0][slot] = std::move(val);
+        } else {
+            _loose.insert_or_assign(id, std::move(val));
+        }
+    }
+    for (auto &[id, val] : inter) {
+        set(id, std::move(val));
+    }
+}
+
+void cell_base::raise_missing(of id) {
+    raise(std::out_of_range("cell has no property with ID " + std::to_string(id)));
+}
+
+const std::vector<of> & cell_base::layout() const {
+    return _logic.get().layout();
 }
 
 const part & cell_base::logic() const {
     return _logic;
 }
 
-const cell_base::Map & cell_base::properties() const {
-    return _properties;
+std::optional<look_t> cell_base::look(bool_t placed) const {
+    if (!logic().shares_images()) {
+        return std::nullopt;
+    }
+    auto combine = [](std::size_t & seed, std::size_t h) {
+        seed ^= h + 0x9e3779b97f4a7c15u + (seed << 6u) + (seed >> 2u);
+    };
+    std::size_t seed = std::hash<part_h>()(logic().id());
+    combine(seed, std::size_t(placed));
+    std::vector<value> visuals{ };
+    visuals.reserve(logic().visual().size());
+    for (auto id : logic().visual()) {
+        auto & val = get(id);
+        std::size_t h;
+        switch (val.type()) {
+            case value::datatype::VOID: {
+                h = 0u;
+                break;
+            }
+            case value::datatype::BOOLEAN: {
+                h = std::size_t(har::get<bool_t>(val));
+                break;
+            }
+            case value::datatype::INTEGER: {
+                h = std::hash<int_t>()(har::get<int_t>(val));
+                break;
+            }
+            case value::datatype::UNSIGNED: {
+                h = std::hash<uint_t>()(har::get<uint_t>(val));
+                break;
+            }
+            case value::datatype::DOUBLE: {
+                auto d = har::get<double_t>(val);
+                h = std::isnan(d) ? ~std::size_t(0u) : std::hash<double_t>()(d);
+                break;
+            }
+            case value::datatype::STRING: {
+                h = std::hash<string_t>()(har::get<string_t>(val));
+                break;
+            }
+            case value::datatype::C_COORDINATES: {
+                h = std::hash<ccoords_t>()(har::get<ccoords_t>(val));
+                break;
+            }
+            case value::datatype::D_COORDINATES: {
+                h = std::hash<dcoords_t>()(har::get<dcoords_t>(val));
+                break;
+            }
+            case value::datatype::DIRECTION: {
+                h = std::size_t(har::get<direction_t>(val));
+                break;
+            }
+            case value::datatype::COLOR: {
+                auto & c = har::get<color_t>(val);
+                h = (std::size_t(c.r) << 24u) | (std::size_t(c.g) << 16u) | (std::size_t(c.b) << 8u) | c.a;
+                break;
+            }
+            case value::datatype::HASH: {
+                h = std::size_t(har::get<part_h>(val));
+                break;
+            }
+            case value::datatype::SPECIAL:
+            case value::datatype::CALLBACK:
+            default: {
+                return std::nullopt;
+            }
+        }
+        combine(seed, std::size_t(id));
+        combine(seed, h);
+        visuals.emplace_back(val);
+    }
+    return look_t{ logic().id(), placed, std::move(visuals), seed };
+}
+
+cell_base::Map cell_base::properties() const {
+    Map props{ };
+    for_each_property([&props](of id, const value & val) {
+        props.insert_or_assign(id, val);
+    });
+    return props;
+}
+
+cell_base::Map cell_base::intermediate() const {
+    Map inter{ };
+    for_each_intermediate([&inter](of id, const value & val) {
+        inter.insert_or_assign(id, val);
+    });
+    return inter;
 }
 
-const cell_base::Map & cell_base::intermediate() const {
-    return _intermediate;
+bool_t cell_base::has_intermediate() const {
+    return !_iloose.empty() || std::any_of(_dirty.begin(), _dirty.end(), [](auto w) { return w != 0u; });
 }
 
 void cell_base::set_type(const part & pt) {
-    _logic = pt;
+    if (&pt != &_logic.get()) {
+        if (pt.layout() == _logic.get().layout()) {
+            _logic = pt;
+            fit();
+        } else {
+            reslot(pt);
+        }
+    }
+}
+
+bool_t cell_base::has(of id) const {
+    auto slot = _logic.get().slot_of(id);
+    if (slot < _buffers[0].size()) {
+        return front(slot).index();
+    }
+    return _loose.find(id) != _loose.end();
 }
 
 const value & cell_base::get(of id, bool_t now) const {
-    if (now) {
-        auto it = _intermediate.find(id);
-        if (it != _intermediate.end()) {
+    auto slot = _logic.get().slot_of(id);
+    if (slot < _buffers[0].size()) {
+        if (now && is_set(_dirty, slot)) {
+            return back(slot);
+        }
+        if (auto & val = front(slot); val.index()) {
+            return val;
+        }
+    } else {
+        if (now) {
+            if (auto it = _iloose.find(id); it != _iloose.end()) {
+                return it->second;
+            }
+        }
+        if (auto it = _loose.find(id); it != _loose.end()) {
             return it->second;
         }
     }
     DEBUG {
-        if (auto it = _properties.find(id); it != _properties.end()) {
-            return it->second;
-        } else {
-            DEBUG_LOG("cell has no property with ID " + value::to_string(id) + " (" + std::to_string(id) + ")");
-            return value::invalid();
-        }
+        DEBUG_LOG("cell has no property with ID " + value::to_string(id) + " (" + std::to_string(id) + ")");
+        return value::invalid();
     }
-    return _properties.at(id);
+    raise_missing(id);
 }
 
 void cell_base::set(of id, const value & val) noexcept {
-    _intermediate.insert_or_assign(id, val);
+    auto slot = _logic.get().slot_of(id);
+    if (slot != part::NO_SLOT) {
+        if (slot >= _buffers[0].size()) {
+            fit();
+        }
+        back(slot) = val;
+        mark_dirty(slot);
+    } else {
+        _iloose.insert_or_assign(id, val);
+    }
 }
 
 void cell_base::set(of id, value && val) noexcept {
-    _intermediate.insert_or_assign(id, std::forward<value>(val));
+    auto slot = _logic.get().slot_of(id);
+    if (slot != part::NO_SLOT) {
+        if (slot >= _buffers[0].size()) {
+            fit();
+        }
+        back(slot) = std::move(val);
+        mark_dirty(slot);
+    } else {
+        _iloose.insert_or_assign(id, std::forward<value>(val));
+    }
 }
 
 void cell_base::rollback() {
-    _intermediate.clear();
+    std::fill(_dirty.begin(), _dirty.end(), 0u);
+    _iloose.clear();
 }
 
 void cell_base::clear() {
-    _properties.clear();
+    std::fill(_buffers[0].begin(), _buffers[0].end(), value());
+    std::fill(_buffers[1].begin(), _buffers[1].end(), value());
+    std::fill(_front.begin(), _front.end(), 0u);
+    _loose.clear();
     rollback();
 }
 
 void cell_base::transit() {
-    for (auto & e : _intermediate) {
-        _properties.insert_or_assign(e.first, e.second);
+    for (std::size_t w = 0; w < _dirty.size(); ++w) {
+        _front[w] ^= _dirty[w];
+        _dirty[w] = 0u;
     }
-    rollback();
+    for (auto & e : _iloose) {
+        _loose.insert_or_assign(e.first, std::move(e.second));
+    }
+    _iloose.clear();
 }
 
 bool_t cell_base::adopt(const cell_base & cell) {
-    for (auto & p : cell.properties()) {
-        set(p.first, p.second);
-    }
-    return !cell.properties().empty();
+    bool_t any = false;
+    cell.for_each_property([&](of id, const value & val) {
+        set(id, val);
+        any = true;
+    });
+    return any;
 }
 
 bool_t cell_base::adopt(cell_base && cell) {
-    bool_t empty = !cell.properties().empty();
-    std::swap(_intermediate, cell._properties);
-    _properties.merge(cell._properties);
-    return empty;
+    return adopt(static_cast<const cell_base &>(cell));
 }
 
 bool_t cell_base::operator==(const cell_base & rhs) const {
-    return _properties == rhs._properties && _intermediate == rhs._intermediate;
+    return properties() == rhs.properties() && intermediate() == rhs.intermediate();
 }
 
 cell_base & cell_base::operator=(const cell_base & ref) = default;
@@ -135,24 +354,24 @@ cell_base::~cell_base() noexcept = default;
 ostream & har::operator<<(ostream & os, const cell_base & cell) {
     os << string_t(text("part ")) + cell.logic().unique_name() + text('\n');
     std::map<entry_h, string_t> lines;
-    for (auto & p : cell.properties()) {
+    cell.for_each_property([&](of id, const value & val) {
         string_t line{ text("prop ") };
         const auto & model = cell.logic().model();
-        auto eit = model.find(p.first);
+        auto eit = model.find(id);
         if (eit != model.end()) {
             const entry & ent = eit->second;
             if (ent.serializable == serialize::ANYWAY ||
-                (ent.serializable == serialize::SERIALIZE && !ent.is_standard(p.second))) {
-                if (p.first < of::NEXT_FREE) {
-                    line += value::to_string(p.first);
+                (ent.serializable == serialize::SERIALIZE && !ent.is_standard(val))) {
+                if (id < of::NEXT_FREE) {
+                    line += value::to_string(id);
                 } else {
                     line += ent.unique_name;
                 }
-                line += text(" ") + ent.to_string(p.second) + text('\n');
-                lines.emplace(p.first, line);
+                line += text(" ") + ent.to_string(val) + text('\n');
+                lines.emplace(id, line);
             }
         }
-    }
+    });
     for (auto & l : lines) {
         os << l.second;
     }
@@ -175,7 +394,7 @@ har::operator>>(std::tuple<istream &, const std::map<part_h, part> &> is_inv, ce
             if (pit != inv.end()) {
                 const part & pt = pit->second;
                 const auto & model = pt.model();
-                cell._logic = pt;
+                cell.set_type(pt);
                 pt.init_standard(cell);
 
                 while (is.peek() == text('p')) {
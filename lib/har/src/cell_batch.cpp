@@ -0,0 +1,25 @@
+#include <har/cell_batch.hpp>
+
+#include "world/grid_cell_base.hpp"
+
+using namespace har;
+
+//region cell_batch
+
+cell_batch::cell_batch(context & ctx,
+                       grid_cell_base * const * cells,
+                       std::size_t size) : _ctx(ctx),
+                                           _cells(cells),
+                                           _size(size) {
+
+}
+
+std::size_t cell_batch::size() const {
+    return _size;
+}
+
+grid_cell cell_batch::at(std::size_t i) {
+    return grid_cell(_ctx, *_cells[i]);
+}
+
+//endregion
@@ -0,0 +1,82 @@
+#if defined(__AVX2__) || defined(__SSE2__)
+
+#include <immintrin.h>
+
+#endif
+
+#include <har/field.hpp>
+
+using namespace har;
+
+//region field
+
+namespace {
+
+    /// \brief Adds three rows of bytes
+    void add_rows(const std::uint8_t * a, const std::uint8_t * b, const std::uint8_t * c,
+                  std::uint8_t * sum, std::size_t width) {
+        std::size_t x = 0u;
+#if defined(__AVX2__)
+        for (; x + 32u <= width; x += 32u) {
+            auto va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + x));
+            auto vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + x));
+            auto vc = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(c + x));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(sum + x),
+                                _mm256_add_epi8(_mm256_add_epi8(va, vb), vc));
+        }
+#endif
+#if defined(__SSE2__)
+        for (; x + 16u <= width; x += 16u) {
+            auto va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + x));
+            auto vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + x));
+            auto vc = _mm_loadu_si128(reinterpret_cast<const __m128i *>(c + x));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(sum + x), _mm_add_epi8(_mm_add_epi8(va, vb), vc));
+        }
+#endif
+        for (; x < width; ++x) {
+            sum[x] = std::uint8_t(a[x] + b[x] + c[x]);
+        }
+    }
+
+    /// \brief Subtracts a row of bytes from another one
+    void sub_row(std::uint8_t * a, const std::uint8_t * b, std::size_t width) {
+        std::size_t x = 0u;
+#if defined(__AVX2__)
+        for (; x + 32u <= width; x += 32u) {
+            auto va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + x));
+            auto vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + x));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(a + x), _mm256_sub_epi8(va, vb));
+        }
+#endif
+#if defined(__SSE2__)
+        for (; x + 16u <= width; x += 16u) {
+            auto va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + x));
+            auto vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + x));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(a + x), _mm_sub_epi8(va, vb));
+        }
+#endif
+        for (; x < width; ++x) {
+            a[x] = std::uint8_t(a[x] - b[x]);
+        }
+    }
+}
+
+void har::moore_count(const field<bool_t> & in, std::size_t y, std::uint8_t * counts) {
+    //Columns of three rows, padded by an empty column on either side
+    static thread_local std::vector<std::uint8_t> columns{ };
+    static thread_local std::vector<std::uint8_t> empty{ };
+
+    auto width = in.width();
+    columns.assign(width + 2u, 0u);
+    empty.assign(width, 0u);
+
+    auto mid = in.row(y);
+    auto up = y > 0u ? in.row(y - 1u) : empty.data();
+    auto down = y + 1u < in.height() ? in.row(y + 1u) : empty.data();
+    add_rows(up, mid, down, columns.data() + 1u, width);
+
+    add_rows(columns.data(), columns.data() + 1u, columns.data() + 2u, counts, width);
+    sub_row(counts, mid, width);
+}
+
+//endregion
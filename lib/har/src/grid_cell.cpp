@@ -31,9 +31,10 @@ const grid_cell_base & grid_cell::as_grid_cell_base() const noexcept {
 }
 
 cargo_cell grid_cell::spawn(const part & pt, ccoords_t pos) {
-    auto & ncell = _ctx.spawn(cargo_cell_base(CARGO[-1], pt, std::clamp(pos,
-                                                                        ccoords_t(0, 0),
-                                                                        ccoords_t(.999, .999))));
+    //Spawned cargo is positioned absolutely on the grid, like all other cargo
+    auto & ncell = _ctx.spawn(pt, ccoords_t(as_grid_cell_base().position().pos) + ccoords_t::clamp(pos,
+                                                                                                 ccoords_t(0, 0),
+                                                                                                 ccoords_t(.999, .999)));
     return cargo_cell(_ctx, ncell, as_grid_cell_base());
 }
 
@@ -3,8 +3,13 @@
 //
 
 #include <algorithm>
+#include <iterator>
+#include <tuple>
+#include <utility>
+#include <variant>
 
 #include <har/cargo_cell.hpp>
+#include <har/cell_batch.hpp>
 #include <har/grid_cell.hpp>
 
 #include "logic/automaton.hpp"
@@ -23,14 +28,37 @@ automaton::automaton(inner_simulation & sim) : automaton(sim, std::thread::hardw
 
 automaton::automaton(inner_simulation & sim, ushort_t workers) : _sim(sim),
                                                                  _state(state::INIT),
+                                                                 _schedule(schedule::DENSE),
+                                                                 _batched(false),
                                                                  _substep(substep::INIT),
+                                                                 _cycles(0u),
                                                                  _threads(workers),
                                                                  _self_worker(*this, 0u),
                                                                  _workers(),
-                                                                 _barrier(workers),
+                                                                 _barrier(workers + 1),
+                                                                 _scheduler(workers + 1),
+                                                                 _committer(workers + 1),
+                                                                 _shipper(workers + 1),
+                                                                 _carrier(),
+                                                                 _reblocked(),
+                                                                 _journal(),
+                                                                 _nets(),
+                                                                 _fields(),
+                                                                 _fields_valid(false),
                                                                  _autoex(),
                                                                  _cyclex(),
-                                                                 _tab() {
+                                                                 _tab(),
+                                                                 _scheduled(),
+                                                                 _committing(),
+                                                                 _drawing(),
+                                                                 _recipients(),
+                                                                 _irecipients(),
+                                                                 _views(),
+                                                                 _revealed(),
+                                                                 _painters(),
+                                                                 _selections(),
+                                                                 _spawned_cargo(),
+                                                                 _destroyed_cargo() {
     //_cyclex.lock();
     _workers.reset(static_cast<worker *>(::operator new(workers * sizeof(worker))));
     for (auto i = 0u; i < _threads; ++i) {
@@ -39,11 +67,22 @@ automaton::automaton(inner_simulation & sim, ushort_t workers) : _sim(sim),
 }
 
 void automaton::do_step(enum automaton::substep step) {
-    _barrier.reset();
+    if (step == substep::CYCLE_AND_MOVE) {
+        if (_schedule == schedule::SPARSE) {
+            _scheduler.distribute(_scheduled.size());
+        } else {
+            auto & model = _sim.get_model();
+            _scheduler.distribute(model.get_model().dim().size() + model.get_bank().dim().size());
+        }
+        _carrier.prepare(_sim.get_model());
+        if (_carrier.size()) {
+            _shipper.distribute(_carrier.size());
+            _reblocked[0] = false;
+            _reblocked[1] = false;
+        }
+    }
     _substep = step;
-    std::for_each_n(_workers.get(), _threads, [](worker & w) {
-        w.unblock();
-    });
+    unblock_workers();
     switch (step) {
         case substep::CYCLE_AND_MOVE:
             _self_worker.cycle_and_move(worker::step_type::CYCLE);
@@ -58,14 +97,136 @@ void automaton::do_step(enum automaton::substep step) {
             break;
     }
     wait_for_all();
+    if (step == substep::CYCLE_AND_MOVE) {
+        _scheduler.settle();
+        if (_carrier.size()) {
+            _carrier.settle(_sim.get_model(), _self_worker.get_context());
+            _shipper.settle();
+        }
+    } else if (step == substep::COMMIT_AND_DRAW) {
+        for (auto &[id, iparti] : _sim.inner_participants()) {
+            iparti->get_probe().publish(_sim.get_model());
+        }
+        notify(_self_worker.get_context());
+    }
+}
+
+void automaton::unblock_workers() {
+    _barrier.arrive_and_wait();
 }
 
 void automaton::i_am_done() {
-    _barrier.arrive();
+    _barrier.arrive_and_wait();
 }
 
 void automaton::wait_for_all() {
-    _barrier.wait();
+    _barrier.arrive_and_wait();
+}
+
+void automaton::sync() {
+    _barrier.arrive_and_wait();
+}
+
+void automaton::ship(context & ctx) {
+    auto & model = _sim.get_model();
+    for (auto num : ctx.spawned()) {
+        model.add_cargo(num);
+        _spawned_cargo.emplace_back(num);
+        ctx.change(num);
+        ctx.draw(num);
+    }
+    ctx.spawned().clear();
+
+    for (auto num : ctx.destroyed()) {
+        if (model.remove_cargo(num)) {
+            _destroyed_cargo.emplace_back(num);
+        }
+        ctx.changed().erase(num);
+        ctx.redraw().erase(num);
+    }
+    ctx.destroyed().clear();
+}
+
+void automaton::gather(context & ctx) {
+    ship(ctx);
+
+    _recipients.clear();
+    _irecipients.clear();
+    _views.clear();
+    _painters.clear();
+    _selections.clear();
+    for (auto &[id, parti] : _sim.participants()) {
+        auto & iparti = *_sim.inner_participants().at(id);
+        if (iparti.get_selected().is_valid()) {
+            _selections[iparti.get_selected()].emplace_back(_recipients.size());
+        }
+        if (parti->wants_images()) {
+            _painters.emplace_back(_recipients.size());
+            iparti.reveal(_revealed);
+        }
+        _recipients.emplace_back(parti);
+        _irecipients.emplace_back(&iparti);
+        _views.emplace_back(iparti.get_viewport());
+    }
+
+    _committing.assign(ctx.changed().begin(), ctx.changed().end());
+    if (_painters.empty()) {
+        _drawing.clear();
+    } else if (_revealed.empty()) {
+        _drawing.assign(ctx.redraw().begin(), ctx.redraw().end());
+    } else {
+        //Deferred cells may have been removed in the meantime
+        auto & model = _sim.get_model();
+        for (auto it = _revealed.begin(); it != _revealed.end();) {
+            bool_t exists;
+            if (it->index() == cell_cat::GRID_CELL) {
+                auto & pos = it->coords();
+                auto & grid = pos.cat == grid_t::MODEL_GRID ? model.get_model() : model.get_bank();
+                exists = pos.cat != grid_t::INVALID_GRID && pos.pos.in(grid.dim());
+            } else {
+                exists = it->index() == cell_cat::CARGO_CELL && model.cargo().count(it->id());
+            }
+            it = exists ? std::next(it) : _revealed.erase(it);
+        }
+        _revealed.insert(ctx.redraw().begin(), ctx.redraw().end());
+        _drawing.assign(_revealed.begin(), _revealed.end());
+        _revealed.clear();
+    }
+}
+
+void automaton::notify(const context & ctx) {
+    bool_t any = _self_worker.deliver() || !ctx.messages().empty();
+
+    auto & model = _sim.get_model();
+    auto & moved = _carrier.delivered();
+    any = any || !_spawned_cargo.empty() || !moved.empty() || !_destroyed_cargo.empty();
+    for (auto * parti : _recipients) {
+        for (auto num : _spawned_cargo) {
+            parti->on_cargo_spawned(num);
+        }
+        for (auto num : moved) {
+            if (auto * cclb = model.cargo().find(num)) {
+                parti->on_cargo_moved(num, cclb->position());
+            }
+        }
+        for (auto num : _destroyed_cargo) {
+            parti->on_cargo_destroyed(num);
+        }
+    }
+    _spawned_cargo.clear();
+    moved.clear();
+    _destroyed_cargo.clear();
+
+    for (auto & msg : ctx.messages()) {
+        for (auto * parti : _recipients) {
+            parti->on_message(std::get<0>(msg), std::get<1>(msg));
+        }
+    }
+    if (any) {
+        for (auto * parti : _recipients) {
+            parti->on_commit();
+        }
+    }
 }
 
 void automaton::inner_exec(std::pair<participant_h, participant::callback_t> & pack) {
@@ -74,6 +235,37 @@ void automaton::inner_exec(std::pair<participant_h, participant::callback_t> & p
     _self_worker.clean(worker::step_type::REQUEST);
 }
 
+void automaton::prepare_tab() {
+    _scheduled.clear();
+    for (auto &[pos, tab] : _tab.get_active()) {
+        if (tab.status & process::CYCLE) {
+            _scheduled.emplace_back(pos);
+        }
+    }
+    //Row-major order keeps the chunks handed out by the scheduler contiguous in memory
+    std::sort(_scheduled.begin(), _scheduled.end(), [](const gcoords_t & lhs, const gcoords_t & rhs) {
+        return std::tie(lhs.cat, lhs.pos.y, lhs.pos.x) < std::tie(rhs.cat, rhs.pos.y, rhs.pos.x);
+    });
+}
+
+void automaton::settle_tab() {
+    auto & model = _sim.get_model();
+    for (auto & pos : _scheduled) {
+        _tab.tire(pos, model.at(pos));
+    }
+    _scheduled.clear();
+    _self_worker.update_tab();
+    std::for_each_n(_workers.get(), _threads, [](worker & w) {
+        w.update_tab();
+    });
+    _tab.apply();
+}
+
+void automaton::resolve_nets() {
+    _nets.settle(_sim.get_model());
+    _nets.resolve(_self_worker.get_context());
+}
+
 void automaton::commence() {
     std::for_each_n(_workers.get(), _threads, [](worker & w) {
         w.start();
@@ -131,10 +323,69 @@ enum automaton::state automaton::set_state(participant_h id, enum state to) {
     return old;
 }
 
+enum automaton::schedule automaton::schedule() {
+    return _schedule;
+}
+
+enum automaton::schedule automaton::set_schedule(enum schedule to) {
+    auto old = std::exchange(_schedule, to);
+    if (old != to && to == schedule::SPARSE) {
+        refill_tab();
+    }
+    return old;
+}
+
+bool_t automaton::batched() const {
+    return _batched;
+}
+
+bool_t automaton::set_batched(bool_t to) {
+    return std::exchange(_batched, to);
+}
+
+uint_t automaton::cycles() const {
+    return _cycles;
+}
+
+journal & automaton::get_journal() {
+    return _journal;
+}
+
+nets & automaton::get_nets() {
+    return _nets;
+}
+
+void automaton::invalidate_nets() {
+    _nets.invalidate();
+}
+
+void automaton::destroyed_cargo(cargo_h num) {
+    _destroyed_cargo.emplace_back(num);
+}
+
+void automaton::invalidate_fields() {
+    _fields_valid = false;
+}
+
 process_tab & automaton::get_tab() {
     return _tab;
 }
 
+const scheduler & automaton::get_scheduler() const {
+    return _scheduler;
+}
+
+void automaton::refill_tab() {
+    auto & model = _sim.get_model();
+    _tab.clear();
+    for (auto & g : { std::ref(model.get_model()), std::ref(model.get_bank()) }) {
+        for (auto &[pos, gclb] : g.get()) {
+            _tab.wake(gclb.position(), gclb);
+        }
+    }
+    _tab.apply();
+}
+
 std::mutex & automaton::get_autoex() {
     return _autoex;
 }
@@ -174,6 +425,11 @@ void automaton::resize_tab(const gcoords_t & from, const gcoords_t & to) {
             _tab.wake(pos, model.at(pos));
         }
     }
+
+    //Resizing moved the remaining cells of the grid
+    _tab.rebind(from.cat, [&](const gcoords_t & pos) -> cell_base & {
+        return model.at(pos);
+    });
 }
 
 void automaton::request(participant_h id) {
@@ -213,6 +469,7 @@ void automaton::exec(participant_h id, participant::callback_t && fun) {
 
 void automaton::process(inner_participant & iparti) {
     _self_worker.process_single_request(iparti);
+    _self_worker.update_tab();
     _tab.apply();
 }
 
@@ -248,17 +505,35 @@ void automaton::cycle() {
     if (_self_worker.process_requests()) {
         _self_worker.commit_and_draw(worker::step_type::REQUEST);
         _self_worker.clean(worker::step_type::REQUEST);
+        _self_worker.update_tab();
+        _tab.apply();
     }
 
+    if (_schedule == schedule::SPARSE) {
+        prepare_tab();
+    }
+
+    resolve_nets();
     do_step(substep::CYCLE_AND_MOVE);
     do_step(substep::COMMIT_AND_DRAW);
     do_step(substep::CLEAN);
 
+    if (_schedule == schedule::SPARSE) {
+        settle_tab();
+    }
+    ++_cycles;
+
     //end(true);
     DEBUG_LOG("end");
 }
 
 automaton::~automaton() {
+    if (_threads > 0u && _workers[0]._thread.joinable()) {
+        std::for_each_n(_workers.get(), _threads, [](worker & w) {
+            w._valid = false;
+        });
+        unblock_workers();
+    }
     std::for_each_n(_workers.get(), _threads, [](worker & w) {
         w.~worker();
     });
@@ -281,11 +556,11 @@ std::tuple<cell_h, std::reference_wrapper<cell_base>> automaton::dispatcher::get
 
     if (auto mdim = _model.dim(); mdim.has_nth(nth)) {
         gcoords_t pos{ grid_t::MODEL_GRID, mdim.nth_of(nth) };
-        return std::make_tuple(pos, std::ref(_model.at(pos.pos)));
+        return std::make_tuple(pos, std::ref(_model.nth(nth)));
     } else if (auto bdim = _bank.dim(); bdim.has_nth(nth)) {
         nth -= mdim.x * mdim.y;
         gcoords_t pos{ grid_t::BANK_GRID, bdim.nth_of(nth) };
-        return std::make_tuple(pos, std::ref(_bank.at(pos.pos)));
+        return std::make_tuple(pos, std::ref(_bank.nth(nth)));
     } else {
         gcoords_t pos{ grid_t::INVALID_GRID, -1, -1 };
         return std::make_tuple(pos, std::ref(cell_base::invalid()));
@@ -299,11 +574,15 @@ automaton::dispatcher::~dispatcher() = default;
 //region worker
 
 automaton::worker::worker(automaton & automaton, ushort_t id) : _auto(automaton),
-                                                                _workex(),
-                                                                _ctx(),
+                                                                _ctx(automaton._sim.get_model()),
+                                                                _woken(),
+                                                                _updates(),
+                                                                _images(),
+                                                                _deferred(),
+                                                                _chunk(),
                                                                 offset(id),
                                                                 _valid(false) {
-    _workex.lock();
+
 }
 
 void automaton::worker::work() {
@@ -329,62 +608,204 @@ void automaton::worker::work() {
             }
             done();
         } else {
-            done();
             return;
         }
     }
 }
 
 void automaton::worker::begin() {
-    _workex.lock();
+    _auto._barrier.arrive_and_wait();
 }
 
 void automaton::worker::done() {
     _auto.i_am_done();
 }
 
-void automaton::worker::process_grid(grid & grid) {
-    auto dim = grid.dim();
-    auto size = grid.dim().size();
-    auto worker_num = _auto._threads + 1;
+void automaton::worker::cycle(grid_cell_base & gclb) {
+    auto & pt = gclb.logic();
+    if (pt.field_id() != of::VOID) {
+        //Cycled with the field of the part
+        return;
+    } else if (pt.delegates.cycle_static) {
+        pt.delegates.cycle_static(_ctx, gclb);
+    } else {
+        grid_cell gcl{ _ctx, gclb };
+        pt.cycle(gcl);
+    }
+}
+
+void automaton::worker::process_grids(world & world) {
+    auto & model = world.get_model();
+    auto & bank = world.get_bank();
+    uint_t msize = model.dim().size();
 
-    for (int_t it = offset; it < int_t(size); it += worker_num) {
-        dcoords_t i{ it % dim.x, it / dim.x };
-        grid_cell gcl{ _ctx, grid.at(i) };
-        gcl.logic().cycle(gcl);
+    _auto._scheduler.run(offset, [&](uint_t first, uint_t last) {
+        if (_auto._batched) {
+            for (uint_t it = first; it < last; ++it) {
+                _chunk.emplace_back(&(it < msize ? model.nth(it) : bank.nth(it - msize)));
+            }
+            process_batches();
+        } else {
+            for (uint_t it = first; it < last; ++it) {
+                cycle(it < msize ? model.nth(it) : bank.nth(it - msize));
+            }
+        }
+    });
+}
+
+void automaton::worker::process_active() {
+    auto & model = _auto._sim.get_model();
+    auto & scheduled = _auto._scheduled;
+
+    _auto._scheduler.run(offset, [&](uint_t first, uint_t last) {
+        if (_auto._batched) {
+            for (uint_t it = first; it < last; ++it) {
+                _chunk.emplace_back(&model.at(scheduled[it]));
+            }
+            process_batches();
+        } else {
+            for (uint_t it = first; it < last; ++it) {
+                cycle(model.at(scheduled[it]));
+            }
+        }
+    });
+}
+
+void automaton::worker::process_batches() {
+    for (std::size_t first = 0u, size = _chunk.size(); first < size;) {
+        auto & pt = _chunk[first]->logic();
+        auto last = first + 1u;
+        while (last < size && &_chunk[last]->logic() == &pt) {
+            ++last;
+        }
+        if (pt.field_id() != of::VOID) {
+            //Cycled with the field of the part
+        } else if (pt.delegates.cycle_batch) {
+            cell_batch cells{ _ctx, _chunk.data() + first, last - first };
+            pt.cycle(cells);
+        } else {
+            for (auto it = first; it < last; ++it) {
+                cycle(*_chunk[it]);
+            }
+        }
+        first = last;
     }
+    _chunk.clear();
 }
 
-void automaton::worker::process_cargo(world & world) {
-    auto & cargos = world.cargo();
-    auto size = cargos.size();
-    auto worker_num = _auto._threads;
-    uint_t i = 0;
-    auto it = cargos.begin();
+void automaton::worker::cycle_fields() {
+    auto & grid = _auto._sim.get_model().get_model();
+    if (!_auto._fields_valid) {
+        _auto._fields.clear();
+        _auto._fields_valid = true;
+    }
 
-    //Moves index and iterator to the first position to process
-    for (; i < offset; ++i) {
-        if (++it == cargos.end()) {
-            return;
+    //In sparse mode, a field is only cycled while one of its cells is active
+    auto sparse = _auto._schedule == schedule::SPARSE;
+    set<const part *> active{ };
+    if (sparse) {
+        for (auto & pos : _auto._scheduled) {
+            if (pos.cat == grid_t::MODEL_GRID) {
+                if (auto & pt = grid.at(pos.pos).logic(); pt.field_id() != of::VOID) {
+                    active.emplace(&pt);
+                }
+            }
+        }
+    }
+
+    for (auto &[id, pt] : _auto._sim.inventory()) {
+        if (pt.field_id() == of::VOID || (sparse && !active.count(&pt))) {
+            continue;
+        }
+        if (std::holds_alternative<field_kernel<bool_t>>(pt.delegates.cycle_field)) {
+            cycle_field<bool_t>(pt, grid);
+        } else {
+            cycle_field<double_t>(pt, grid);
         }
     }
+}
+
+template<typename T>
+void automaton::worker::cycle_field(const part & pt, grid & gd) {
+    auto & state = _auto._fields[pt.id()];
+    auto & cells = state.cells;
+    auto &[in, out] = std::get<std::pair<field<T>, field<T>>>(state.fields);
+    auto id = pt.field_id();
 
-    do {
-        //TODO: Process cargo here
-        for (uint_t j = 0; j < worker_num; ++j) {
-            ++i;
-            if (++it == cargos.end()) {
-                return;
+    //The mask is kept until a cell of the part is replaced, added cells invalidate all fields
+    auto stale = in.dim() != gd.dim() || std::any_of(cells.begin(), cells.end(), [&](uint_t n) {
+        return &gd.nth(n).logic() != &pt;
+    });
+    if (stale) {
+        in.reset(gd.dim());
+        cells.clear();
+        for (std::size_t y = 0u, n = 0u; y < in.height(); ++y) {
+            auto mask = in.mask(y);
+            for (std::size_t x = 0u; x < in.width(); ++x, ++n) {
+                if (&gd.nth(uint_t(n)).logic() == &pt) {
+                    mask[x] = 1u;
+                    cells.emplace_back(uint_t(n));
+                }
             }
         }
-    } while (i < size);
+    }
+    if (cells.empty()) {
+        return;
+    }
+
+    for (auto n : cells) {
+        in[n] = har::get<T>(gd.nth(n).get(id));
+    }
+    out = in;
+    pt.cycle(in, out);
+
+    //Only changed values are written back, which notes them as changed like any other write
+    for (auto n : cells) {
+        if (out[n] != in[n]) {
+            grid_cell gcl{ _ctx, gd.nth(n) };
+            gcl[id] = T(out[n]);
+        }
+    }
+}
+
+void automaton::worker::process_cargo() {
+    auto & carrier = _auto._carrier;
+    auto & model = _auto._sim.get_model();
+
+    _auto._shipper.run(offset, [&](uint_t first, uint_t last) {
+        carrier.propose(_ctx, model, first, last);
+    });
+    _auto.sync();
+
+    for (uint_t round = 1u;; ++round) {
+        auto & reblocked = _auto._reblocked[round % 2u];
+        if (offset == 0u) {
+            _auto._shipper.distribute(carrier.size());
+        }
+        _auto.sync();
+        //Every worker has read the flag of the previous round by now
+        if (offset == 0u) {
+            _auto._reblocked[(round + 1u) % 2u] = false;
+        }
+        _auto._shipper.run(offset, [&](uint_t first, uint_t last) {
+            if (carrier.resolve(round, first, last)) {
+                reblocked = true;
+            }
+        });
+        _auto.sync();
+        if (!reblocked) {
+            break;
+        }
+    }
 }
 
 void automaton::worker::request_commit_and_draw(context & ctx) {
     auto & model = _auto._sim.get_model();
     for (auto & conn : ctx.connected()) {
         auto & from = conn.base.get();
-        from.add_connection(conn.use, model.at(conn.pos));
+        auto & to = model.at(conn.pos);
+        from.add_connection(conn.use, to);
+        _auto._nets.connect(from, to);
         ctx.change(conn.base.get().position());
         for (auto &[id, parti] : _auto._sim.participants()) {
             parti->on_connection_added(conn.base.get().position(), conn.pos, conn.use);
@@ -392,12 +813,26 @@ void automaton::worker::request_commit_and_draw(context & ctx) {
     }
     for (auto & conn : ctx.disconnected()) {
         auto & from = conn.base.get();
+        if (auto * to = from.get_connected(conn.use)) {
+            _auto._nets.disconnect(from, *to);
+        }
         from.remove_connection(conn.use);
         ctx.change(conn.base.get().position());
         for (auto &[id, parti] : _auto._sim.participants()) {
             parti->on_connection_removed(from.position(), conn.use);
         }
     }
+    //Swapped cells take their connections along, which may rewire their nets
+    for (auto & hnd : ctx.changed()) {
+        if (cell_cat(hnd.index()) == cell_cat::GRID_CELL) {
+            auto & gclb = static_cast<grid_cell_base &>(model.at(hnd));
+            _auto._nets.touch(gclb);
+            //Cells may have become part of a field
+            if (gclb.logic().field_id() != of::VOID) {
+                _auto._fields_valid = false;
+            }
+        }
+    }
     /*if (!ctx.changed().empty()) {
         context temp_ctx;
         for (auto & hnd : ctx.changed()) {
@@ -428,46 +863,125 @@ void automaton::worker::request_commit_and_draw(context & ctx) {
         ctx.changed().merge(temp_ctx.changed());
         ctx.redraw().merge(temp_ctx.redraw());
     }*/
-    cycle_commit_and_draw(ctx);
+    _auto.gather(ctx);
+    _updates.resize(_auto._recipients.size());
+    _images.resize(_auto._recipients.size());
+    _deferred.resize(_auto._recipients.size());
+    commit(0u, uint_t(_auto._committing.size()));
+    draw(ctx, 0u, uint_t(_auto._drawing.size()));
+    _auto.notify(ctx);
 }
 
-void automaton::worker::cycle_commit_and_draw(context & ctx) {
+void automaton::worker::cycle_commit_and_draw() {
+    reduce();
+
+    if (offset == 0u) {
+        _auto.gather(_ctx);
+        _auto._committer.distribute(uint_t(_auto._committing.size()));
+    }
+    _auto.sync();
+    _updates.resize(_auto._recipients.size());
+    _images.resize(_auto._recipients.size());
+    _deferred.resize(_auto._recipients.size());
+    _auto._committer.run(offset, [&](uint_t first, uint_t last) {
+        commit(first, last);
+    });
+    _auto.sync();
+
+    //Cells are drawn only after all of them are committed, as drawing may read from neighbors
+    if (offset == 0u) {
+        _auto._committer.distribute(uint_t(_auto._drawing.size()));
+    }
+    _auto.sync();
+    _auto._committer.run(offset, [&](uint_t first, uint_t last) {
+        draw(_ctx, first, last);
+    });
+}
+
+void automaton::worker::reduce() {
+    uint_t workers = _auto._threads + 1u;
+    for (uint_t stride = 1u; stride < workers; stride <<= 1u) {
+        if (offset % (stride << 1u) == 0u && offset + stride < workers) {
+            context & other = _auto._workers[offset + stride - 1u]._ctx;
+            _ctx.changed().merge(other.changed());
+            _ctx.redraw().merge(other.redraw());
+            _ctx.messages().insert(_ctx.messages().end(), other.messages().begin(), other.messages().end());
+            other.messages().clear();
+            _ctx.spawned().insert(_ctx.spawned().end(), other.spawned().begin(), other.spawned().end());
+            other.spawned().clear();
+            _ctx.moved().merge(other.moved());
+            _ctx.destroyed().merge(other.destroyed());
+        }
+        _auto.sync();
+    }
+}
+
+void automaton::worker::commit(uint_t first, uint_t last) {
     auto & model = _auto._sim.get_model();
-    for (auto & hnd : ctx.changed()) {
+    auto & selections = _auto._selections;
+    for (uint_t it = first; it < last; ++it) {
+        auto & hnd = _auto._committing[it];
         cell_base & clb = model.at(hnd);
-        for (auto & iparti : _auto._sim.inner_participants()) {
-            if (iparti.second->get_selected() == hnd) {
-                auto parti = _auto._sim.participants().at(iparti.first);
-                for (auto &[id, val] : clb.intermediate()) {
-                    parti->on_selection_update(hnd, id, val, false);
-                }
-                if (!clb.intermediate().empty()) {
-                    parti->on_commit();
-                }
+        if (auto sel = selections.find(hnd); sel != selections.end()) {
+            for (auto r : sel->second) {
+                clb.for_each_intermediate([&](of id, const value & val) {
+                    _updates[r].emplace_back(hnd, id, val);
+                });
             }
         }
+        if (_auto._schedule == schedule::SPARSE && cell_cat(hnd.index()) == cell_cat::GRID_CELL) {
+            wake_affected(static_cast<grid_cell_base &>(clb));
+        }
         clb.transit();
     }
-    for (auto & hnd : ctx.redraw()) {
-        for (auto &[num, parti] : _auto._sim.participants()) {
-            auto & clb = model.at(hnd);
-            auto & pt = clb.logic();
+}
+
+void automaton::worker::draw(context & ctx, uint_t first, uint_t last) {
+    auto & model = _auto._sim.get_model();
+    auto & recipients = _auto._recipients;
+    for (uint_t it = first; it < last; ++it) {
+        auto & hnd = _auto._drawing[it];
+        auto & clb = model.at(hnd);
+        auto & pt = clb.logic();
+        bool_t placed;
+        switch (cell_cat(hnd.index())) {
+            case cell_cat::GRID_CELL: {
+                placed = static_cast<grid_cell_base &>(clb).is_placed();
+                break;
+            }
+            case cell_cat::CARGO_CELL: {
+                placed = static_cast<cargo_cell_base &>(clb).id() != CARGO[0];
+                break;
+            }
+            default: {
+                placed = false;
+                break;
+            }
+        }
+        auto look = clb.look(placed);
+        for (auto r : _auto._painters) {
+            if (!_auto._views[r].contains(hnd)) {
+                _deferred[r].emplace_back(hnd);
+                continue;
+            }
+            auto * parti = recipients[r];
+            if (look) {
+                if (auto kept = parti->find_image(hnd, *look)) {
+                    _images[r].emplace_back(hnd, std::move(*kept));
+                    continue;
+                }
+            }
             auto img = parti->get_image_base(hnd);
 
             switch (cell_cat(hnd.index())) {
                 case cell_cat::INVALID_CELL: {
-                    break;
+                    continue;
                 }
                 case cell_cat::GRID_CELL: {
                     auto & gclb = static_cast<grid_cell_base &>(clb);
                     grid_cell gcl{ ctx, gclb };
                     pt.draw(gcl, img);
                     img = parti->process_image(gclb.position(), img);
-                    parti->on_redraw(hnd, std::forward<image_t>(img), false);
-                    for (auto dir : direction::cardinal) {
-                        gcoords_t npos{ gclb.position() };
-                        npos.pos += dir;
-                    }
                     break;
                 }
                 case cell_cat::CARGO_CELL: {
@@ -476,16 +990,41 @@ void automaton::worker::cycle_commit_and_draw(context & ctx) {
                     cargo_cell ccl{ ctx, cclb, gclb };
                     pt.draw(ccl, img);
                     img = parti->process_image(cclb.id(), img);
-                    parti->on_redraw(hnd, std::forward<image_t>(img), false);
                     break;
                 }
             }
-            parti->on_commit();
+            if (look) {
+                parti->keep_image(hnd, *look, img);
+            }
+            _images[r].emplace_back(hnd, std::move(img));
         }
     }
-    for (auto & msg : ctx.messages()) {
-        for (auto &[id, parti] : _auto._sim.participants()) {
-            parti->on_message(std::get<0>(msg), std::get<1>(msg));
+}
+
+void automaton::worker::wake_affected(const grid_cell_base & gclb) {
+    auto wakes = [&gclb](const grid_cell_base & other) {
+        auto & waking = other.logic().waking();
+        bool_t woken = false;
+        gclb.for_each_intermediate([&](of id, const value &) {
+            woken = woken || waking.find(id) != waking.end();
+        });
+        return woken;
+    };
+
+    _woken.emplace_back(gclb.position());
+    for (auto dir : direction::cardinal) {
+        if (auto * ngclb = gclb.get_neighbor(dir); ngclb && wakes(*ngclb)) {
+            _woken.emplace_back(ngclb->position());
+        }
+    }
+    for (auto &[use, cgclb] : gclb.connected()) {
+        if (wakes(cgclb.get())) {
+            _woken.emplace_back(cgclb.get().position());
+        }
+    }
+    for (auto &[igclb, num] : gclb.iconnected()) {
+        if (wakes(*igclb)) {
+            _woken.emplace_back(igclb->position());
         }
     }
 }
@@ -503,6 +1042,9 @@ void automaton::worker::start() {
 
 void automaton::worker::process_single_request(inner_participant & iparti) {
     auto & ctx = iparti.get_context();
+    if (_auto._journal.recording()) {
+        _auto._journal.write(_auto._cycles, ctx, _auto._sim.get_model());
+    }
     request_commit_and_draw(ctx);
     ctx.reset();
 }
@@ -518,11 +1060,17 @@ void automaton::worker::process_exec(std::pair<participant_h, participant::callb
 
 bool_t automaton::worker::process_requests() {
     bool_t processed = false;
+    if (_auto._journal.replaying()) {
+        processed = _auto._journal.apply(_auto._cycles, _ctx, _auto._sim.get_model());
+    }
     for (auto &[id, iparti_rw] : _auto._sim.inner_participants()) {
         auto & iparti = *iparti_rw;
         if (iparti.do_cycle()) {
-            participant::context ctx{ iparti, UI, false };
-            _auto._sim.participants().at(id)->on_cycle(ctx);
+            {
+                participant::context ctx{ iparti, UI, false };
+                _auto._sim.participants().at(id)->on_cycle(ctx);
+            }
+            process_single_request(iparti);
             processed = true;
         }
         if (iparti.has_request()) {
@@ -535,9 +1083,17 @@ bool_t automaton::worker::process_requests() {
 
 void automaton::worker::cycle_and_move(step_type type) {
     //DEBUG_LOG("WORKER[" << offset << "] does CYCLE_AND_MOVE");
-    world & model = _auto._sim.get_model();
-    process_grid(model.get_model());
-    process_grid(model.get_bank());
+    if (type == step_type::CYCLE && offset == 0u) {
+        cycle_fields();
+    }
+    if (_auto._schedule == schedule::SPARSE) {
+        process_active();
+    } else {
+        process_grids(_auto._sim.get_model());
+    }
+    if (type == step_type::CYCLE && _auto._carrier.size()) {
+        process_cargo();
+    }
 }
 
 void automaton::worker::commit_and_draw(step_type type) {
@@ -545,7 +1101,7 @@ void automaton::worker::commit_and_draw(step_type type) {
     if (type == step_type::REQUEST) {
         request_commit_and_draw(_ctx);
     } else {
-        cycle_commit_and_draw(_ctx);
+        cycle_commit_and_draw();
     }
 }
 
@@ -554,14 +1110,57 @@ void automaton::worker::clean(step_type type) {
     _ctx.reset();
 }
 
-void automaton::worker::unblock() {
-    _workex.unlock();
+void automaton::worker::update_tab() {
+    auto & model = _auto._sim.get_model();
+    for (auto & pos : _woken) {
+        _auto._tab.wake(pos, model.at(pos));
+    }
+    _woken.clear();
+}
+
+context & automaton::worker::get_context() {
+    return _ctx;
+}
+
+bool_t automaton::worker::deliver() {
+    bool_t any = false;
+    for (std::size_t r = 0; r < _auto._recipients.size(); ++r) {
+        auto & updates = _updates[r];
+        auto & images = _images[r];
+        auto & deferred = _deferred[r];
+        for (uint_t i = 0; i < _auto._threads; ++i) {
+            auto & w = _auto._workers[i];
+            if (r < w._updates.size()) {
+                std::move(w._updates[r].begin(), w._updates[r].end(), std::back_inserter(updates));
+                std::move(w._images[r].begin(), w._images[r].end(), std::back_inserter(images));
+                deferred.insert(deferred.end(), w._deferred[r].begin(), w._deferred[r].end());
+                w._updates[r].clear();
+                w._images[r].clear();
+                w._deferred[r].clear();
+            }
+        }
+        if (!deferred.empty()) {
+            _auto._irecipients[r]->defer(deferred);
+            deferred.clear();
+        }
+
+        auto * parti = _auto._recipients[r];
+        if (!updates.empty()) {
+            parti->on_selection_update_batch(updates);
+            updates.clear();
+            any = true;
+        }
+        if (!images.empty()) {
+            parti->on_redraw_batch(images);
+            images.clear();
+            any = true;
+        }
+    }
+    return any;
 }
 
 automaton::worker::~worker() {
     if (_thread.joinable()) {
-        _valid = false;
-        _workex.unlock();
         _thread.join();
     }
 }
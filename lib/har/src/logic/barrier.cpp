@@ -2,44 +2,74 @@
 // Created by Johannes on 22.11.2020.
 //
 
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+
+#include <immintrin.h>
+
+#define HAR_CPU_RELAX() _mm_pause()
+#else
+#define HAR_CPU_RELAX() std::this_thread::yield()
+#endif
+
 #include "logic/barrier.hpp"
 
 using namespace har;
 
-barrier::barrier(std::ptrdiff_t expected) :
-        _count(expected),
-        _expected(expected),
-        _mutex() {
-
+uint_t barrier::default_spin() {
+    return std::thread::hardware_concurrency() > 1u ? 1u << 12u : 0u;
 }
 
-bool_t barrier::finished() const {
-    return _count.load(std::memory_order_acquire) == 0;
+barrier::barrier(std::ptrdiff_t expected, uint_t spin) : _count(expected),
+                                                         _expected(expected),
+                                                         _sense(false),
+                                                         _parked(0u),
+                                                         _spin(spin),
+                                                         _mutex(),
+                                                         _cv() {
+
 }
 
-void barrier::arrive(std::ptrdiff_t n) {
-    if (_count.fetch_sub(n, std::memory_order_acq_rel) <= 1) {
-        _mutex.unlock();
+void barrier::wait_for(bool_t sense) {
+    for (uint_t i = 0; i < _spin; ++i) {
+        if (_sense.load(std::memory_order_acquire) == sense) {
+            return;
+        }
+        HAR_CPU_RELAX();
+    }
+    for (uint_t i = 0; i < YIELDS; ++i) {
+        if (_sense.load(std::memory_order_acquire) == sense) {
+            return;
+        }
+        std::this_thread::yield();
     }
-}
 
-void barrier::wait() {
-    std::scoped_lock{ _mutex };
+    std::unique_lock lock{ _mutex };
+    _parked.fetch_add(1u, std::memory_order_seq_cst);
+    _cv.wait(lock, [&]() {
+        return _sense.load(std::memory_order_seq_cst) == sense;
+    });
+    _parked.fetch_sub(1u, std::memory_order_relaxed);
 }
 
-void barrier::arrive_and_wait(std::ptrdiff_t n) {
-    if (_count.fetch_sub(n, std::memory_order_acq_rel) <= 1) {
-        _mutex.unlock();
+void barrier::arrive_and_wait() {
+    // the sense cannot flip before this thread arrived, so it is read safely beforehand
+    bool_t sense = !_sense.load(std::memory_order_relaxed);
+    if (_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        _count.store(_expected, std::memory_order_relaxed);
+        _sense.store(sense, std::memory_order_seq_cst);
+        if (_parked.load(std::memory_order_seq_cst) != 0u) {
+            std::scoped_lock lock{ _mutex };
+            _cv.notify_all();
+        }
     } else {
-        wait();
+        wait_for(sense);
     }
 }
 
-void barrier::reset() {
-    _count.exchange(_expected, std::memory_order_acq_rel);
-    _mutex.lock();
+std::ptrdiff_t barrier::expected() const {
+    return _expected;
 }
 
-barrier::~barrier() noexcept {
-    wait();
-}
+barrier::~barrier() noexcept = default;
@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <cmath>
+
+#include <har/cargo_cell.hpp>
+
+#include "logic/carrier.hpp"
+
+using namespace har;
+
+//region carrier::shipment
+
+carrier::shipment::shipment(cargo_cell_base & cclb) : cargo(&cclb),
+                                                      from(cclb.position()),
+                                                      to(cclb.position()),
+                                                      extent(carrier::extent_of(cclb)),
+                                                      blocked(FREE) {
+
+}
+
+carrier::shipment::shipment(shipment && fref) noexcept: cargo(fref.cargo),
+                                                         from(fref.from),
+                                                         to(fref.to),
+                                                         extent(fref.extent),
+                                                         blocked(fref.blocked.load()) {
+
+}
+
+//endregion
+
+//region carrier
+
+bool_t carrier::overlap(const ccoords_t & lhs, const ccoords_t & lext,
+                        const ccoords_t & rhs, const ccoords_t & rext) {
+    return std::abs((lhs.x - rhs.x).v) < (lext.x + rext.x).v &&
+           std::abs((lhs.y - rhs.y).v) < (lext.y + rext.y).v;
+}
+
+ccoords_t carrier::extent_of(const cargo_cell_base & cclb) {
+    auto ext = cclb.size() / 2. - cclb.radius();
+    return ccoords_t(std::max(ext.x.v, 0.), std::max(ext.y.v, 0.));
+}
+
+carrier::carrier() : _shipments(),
+                     _index(),
+                     _reach(),
+                     _delivered() {
+
+}
+
+void carrier::prepare(world & world) {
+    //The pool's dense order only depends on the order cargo was added and removed in
+    _shipments.clear();
+    _shipments.reserve(world.cargo().size());
+    for (auto & cclb : world.cargo()) {
+        _shipments.emplace_back(cclb);
+    }
+
+    ccoords_t widest{ };
+    for (auto & s : _shipments) {
+        widest = ccoords_t(std::max(widest.x.v, s.extent.x.v), std::max(widest.y.v, s.extent.y.v));
+    }
+    _reach = widest + MAX_STEP;
+    _index.rebuild(world.get_model().dim(), uint_t(_shipments.size()), [this](uint_t i) {
+        return _shipments[i].from;
+    });
+}
+
+uint_t carrier::size() const {
+    return uint_t(_shipments.size());
+}
+
+void carrier::propose(context & ctx, world & world, uint_t first, uint_t last) {
+    auto & model = world.get_model();
+    auto bound = ccoords_t(model.dim()) - 1e-9;
+    for (uint_t i = first; i < last; ++i) {
+        auto & s = _shipments[i];
+        auto & cclb = *s.cargo;
+        dcoords_t pos{ s.from };
+        if (!pos.in(model.dim())) {
+            cclb.take_move_delta();
+            s.blocked.store(0u, std::memory_order_relaxed);
+            continue;
+        }
+
+        auto & gclb = model.at(pos);
+        cargo_cell ccl{ ctx, cclb, gclb };
+        ccl.logic().cycle(ccl);
+
+        auto delta = cclb.take_move_delta();
+        for (auto dir : direction::cardinal) {
+            auto id = value::moved(dir);
+            if (gclb.has(id) && gclb.get(id).type() == value::datatype::DOUBLE) {
+                delta += ccoords_t(!dir) * har::get<double_t>(gclb.get(id));
+            }
+        }
+        delta = ccoords_t::clamp(delta, ccoords_t(-MAX_STEP, -MAX_STEP), ccoords_t(MAX_STEP, MAX_STEP));
+        s.to = ccoords_t::clamp(s.from + delta, ccoords_t(), bound);
+        s.blocked.store(s.to == s.from ? 0u : FREE, std::memory_order_relaxed);
+    }
+}
+
+bool_t carrier::resolve(uint_t round, uint_t first, uint_t last) {
+    bool_t any = false;
+    for (uint_t i = first; i < last; ++i) {
+        auto & s = _shipments[i];
+        if (s.blocked.load(std::memory_order_relaxed) < round) {
+            continue;
+        }
+        bool_t blocked = false;
+        _index.for_each_near(s.to, s.extent + _reach, [&](uint_t j) {
+            if (blocked || j == i) {
+                return;
+            }
+            auto & o = _shipments[j];
+            //Cargo that already overlaps may separate
+            if (overlap(s.from, s.extent, o.from, o.extent)) {
+                return;
+            }
+            //Only blocks of previous rounds are seen, as others may be written concurrently
+            bool_t stays = o.blocked.load(std::memory_order_relaxed) < round;
+            if ((stays || j < i) && overlap(s.to, s.extent, stays ? o.from : o.to, o.extent)) {
+                blocked = true;
+            }
+        });
+        if (blocked) {
+            s.blocked.store(round, std::memory_order_relaxed);
+            any = true;
+        }
+    }
+    return any;
+}
+
+void carrier::settle(world & world, context & ctx) {
+    for (auto & s : _shipments) {
+        if (s.blocked.load(std::memory_order_relaxed) == FREE && world.move_cargo(*s.cargo, s.to)) {
+            _delivered.emplace_back(s.cargo->id());
+            ctx.draw(s.cargo->id());
+        }
+    }
+    _shipments.clear();
+}
+
+decltype(carrier::_delivered) & carrier::delivered() {
+    return _delivered;
+}
+
+carrier::~carrier() = default;
+
+//endregion
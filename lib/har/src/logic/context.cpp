@@ -127,8 +127,10 @@ void context::disconnect(unresolved_connection && conn) {
     _disconnected.emplace_back(conn);
 }
 
-cargo_cell_base & context::spawn(cargo_cell_base && cell) {
-    return *_spawned.emplace_back(new cargo_cell_base(std::forward<cargo_cell_base>(cell)));
+cargo_cell_base & context::spawn(const part & pt, const ccoords_t & pos) {
+    auto & cclb = _model->reserve_cargo(pt, pos);
+    _spawned.emplace_back(cclb.id());
+    return cclb;
 }
 
 void context::move(cargo_h num) {
@@ -144,8 +146,9 @@ void context::reset() {
     _redraw.clear();
     _connected.clear();
     _disconnected.clear();
-    for (auto & ptr : _spawned) {
-        delete ptr;
+    //Cargo that was never added is given back
+    for (auto num : _spawned) {
+        _model->remove_cargo(num);
     }
     _spawned.clear();
     _moved.clear();
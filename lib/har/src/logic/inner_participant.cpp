@@ -2,6 +2,8 @@
 // Created by Johannes on 25.06.2020.
 //
 
+#include <algorithm>
+
 #include "logic/inner_participant.hpp"
 #include "logic/inner_simulation.hpp"
 
@@ -41,13 +43,18 @@ asymmetric_lock::~asymmetric_lock() = default;
 //region inner_participant
 
 inner_participant::inner_participant(participant_h id, inner_simulation & sim) : _id(id),
-                                                                                 _ctx(),
+                                                                                 _ctx(sim.get_model()),
                                                                                  _simulation(sim),
                                                                                  _automaton(sim.get_automaton()),
                                                                                  _model(sim.get_model()),
                                                                                  _do_cycle(),
-                                                                                 _do_draw(),
+                                                                                 _do_draw(true),
                                                                                  _selected(std::monostate()),
+                                                                                 _viewex(),
+                                                                                 _viewport{ true, { }},
+                                                                                 _deferred(),
+                                                                                 _revealed(false),
+                                                                                 _probe(),
                                                                                  _alock(sim.get_automaton().get_autoex()) {
 
 }
@@ -82,7 +89,79 @@ bool_t inner_participant::do_draw() const {
 }
 
 bool_t inner_participant::do_draw(bool_t draw) {
-    return _do_draw.exchange(draw, std::memory_order_acq_rel);
+    bool_t old;
+    {
+        std::scoped_lock lock{ _viewex };
+        _viewport.drawing = draw;
+        old = _do_draw.exchange(draw, std::memory_order_acq_rel);
+        if (draw && !old) {
+            _revealed.store(true, std::memory_order_release);
+        }
+    }
+    if (draw && !old) {
+        draw_revealed();
+    }
+    return old;
+}
+
+void inner_participant::set_viewport(grid_t grid, const dcoords_t & from, const dcoords_t & to) {
+    {
+        std::scoped_lock lock{ _viewex };
+        _viewport.area(grid) = std::make_pair(from, to);
+        _revealed.store(true, std::memory_order_release);
+    }
+    draw_revealed();
+}
+
+void inner_participant::reset_viewport(grid_t grid) {
+    {
+        std::scoped_lock lock{ _viewex };
+        _viewport.area(grid).reset();
+        _revealed.store(true, std::memory_order_release);
+    }
+    draw_revealed();
+}
+
+void inner_participant::draw_revealed() {
+    if (_automaton.get().state() != automaton::state::STOP) {
+        return;
+    }
+    {
+        std::scoped_lock lock{ _viewex };
+        if (std::none_of(_deferred.begin(), _deferred.end(), [&](auto & hnd) { return _viewport.contains(hnd); })) {
+            return;
+        }
+    }
+    //An empty request gathers the revealed cells and draws them
+    auto ctx = request();
+}
+
+viewport inner_participant::get_viewport() {
+    std::scoped_lock lock{ _viewex };
+    return _viewport;
+}
+
+void inner_participant::defer(const std::vector<cell_h> & cells) {
+    std::scoped_lock lock{ _viewex };
+    _deferred.insert(cells.begin(), cells.end());
+}
+
+void inner_participant::reveal(std::set<cell_h> & into) {
+    if (_revealed.exchange(false, std::memory_order_acq_rel)) {
+        std::scoped_lock lock{ _viewex };
+        for (auto it = _deferred.begin(); it != _deferred.end();) {
+            if (_viewport.contains(*it)) {
+                into.insert(*it);
+                it = _deferred.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+probe & inner_participant::get_probe() {
+    return _probe;
 }
 
 bool_t inner_participant::has_request() const {
@@ -160,6 +239,12 @@ void inner_participant::load_model(istream & is) {
     sim.load_model(_ctx, is);
 }
 
+void inner_participant::load_model(const std::filesystem::path & path) {
+    auto ctx = request();
+    auto & sim = _simulation.get();
+    sim.load_model(_ctx, path);
+}
+
 void inner_participant::store_model(string_t & ser) {
     stringstream ss{ };
     _simulation.get().store_model(ss);
@@ -171,6 +256,11 @@ void inner_participant::store_model(ostream & os) {
     _simulation.get().store_model(os);
 }
 
+void inner_participant::store_model(ostream & os, model_format format) {
+    auto ctx = request();
+    _simulation.get().store_model(os, format);
+}
+
 void inner_participant::resize_grid(const gcoords_t & to) {
     if (to.cat != grid_t::INVALID_GRID) {
         auto & sim = _simulation.get();
@@ -183,7 +273,9 @@ void inner_participant::resize_grid(const gcoords_t & to) {
             auto old = dcoords_t::clamp(grid.dim(), dcoords_t(1, 1), to.pos);
             auto max = dcoords_t{ std::numeric_limits<int_t>::max(), std::numeric_limits<int_t>::max() };
             old = dcoords_t::clamp(old, dcoords_t(1, 1), max);
-            model.resize(to.cat, ept, to.pos);
+            for (auto num : model.resize(to.cat, ept, to.pos)) {
+                automaton.destroyed_cargo(num);
+            }
             for (auto &[id, parti] : sim.participants()) {
                 parti->on_resize_grid(to);
                 if (from.x != to.pos.x) {
@@ -202,20 +294,33 @@ void inner_participant::resize_grid(const gcoords_t & to) {
                 }
             }
             automaton.resize_tab(gcoords_t(to.cat, from), to);
+            automaton.invalidate_nets();
+            automaton.invalidate_fields();
         }
     }
 }
 
 void inner_participant::redraw_all() {
     auto parti = _simulation.get().participants().at(_id);
+    if (!parti->wants_images()) {
+        return;
+    }
     for (auto & g : { std::ref(_model.get().get_model()), std::ref(_model.get().get_bank())}) {
         for (auto & c : g.get()) {
             cell_h hnd{ gcoords_t{ g.get().cat(), c.first }};
-            auto img = parti->get_image_base(hnd);
             auto & gclb = c.second;
+            auto look = gclb.look(gclb.is_placed());
+            if (auto kept = look ? parti->find_image(hnd, *look) : std::nullopt) {
+                parti->on_redraw(hnd, std::move(*kept), true);
+                continue;
+            }
+            auto img = parti->get_image_base(hnd);
             grid_cell gcl{ _ctx, gclb };
             gclb.logic().draw(gcl, img);
             img = parti->process_image(gclb.position(), img);
+            if (look) {
+                parti->keep_image(hnd, *look, img);
+            }
             parti->on_redraw(hnd, std::move(img), true);
         }
     }
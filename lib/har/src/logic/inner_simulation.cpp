@@ -2,7 +2,10 @@
 // Created by Johannes on 02.07.2020.
 //
 
+#include <iterator>
+
 #include "logic/inner_simulation.hpp"
+#include "world/model_file.hpp"
 
 using namespace har;
 
@@ -175,21 +178,49 @@ const part & inner_simulation::part_of(part_h id) const {
     return _inventory.at(id);
 }
 
+void inner_simulation::adopt_model(model && loaded) {
+    _model = std::move(loaded);
+    _automaton.refill_tab();
+    _automaton.invalidate_nets();
+    _automaton.invalidate_fields();
+
+    for (auto & p : _partis) {
+        p.second->on_resize_grid(gcoords_t{ grid_t::MODEL_GRID, _model.get_model().dim() });
+        p.second->on_resize_grid(gcoords_t{ grid_t::BANK_GRID, _model.get_bank().dim() });
+        p.second->on_model_loaded();
+        p.second->on_info_updated(_model.info());
+    }
+}
+
 void inner_simulation::load_model(context & ctx, istream & is) {
     model _new_model{ *this };
     bool_t ok;
-    is >> std::tie(_new_model, ok);
+    if (model_file::is_binary(is)) {
+        std::vector<char> bytes{ std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>() };
+        ok = model_file::load(span<const char>(bytes.data(), bytes.size()), _new_model, _inventory);
+    } else {
+        is >> std::tie(_new_model, ok);
+    }
     if (ok) {
-        _model = std::move(_new_model);
+        adopt_model(std::move(_new_model));
+    } else {
+        send_message("Error", "Read in model couldn't be loaded. Source contains errors");
+    }
+}
 
-        for (auto & p : _partis) {
-            p.second->on_resize_grid(gcoords_t{ grid_t::MODEL_GRID, _model.get_model().dim() });
-            p.second->on_resize_grid(gcoords_t{ grid_t::BANK_GRID, _model.get_bank().dim() });
-            p.second->on_model_loaded();
-            p.second->on_info_updated(_model.info());
+void inner_simulation::load_model(context & ctx, const std::filesystem::path & path) {
+    model_file::mapping file{ path };
+    auto bytes = file.bytes();
+    if (model_file::is_binary(bytes)) {
+        model _new_model{ *this };
+        if (model_file::load(bytes, _new_model, _inventory)) {
+            adopt_model(std::move(_new_model));
+        } else {
+            send_message("Error", "Read in model couldn't be loaded. Source contains errors");
         }
     } else {
-        send_message("Error", "Read in model couldn't be loaded. Source contains errors");
+        imstream ims{ bytes.data(), bytes.size() };
+        load_model(ctx, ims);
     }
 }
 
@@ -197,6 +228,14 @@ void inner_simulation::store_model(ostream & os) {
     os << _model;
 }
 
+void inner_simulation::store_model(ostream & os, model_format format) {
+    if (format == model_format::BINARY) {
+        model_file::store(os, _model);
+    } else {
+        store_model(os);
+    }
+}
+
 void inner_simulation::send_message(const string_t & header, const string_t & content) {
     for (auto &[id, parti] : _partis) {
         parti->on_message(header, content);
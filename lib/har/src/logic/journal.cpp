@@ -0,0 +1,303 @@
+#include <stdexcept>
+
+#include "logic/journal.hpp"
+
+using namespace har;
+
+//region journal
+
+journal::journal() : _out(nullptr),
+                     _in(nullptr),
+                     _frame(),
+                     _records(0u),
+                     _next(NEVER) {
+
+}
+
+void journal::put_cell(const cell_h & hnd) {
+    put(std::uint8_t(hnd.index()));
+    if (hnd.index() == cell_cat::GRID_CELL) {
+        auto & pos = hnd.coords();
+        put(std::int8_t(pos.cat));
+        put(std::int32_t(pos.pos.x.v));
+        put(std::int32_t(pos.pos.y.v));
+    } else {
+        put(std::uint64_t(hnd.id()));
+    }
+}
+
+cell_h journal::take_cell() {
+    if (take<std::uint8_t>() == cell_cat::GRID_CELL) {
+        auto cat = grid_t(take<std::int8_t>());
+        auto x = take<std::int32_t>();
+        auto y = take<std::int32_t>();
+        return gcoords_t{ cat, x, y };
+    } else {
+        return cargo_h(take<std::uint64_t>());
+    }
+}
+
+bool_t journal::put_value(const value & val) {
+    switch (val.type()) {
+        case datatype::BOOLEAN:
+        case datatype::INTEGER:
+        case datatype::UNSIGNED:
+        case datatype::DOUBLE:
+        case datatype::STRING:
+        case datatype::C_COORDINATES:
+        case datatype::D_COORDINATES:
+        case datatype::DIRECTION:
+        case datatype::COLOR:
+        case datatype::HASH: {
+            put(std::uint8_t(val.type()));
+            break;
+        }
+        default: {
+            return false;
+        }
+    }
+    switch (val.type()) {
+        case datatype::BOOLEAN: {
+            put(std::uint8_t(get<bool_t>(val)));
+            break;
+        }
+        case datatype::INTEGER: {
+            put(std::int64_t(get<int_t>(val)));
+            break;
+        }
+        case datatype::UNSIGNED: {
+            put(std::uint64_t(get<uint_t>(val)));
+            break;
+        }
+        case datatype::DOUBLE: {
+            put(get<double_t>(val));
+            break;
+        }
+        case datatype::STRING: {
+            auto & str = get<string_t>(val);
+            put(std::uint32_t(str.size()));
+            _frame.append(reinterpret_cast<const char *>(str.data()), str.size() * sizeof(char_t));
+            break;
+        }
+        case datatype::C_COORDINATES: {
+            auto & pos = get<ccoords_t>(val);
+            put(pos.x.v);
+            put(pos.y.v);
+            break;
+        }
+        case datatype::D_COORDINATES: {
+            auto & pos = get<dcoords_t>(val);
+            put(std::int64_t(pos.x.v));
+            put(std::int64_t(pos.y.v));
+            break;
+        }
+        case datatype::DIRECTION: {
+            put(std::int64_t(get<direction_t>(val)));
+            break;
+        }
+        case datatype::COLOR: {
+            auto & c = get<color_t>(val);
+            put(c.r);
+            put(c.g);
+            put(c.b);
+            put(c.a);
+            break;
+        }
+        default: {
+            put(std::uint64_t(get<part_h>(val)));
+            break;
+        }
+    }
+    return true;
+}
+
+value journal::take_value() {
+    switch (datatype(take<std::uint8_t>())) {
+        case datatype::BOOLEAN: {
+            return value(bool_t(take<std::uint8_t>()));
+        }
+        case datatype::INTEGER: {
+            return value(int_t(take<std::int64_t>()));
+        }
+        case datatype::UNSIGNED: {
+            return value(uint_t(take<std::uint64_t>()));
+        }
+        case datatype::DOUBLE: {
+            return value(take<double_t>());
+        }
+        case datatype::STRING: {
+            string_t str(take<std::uint32_t>(), char_t());
+            _in->read(reinterpret_cast<char *>(str.data()), str.size() * sizeof(char_t));
+            return value(std::move(str));
+        }
+        case datatype::C_COORDINATES: {
+            auto x = take<double_t>();
+            auto y = take<double_t>();
+            return value(ccoords_t(x, y));
+        }
+        case datatype::D_COORDINATES: {
+            auto x = take<std::int64_t>();
+            auto y = take<std::int64_t>();
+            return value(dcoords_t(x, y));
+        }
+        case datatype::DIRECTION: {
+            return value(direction_t(take<std::int64_t>()));
+        }
+        case datatype::COLOR: {
+            color_t c;
+            c.r = take<std::uint8_t>();
+            c.g = take<std::uint8_t>();
+            c.b = take<std::uint8_t>();
+            c.a = take<std::uint8_t>();
+            return value(c);
+        }
+        case datatype::HASH: {
+            return value(part_h(take<std::uint64_t>()));
+        }
+        default: {
+            raise(std::runtime_error("journal::take_value: unknown datatype"));
+            return value();
+        }
+    }
+}
+
+void journal::advance() {
+    auto cycle = take<std::uint64_t>();
+    _next = _in->good() ? uint_t(cycle) : NEVER;
+}
+
+bool_t journal::exists(const world & world, const cell_h & hnd) {
+    switch (hnd.index()) {
+        case cell_cat::GRID_CELL: {
+            auto & pos = hnd.coords();
+            auto & grid = pos.cat == grid_t::MODEL_GRID ? world.get_model() : world.get_bank();
+            return pos.cat != grid_t::INVALID_GRID && pos.pos.in(grid.dim());
+        }
+        case cell_cat::CARGO_CELL: {
+            return world.cargo().count(hnd.id());
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+void journal::record(std::ostream & os) {
+    _out = &os;
+    _out->write(MAGIC.data(), MAGIC.size());
+    auto version = VERSION;
+    _out->write(reinterpret_cast<const char *>(&version), sizeof(version));
+}
+
+void journal::replay(std::istream & is) {
+    _in = &is;
+    std::array<char, 4> magic{ };
+    _in->read(magic.data(), magic.size());
+    auto version = take<std::uint16_t>();
+    if (!_in->good() || magic != MAGIC || version != VERSION) {
+        _in = nullptr;
+        raise(std::runtime_error("journal::replay: not a log of version " + std::to_string(VERSION)));
+    }
+    advance();
+}
+
+bool_t journal::recording() const {
+    return _out;
+}
+
+bool_t journal::replaying() const {
+    return _in && _next != NEVER;
+}
+
+void journal::write(uint_t cycle, const context & ctx, const world & world) {
+    _frame.clear();
+    _records = 0u;
+    for (auto & hnd : ctx.changed()) {
+        if (!exists(world, hnd)) {
+            continue;
+        }
+        world.at(hnd).for_each_intermediate([&](of id, const value & val) {
+            auto rewind = _frame.size();
+            put(change::PROPERTY);
+            put_cell(hnd);
+            put(std::uint64_t(id));
+            if (put_value(val)) {
+                ++_records;
+            } else {
+                _frame.resize(rewind);
+            }
+        });
+    }
+    for (auto & conn : ctx.connected()) {
+        put(change::CONNECT);
+        put_cell(conn.base.get().position());
+        put(std::int64_t(conn.use));
+        put_cell(conn.pos);
+        ++_records;
+    }
+    for (auto & conn : ctx.disconnected()) {
+        put(change::DISCONNECT);
+        put_cell(conn.base.get().position());
+        put(std::int64_t(conn.use));
+        ++_records;
+    }
+
+    if (_records) {
+        auto num = std::uint64_t(cycle);
+        _out->write(reinterpret_cast<const char *>(&num), sizeof(num));
+        _out->write(reinterpret_cast<const char *>(&_records), sizeof(_records));
+        _out->write(_frame.data(), _frame.size());
+    }
+}
+
+bool_t journal::apply(uint_t cycle, context & ctx, world & world) {
+    bool_t applied = false;
+    //Frames of cycles that were skipped are applied late rather than never
+    while (replaying() && _next <= cycle) {
+        auto records = take<std::uint32_t>();
+        for (std::uint32_t i = 0u; i < records && _in->good(); ++i) {
+            auto kind = change(take<std::uint8_t>());
+            auto hnd = take_cell();
+            switch (kind) {
+                case change::PROPERTY: {
+                    auto id = of(take<std::uint64_t>());
+                    auto val = take_value();
+                    if (exists(world, hnd)) {
+                        auto & clb = world.at(hnd);
+                        if (clb.has(id) && clb.get(id).type() == val.type()) {
+                            clb.set(id, std::move(val));
+                            ctx.change(hnd);
+                            auto & visual = clb.logic().visual();
+                            if (visual.find(id) != visual.end()) {
+                                ctx.draw(hnd);
+                            }
+                        }
+                    }
+                    break;
+                }
+                case change::CONNECT: {
+                    auto use = direction_t(take<std::int64_t>());
+                    auto to = take_cell();
+                    if (hnd.index() == cell_cat::GRID_CELL && exists(world, hnd) && exists(world, to)) {
+                        ctx.connect(unresolved_connection{ world.at(hnd.coords()), use, to.coords() });
+                    }
+                    break;
+                }
+                case change::DISCONNECT: {
+                    auto use = direction_t(take<std::int64_t>());
+                    if (hnd.index() == cell_cat::GRID_CELL && exists(world, hnd)) {
+                        ctx.disconnect(unresolved_connection{ world.at(hnd.coords()), use });
+                    }
+                    break;
+                }
+            }
+        }
+        applied = true;
+        advance();
+    }
+    return applied;
+}
+
+journal::~journal() = default;
+
+//endregion
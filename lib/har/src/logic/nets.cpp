@@ -0,0 +1,247 @@
+#include <cmath>
+#include <utility>
+
+#include <har/grid_cell.hpp>
+
+#include "logic/nets.hpp"
+
+using namespace har;
+
+//region nets
+
+nets::nets() : _parent(),
+               _members(),
+               _dirty(),
+               _floating(),
+               _endpoints(),
+               _valid(false) {
+
+}
+
+grid_cell_base * nets::root_of(grid_cell_base * gclb) {
+    auto it = _parent.find(gclb);
+    if (it == _parent.end()) {
+        _parent.emplace(gclb, gclb);
+        _members[gclb].emplace_back(gclb);
+        return gclb;
+    }
+    //Path halving keeps the trees flat without recursion
+    while (it->second != gclb) {
+        auto & grand = _parent[it->second];
+        it->second = grand;
+        gclb = grand;
+        it = _parent.find(gclb);
+    }
+    return gclb;
+}
+
+void nets::join(grid_cell_base * a, grid_cell_base * b) {
+    auto ra = root_of(a);
+    auto rb = root_of(b);
+    if (ra == rb) {
+        return;
+    }
+
+    //The smaller net is hung below the larger one
+    if (_members[ra].size() < _members[rb].size()) {
+        std::swap(ra, rb);
+    }
+    _parent[rb] = ra;
+    auto & members = _members[ra];
+    auto & joined = _members[rb];
+    members.insert(members.end(), joined.begin(), joined.end());
+    _members.erase(rb);
+}
+
+bool_t nets::conducts(const grid_cell_base & from, const grid_cell_base & to) {
+    return from.logic().joins_nets() && to.logic().joins_nets();
+}
+
+void nets::enlist(grid_cell_base & gclb) {
+    auto & pt = gclb.logic();
+    if (pt.in_net() && !pt.joins_nets()) {
+        _endpoints.emplace(&gclb);
+    } else {
+        _endpoints.erase(&gclb);
+    }
+}
+
+double_t nets::sensed_by(const grid_cell_base & gclb, map<grid_cell_base *, double_t> & voltages) {
+    auto voltage = std::nan("1");
+    auto sense_from = [&](grid_cell_base * cgclb) {
+        if (cgclb->logic().joins_nets()) {
+            //A cell outside of any net is a net of its own
+            auto net = _parent.count(cgclb) ? voltages[root_of(cgclb)] : drive_of(*cgclb);
+            if (!std::isnan(net) && !(net <= voltage)) {
+                voltage = net;
+            }
+        }
+    };
+    for (auto &[use, cgclb] : gclb.connected()) {
+        sense_from(&cgclb.get());
+    }
+    for (auto &[igclb, num] : gclb.iconnected()) {
+        sense_from(igclb);
+    }
+    return voltage;
+}
+
+double_t nets::drive_of(const grid_cell_base & gclb) {
+    auto id = gclb.logic().net_drive();
+    if (id != of::VOID && gclb.has(id)) {
+        return get<double_t>(gclb.get(id));
+    }
+    return std::nan("1");
+}
+
+void nets::join_connected(grid_cell_base & gclb) {
+    for (auto &[use, cgclb] : gclb.connected()) {
+        if (conducts(gclb, cgclb.get())) {
+            join(&gclb, &cgclb.get());
+        }
+    }
+    for (auto &[igclb, num] : gclb.iconnected()) {
+        if (conducts(gclb, *igclb)) {
+            join(&gclb, igclb);
+        }
+    }
+}
+
+void nets::partition() {
+    //Every member of a marked net is taken out and joined again by its current connections
+    set<grid_cell_base *> affected{ };
+    for (auto * gclb : _dirty) {
+        if (_parent.count(gclb)) {
+            auto root = root_of(gclb);
+            if (auto it = _members.find(root); it != _members.end()) {
+                affected.insert(it->second.begin(), it->second.end());
+                _members.erase(it);
+            }
+        } else {
+            affected.emplace(gclb);
+        }
+    }
+    _dirty.clear();
+
+    std::vector<grid_cell_base *> former{ };
+    for (auto * gclb : affected) {
+        if (_parent.erase(gclb)) {
+            former.emplace_back(gclb);
+        }
+    }
+    for (auto * gclb : affected) {
+        join_connected(*gclb);
+        enlist(*gclb);
+    }
+    for (auto * gclb : former) {
+        if (!_parent.count(gclb)) {
+            _floating.emplace_back(gclb);
+        }
+    }
+}
+
+void nets::sense(context & ctx, grid_cell_base & gclb, double_t voltage) {
+    auto id = gclb.logic().net_sense();
+    if (id == of::VOID || !gclb.has(id)) {
+        return;
+    }
+    auto before = get<double_t>(gclb.get(id));
+    if (before != voltage && !(std::isnan(before) && std::isnan(voltage))) {
+        grid_cell gcl{ ctx, gclb };
+        gcl[id] = voltage;
+    }
+}
+
+void nets::invalidate() {
+    _valid = false;
+}
+
+void nets::connect(grid_cell_base & from, grid_cell_base & to) {
+    if (_valid) {
+        if (conducts(from, to)) {
+            join(&from, &to);
+        }
+        enlist(from);
+        enlist(to);
+    }
+}
+
+void nets::disconnect(grid_cell_base & from, grid_cell_base & to) {
+    if (_valid) {
+        _dirty.emplace(&from);
+        _dirty.emplace(&to);
+    }
+}
+
+void nets::touch(grid_cell_base & gclb) {
+    //Only cells that are or become connected can change the nets
+    if (_valid && (_parent.count(&gclb) || _endpoints.count(&gclb) ||
+                   !gclb.connected().empty() || !gclb.iconnected().empty())) {
+        _dirty.emplace(&gclb);
+    }
+}
+
+void nets::settle(world & world) {
+    if (!_valid) {
+        _parent.clear();
+        _members.clear();
+        _dirty.clear();
+        _floating.clear();
+        _endpoints.clear();
+        for (grid * gd : { &world.get_model(), &world.get_bank() }) {
+            for (auto &[pos, gclb] : *gd) {
+                enlist(gclb);
+                for (auto &[use, cgclb] : gclb.connected()) {
+                    if (conducts(gclb, cgclb.get())) {
+                        join(&gclb, &cgclb.get());
+                    }
+                }
+            }
+        }
+        _valid = true;
+    } else if (!_dirty.empty()) {
+        partition();
+    }
+}
+
+void nets::resolve(context & ctx) {
+    map<grid_cell_base *, double_t> voltages{ };
+    for (auto &[root, members] : _members) {
+        double_t sum = 0.;
+        uint_t drivers = 0u;
+        for (auto * gclb : members) {
+            if (auto voltage = drive_of(*gclb); !std::isnan(voltage)) {
+                sum += voltage;
+                ++drivers;
+            }
+        }
+
+        auto voltage = drivers ? sum / double_t(drivers) : std::nan("1");
+        for (auto * gclb : members) {
+            sense(ctx, *gclb, voltage);
+        }
+        if (!_endpoints.empty()) {
+            voltages.emplace(root, voltage);
+        }
+    }
+
+    //Endpoints sense the nets they are connected to without joining them
+    for (auto * gclb : _endpoints) {
+        sense(ctx, *gclb, sensed_by(*gclb, voltages));
+    }
+
+    for (auto * gclb : _floating) {
+        sense(ctx, *gclb, std::nan("1"));
+    }
+    _floating.clear();
+}
+
+std::size_t nets::size() const {
+    return _members.size();
+}
+
+bool_t nets::joined(grid_cell_base & a, grid_cell_base & b) {
+    return _parent.count(&a) && _parent.count(&b) && root_of(&a) == root_of(&b);
+}
+
+//endregion
@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "logic/probe.hpp"
+
+using namespace har;
+
+double_t probe::value_of(const world & world, const target_t & target) {
+    auto &[pos, id] = target;
+    auto & grid = pos.cat == grid_t::MODEL_GRID ? world.get_model() : world.get_bank();
+    if (pos.cat == grid_t::INVALID_GRID || !pos.pos.in(grid.dim())) {
+        return std::numeric_limits<double_t>::quiet_NaN();
+    }
+    auto & gclb = grid.at(pos.pos);
+    if (!gclb.has(id)) {
+        return std::numeric_limits<double_t>::quiet_NaN();
+    }
+    auto & val = gclb.get(id);
+    switch (val.type()) {
+        case value::datatype::BOOLEAN:
+            return har::get<bool_t>(val) ? 1. : 0.;
+        case value::datatype::INTEGER:
+            return double_t(har::get<int_t>(val));
+        case value::datatype::UNSIGNED:
+            return double_t(har::get<uint_t>(val));
+        case value::datatype::DOUBLE:
+            return har::get<double_t>(val);
+        default:
+            return std::numeric_limits<double_t>::quiet_NaN();
+    }
+}
+
+probe::buffer::buffer(uint_t size) : size(size),
+                                     values(std::make_unique<std::atomic<double_t>[]>(size)) {
+
+}
+
+probe::trigger & probe::trigger_at(uint_t num) {
+    if (num >= MAX_TRIGGERS) {
+        raise(std::out_of_range("probe: no trigger with number " + std::to_string(num)));
+    }
+    return _triggers[num];
+}
+
+void probe::detect(const world & world) {
+    for (auto & t : _triggers) {
+        if (!t.armed) {
+            continue;
+        }
+        //NaN is never high
+        bool_t high = value_of(world, t.target) > t.threshold;
+        bool_t raised;
+        switch (t.kind) {
+            case edge::LEVEL_LOW:
+                raised = !high;
+                break;
+            case edge::BOTH:
+                raised = t.primed && high != t.high;
+                break;
+            case edge::FALL:
+                raised = t.primed && t.high && !high;
+                break;
+            case edge::RISE:
+                raised = t.primed && !t.high && high;
+                break;
+            default:
+                raised = false;
+                break;
+        }
+        if (raised) {
+            t.raised.fetch_add(1u, std::memory_order_acq_rel);
+        }
+        t.primed = true;
+        t.high = high;
+    }
+}
+
+probe::probe() : _probex(),
+                 _targets(),
+                 _buffers(),
+                 _sequence(0u),
+                 _published(nullptr),
+                 _triggers() {
+
+}
+
+void probe::set_targets(const std::vector<target_t> & targets) {
+    std::scoped_lock lock{ _probex };
+    _targets = targets;
+}
+
+void probe::publish(const world & world) {
+    std::scoped_lock lock{ _probex };
+    detect(world);
+    if (_targets.empty() && (_buffers.empty() || _buffers.back()->size == 0u)) {
+        return;
+    }
+
+    if (_buffers.empty() || _buffers.back()->size != _targets.size()) {
+        _buffers.emplace_back(std::make_unique<buffer>(_targets.size()));
+    }
+    auto & buf = *_buffers.back();
+
+    auto seq = _sequence.load(std::memory_order_relaxed);
+    _sequence.store(seq + 1u, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    _published.store(&buf, std::memory_order_release);
+    for (uint_t i = 0; i < buf.size; ++i) {
+        buf.values[i].store(value_of(world, _targets[i]), std::memory_order_relaxed);
+    }
+    _sequence.store(seq + 2u, std::memory_order_release);
+}
+
+uint_t probe::read(span<double_t> values) const {
+    while (true) {
+        auto seq = _sequence.load(std::memory_order_acquire);
+        if (seq & 1u) {
+            std::this_thread::yield();
+            continue;
+        }
+        //A buffer never changes its length, so the copy stays within it even if it was replaced meanwhile
+        auto * published = _published.load(std::memory_order_acquire);
+        auto size = published ? std::min<uint_t>(published->size, values.size()) : 0u;
+        for (uint_t i = 0; i < size; ++i) {
+            values[i] = published->values[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (_sequence.load(std::memory_order_relaxed) == seq) {
+            std::fill(values.begin() + size, values.end(), std::numeric_limits<double_t>::quiet_NaN());
+            return seq / 2u;
+        }
+    }
+}
+
+void probe::set_trigger(uint_t num, const target_t & target, edge kind, double_t threshold) {
+    std::scoped_lock lock{ _probex };
+    auto & t = trigger_at(num);
+    t.target = target;
+    t.kind = kind;
+    t.threshold = threshold;
+    t.armed = true;
+    t.primed = false;
+    t.raised.store(0u, std::memory_order_release);
+}
+
+void probe::clear_trigger(uint_t num) {
+    std::scoped_lock lock{ _probex };
+    auto & t = trigger_at(num);
+    t.armed = false;
+    t.raised.store(0u, std::memory_order_release);
+}
+
+uint_t probe::take_trigger(uint_t num) {
+    return trigger_at(num).raised.exchange(0u, std::memory_order_acq_rel);
+}
+
+probe::~probe() = default;
@@ -109,6 +109,30 @@ void process_tab::remove(const gcoords_t & pos) {
     _inactive.erase(pos);
 }
 
+void process_tab::clear() {
+    _active.clear();
+    _waking.clear();
+    _tiring.clear();
+    _starting.clear();
+    _halting.clear();
+    _inactive.clear();
+}
+
+void process_tab::rebind(grid_t grid, const std::function<cell_base &(const gcoords_t &)> & at) {
+    for (auto &[pos, tab] : _active) {
+        if (pos.cat == grid) {
+            tab.cell = at(pos);
+        }
+    }
+    for (auto * cells : { &_waking, &_tiring, &_starting, &_halting, &_inactive }) {
+        for (auto &[pos, clb] : *cells) {
+            if (pos.cat == grid) {
+                clb = at(pos);
+            }
+        }
+    }
+}
+
 size_t process_tab::size() const {
     return _active.size() + _inactive.size();
 }
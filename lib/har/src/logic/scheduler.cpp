@@ -0,0 +1,83 @@
+#include <algorithm>
+
+#include "logic/scheduler.hpp"
+
+using namespace har;
+
+scheduler::scheduler(ushort_t workers) : _workers(std::max<ushort_t>(workers, 1u)),
+                                         _queues(new queue[_workers]),
+                                         _size(0u),
+                                         _chunk(CHUNK_SIZE) {
+    for (ushort_t i = 0; i < _workers; ++i) {
+        _queues[i].range.store(pack(0u, 0u), std::memory_order_relaxed);
+    }
+    reset_stats();
+}
+
+bool_t scheduler::pop(ushort_t worker, uint_t & chunk) {
+    auto & range = _queues[worker].range;
+    auto r = range.load(std::memory_order_acquire);
+    std::uint32_t first, last;
+    do {
+        first = std::uint32_t(r);
+        last = std::uint32_t(r >> 32u);
+        if (first >= last) {
+            return false;
+        }
+    } while (!range.compare_exchange_weak(r, pack(first + 1u, last), std::memory_order_acq_rel));
+    chunk = first;
+    return true;
+}
+
+bool_t scheduler::steal(ushort_t worker, uint_t & chunk) {
+    for (ushort_t i = 1; i < _workers; ++i) {
+        auto & range = _queues[(worker + i) % _workers].range;
+        auto r = range.load(std::memory_order_acquire);
+        std::uint32_t first, last;
+        do {
+            first = std::uint32_t(r);
+            last = std::uint32_t(r >> 32u);
+        } while (first < last && !range.compare_exchange_weak(r, pack(first, last - 1u), std::memory_order_acq_rel));
+        if (first < last) {
+            chunk = last - 1u;
+            return true;
+        }
+    }
+    return false;
+}
+
+void scheduler::distribute(uint_t size) {
+    _size = size;
+    _chunk = std::clamp<uint_t>(size / (_workers * CHUNKS_PER_WORKER), 1u, CHUNK_SIZE);
+
+    uint_t chunks = (size + _chunk - 1u) / _chunk;
+    for (ushort_t i = 0; i < _workers; ++i) {
+        auto first = std::uint32_t(std::uint64_t(chunks) * i / _workers);
+        auto last = std::uint32_t(std::uint64_t(chunks) * (i + 1u) / _workers);
+        _queues[i].range.store(pack(first, last), std::memory_order_release);
+    }
+}
+
+void scheduler::settle() {
+    auto now = clock::now();
+    for (ushort_t i = 0; i < _workers; ++i) {
+        auto & q = _queues[i];
+        q.stats.idle += std::chrono::duration_cast<std::chrono::nanoseconds>(now - q.finished);
+    }
+}
+
+const scheduler::worker_stats & scheduler::stats_of(ushort_t worker) const {
+    return _queues[worker].stats;
+}
+
+ushort_t scheduler::workers() const {
+    return _workers;
+}
+
+void scheduler::reset_stats() {
+    for (ushort_t i = 0; i < _workers; ++i) {
+        _queues[i].stats = worker_stats{ 0u, 0u, std::chrono::nanoseconds(0) };
+    }
+}
+
+scheduler::~scheduler() = default;
@@ -0,0 +1,21 @@
+#include "logic/viewport.hpp"
+
+using namespace har;
+
+viewport::area_t & viewport::area(grid_t grid) {
+    return areas[grid == grid_t::MODEL_GRID ? 0u : 1u];
+}
+
+bool_t viewport::contains(const cell_h & hnd) const {
+    if (!drawing) {
+        return false;
+    } else if (hnd.index() != cell_cat::GRID_CELL) {
+        return true;
+    }
+    auto & pos = hnd.coords();
+    if (pos.cat == grid_t::INVALID_GRID) {
+        return false;
+    }
+    auto & area = areas[pos.cat == grid_t::MODEL_GRID ? 0u : 1u];
+    return !area || pos.pos.in(area->first, area->second);
+}
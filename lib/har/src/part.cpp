@@ -3,6 +3,8 @@
 //
 
 #include <iomanip>
+#include <stdexcept>
+#include <string>
 #include <utility>
 
 #include <har/part.hpp>
@@ -344,6 +346,16 @@ part::part(part_h id,
                                      _traits(traits),
                                      _model(),
                                      _conn_use(),
+                                     _visual(),
+                                     _waking(),
+                                     _layout(),
+                                     _slots(),
+                                     _field(of::VOID),
+                                     _net_drive(of::VOID),
+                                     _net_sense(of::VOID),
+                                     _netted(false),
+                                     _joining(false),
+                                     _shared_images(false),
                                      delegates() {
 
 }
@@ -356,6 +368,14 @@ part::part(const part & ref) : _id(ref._id),
                                _conn_use(ref._conn_use),
                                _visual(ref._visual),
                                _waking(ref._waking),
+                               _layout(ref._layout),
+                               _slots(ref._slots),
+                               _field(ref._field),
+                               _net_drive(ref._net_drive),
+                               _net_sense(ref._net_sense),
+                               _netted(ref._netted),
+                               _joining(ref._joining),
+                               _shared_images(ref._shared_images),
                                delegates(ref.delegates) {
 
 }
@@ -368,6 +388,14 @@ part::part(part && fref) noexcept: _id(fref._id),
                                    _conn_use(std::move(fref._conn_use)),
                                    _visual(std::move(fref._visual)),
                                    _waking(std::move(fref._waking)),
+                                   _layout(std::move(fref._layout)),
+                                   _slots(std::move(fref._slots)),
+                                   _field(fref._field),
+                                   _net_drive(fref._net_drive),
+                                   _net_sense(fref._net_sense),
+                                   _netted(fref._netted),
+                                   _joining(fref._joining),
+                                   _shared_images(fref._shared_images),
                                    delegates(std::move(fref.delegates)) {
 
 }
@@ -392,11 +420,25 @@ traits_h part::traits() const {
     return _traits;
 }
 
+void part::assign_slot(of id) {
+    if (uint_t(id) < MAX_SLOTTED_ID) {
+        if (uint_t(id) >= _slots.size()) {
+            _slots.resize(uint_t(id) + 1u, NO_SLOT);
+        }
+        if (_slots[id] == NO_SLOT) {
+            _slots[id] = ushort_t(_layout.size());
+            _layout.emplace_back(id);
+        }
+    }
+}
+
 const entry & part::add_entry(const entry & e) {
+    assign_slot(e.id);
     return _model.insert_or_assign(e.id, e).first->second;
 }
 
 const entry & part::add_entry(entry && e) {
+    assign_slot(e.id);
     return _model.insert_or_assign(e.id, std::forward<entry>(e)).first->second;
 }
 
@@ -409,6 +451,10 @@ const property_model & part::model() const {
     return _model;
 }
 
+const decltype(part::_layout) & part::layout() const {
+    return _layout;
+}
+
 void part::add_connection_use(direction_t dir, string_t name) {
     _conn_use.insert_or_assign(dir, name);
 }
@@ -445,6 +491,14 @@ const decltype(part::_visual) & part::visual() const {
     return _visual;
 }
 
+void part::set_shared_images(bool_t shared) {
+    _shared_images = shared;
+}
+
+bool_t part::shares_images() const {
+    return _shared_images;
+}
+
 void part::add_waking(entry_h id) {
     _waking.insert(id);
 }
@@ -463,6 +517,61 @@ const decltype(part::_waking) & part::waking() const {
     return _waking;
 }
 
+/// \brief Raises, unless a property of a part is slotted and holds values of type <tt>T</tt>
+template<typename T>
+void check_slotted(const part & pt, of id, const char * fun) {
+    if (pt.slot_of(id) == part::NO_SLOT || !pt.model().count(id) ||
+        pt.model().at(id).type_and_default.typed_index() != type_index<T>()) {
+        raise(std::invalid_argument(std::string(fun) + ": property " + std::to_string(uint_t(id)) +
+                                    " of part " + std::string(pt.unique_name().begin(), pt.unique_name().end()) +
+                                    " is not slotted or of another type"));
+    }
+}
+
+void part::set_field(of id, field_kernel<bool_t> kernel) {
+    check_slotted<bool_t>(*this, id, "har::part::set_field");
+    _field = id;
+    delegates.cycle_field = std::move(kernel);
+}
+
+void part::set_field(of id, field_kernel<double_t> kernel) {
+    check_slotted<double_t>(*this, id, "har::part::set_field");
+    _field = id;
+    delegates.cycle_field = std::move(kernel);
+}
+
+of part::field_id() const {
+    return _field;
+}
+
+void part::set_net(of drive, of sense, bool_t joining) {
+    for (auto id : { drive, sense }) {
+        if (id != of::VOID) {
+            check_slotted<double_t>(*this, id, "har::part::set_net");
+        }
+    }
+    _net_drive = joining ? drive : of::VOID;
+    _net_sense = sense;
+    _netted = true;
+    _joining = joining;
+}
+
+bool_t part::in_net() const {
+    return _netted;
+}
+
+bool_t part::joins_nets() const {
+    return _joining;
+}
+
+of part::net_drive() const {
+    return _net_drive;
+}
+
+of part::net_sense() const {
+    return _net_sense;
+}
+
 void part::init_standard(cell_base & cell) const {
     for (auto & e : _model) {
         cell.set(e.first, e.second.standard_value());
@@ -511,6 +620,36 @@ void part::cycle(cell & cl) const {
     }
 }
 
+void part::cycle(cell_batch & cells) const {
+    if (delegates.cycle_batch) {
+        TRY_CATCH({
+                      delegates.cycle_batch(cells);
+                  }, (std::exception & e), {
+                      raise(delegate_error("har::part::cycle", e));
+                  })
+    }
+}
+
+void part::cycle(const field<bool_t> & in, field<bool_t> & out) const {
+    if (auto kernel = std::get_if<field_kernel<bool_t>>(&delegates.cycle_field)) {
+        TRY_CATCH({
+                      (*kernel)(in, out);
+                  }, (std::exception & e), {
+                      raise(delegate_error("har::part::cycle", e));
+                  })
+    }
+}
+
+void part::cycle(const field<double_t> & in, field<double_t> & out) const {
+    if (auto kernel = std::get_if<field_kernel<double_t>>(&delegates.cycle_field)) {
+        TRY_CATCH({
+                      (*kernel)(in, out);
+                  }, (std::exception & e), {
+                      raise(delegate_error("har::part::cycle", e));
+                  })
+    }
+}
+
 void part::move(cell & cl) const {
     if (delegates.move) {
         TRY_CATCH({
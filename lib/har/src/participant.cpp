@@ -38,6 +38,42 @@ void participant::select(const cell_h & hnd) {
     _iparti->select(hnd);
 }
 
+void participant::set_viewport(grid_t grid, const dcoords_t & from, const dcoords_t & to) {
+    _iparti->set_viewport(grid, from, to);
+}
+
+void participant::reset_viewport(grid_t grid) {
+    _iparti->reset_viewport(grid);
+}
+
+void participant::set_drawing(bool_t drawing) {
+    _iparti->do_draw(drawing);
+}
+
+void participant::set_cycling(bool_t cycling) {
+    _iparti->do_cycle(cycling);
+}
+
+void participant::set_probes(const std::vector<std::pair<gcoords_t, entry_h>> & probes) {
+    _iparti->get_probe().set_targets(probes);
+}
+
+uint_t participant::read_probes(span<double_t> values) const {
+    return _iparti->get_probe().read(values);
+}
+
+void participant::set_trigger(uint_t num, const std::pair<gcoords_t, entry_h> & target, edge kind, double_t threshold) {
+    _iparti->get_probe().set_trigger(num, target, kind, threshold);
+}
+
+void participant::clear_trigger(uint_t num) {
+    _iparti->get_probe().clear_trigger(num);
+}
+
+uint_t participant::take_trigger(uint_t num) {
+    return _iparti->get_probe().take_trigger(num);
+}
+
 void participant::include_part(const part & pt) {
     _iparti->include_part(pt);
 }
@@ -54,6 +90,10 @@ void participant::load_model(istream & is) {
     _iparti->load_model(is);
 }
 
+void participant::load_model(const std::filesystem::path & path) {
+    _iparti->load_model(path);
+}
+
 void participant::store_model(string_t & ser) {
     _iparti->store_model(ser);
 }
@@ -62,10 +102,38 @@ void participant::store_model(ostream & os) {
     _iparti->store_model(os);
 }
 
+void participant::store_model(ostream & os, model_format format) {
+    _iparti->store_model(os, format);
+}
+
 void participant::redraw_all() {
     _iparti->redraw_all();
 }
 
+bool_t participant::wants_images() const {
+    return true;
+}
+
+std::optional<image_t> participant::find_image(const cell_h & hnd, const look_t & look) {
+    return std::nullopt;
+}
+
+void participant::keep_image(const cell_h & hnd, const look_t & look, const image_t & img) {
+
+}
+
+void participant::on_selection_update_batch(span<const update_t> batch) {
+    for (auto &[hnd, id, val] : batch) {
+        on_selection_update(hnd, id, val, false);
+    }
+}
+
+void participant::on_redraw_batch(span<redraw_t> batch) {
+    for (auto &[hnd, img] : batch) {
+        on_redraw(hnd, std::move(img), false);
+    }
+}
+
 bool_t participant::attached() const {
     return _iparti;
 }
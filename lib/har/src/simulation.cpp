@@ -46,6 +46,34 @@ void simulation::commence() {
     _isim->commence();
 }
 
+void simulation::set_sparse(bool_t sparse) {
+    auto & atm = _isim->get_automaton();
+    atm.begin();
+    atm.set_schedule(sparse ? automaton::schedule::SPARSE : automaton::schedule::DENSE);
+    atm.end();
+}
+
+void simulation::set_batched(bool_t batched) {
+    auto & atm = _isim->get_automaton();
+    atm.begin();
+    atm.set_batched(batched);
+    atm.end();
+}
+
+void simulation::record(std::ostream & os) {
+    auto & atm = _isim->get_automaton();
+    atm.begin();
+    atm.get_journal().record(os);
+    atm.end();
+}
+
+void simulation::replay(std::istream & is) {
+    auto & atm = _isim->get_automaton();
+    atm.begin();
+    atm.get_journal().replay(is);
+    atm.end();
+}
+
 simulation & simulation::operator=(simulation && fref) noexcept = default;
 
 simulation::~simulation() = default;
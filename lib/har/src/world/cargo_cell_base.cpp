@@ -20,6 +20,7 @@ cargo_cell_base::cargo_cell_base(cargo_h id, const part & part, ccoords_t pos, c
         _position(std::move(pos)),
         _size(std::move(size)),
         _radius(std::move(radius)),
+        _move_delta(),
         _valid(true),
         _overlays() {
 
@@ -31,6 +32,7 @@ cargo_cell_base::cargo_cell_base(cargo_h id, const cell_base & cl, ccoords_t pos
         _position(pos),
         _size(std::move(size)),
         _radius(std::move(radius)),
+        _move_delta(),
         _valid(true),
         _overlays() {
 
@@ -41,6 +43,7 @@ cargo_cell_base::cargo_cell_base(cargo_cell_base && fref) noexcept: cell_base(st
                                                                     _position(fref._position),
                                                                     _size(fref._size),
                                                                     _radius(fref._radius),
+                                                                    _move_delta(fref._move_delta),
                                                                     _valid(fref._valid),
                                                                     _overlays(std::move(fref._overlays)) {
     for (auto & o : _overlays) {
@@ -71,6 +74,14 @@ ccoords_t cargo_cell_base::move_delta() const {
     return _move_delta;
 }
 
+ccoords_t cargo_cell_base::take_move_delta() {
+    return std::exchange(_move_delta, ccoords_t());
+}
+
+const decltype(cargo_cell_base::_overlays) & cargo_cell_base::overlays() const {
+    return _overlays;
+}
+
 void cargo_cell_base::move_by(ccoords_t delta) {
     _move_delta += delta;
 }
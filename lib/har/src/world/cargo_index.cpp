@@ -0,0 +1,46 @@
+#include "world/cargo_index.hpp"
+
+using namespace har;
+
+cargo_index::cargo_index() : _dim(),
+                             _starts(),
+                             _entries() {
+
+}
+
+uint_t cargo_index::bucket_of(const ccoords_t & pos) const {
+    auto x = int_t(std::clamp(std::floor(pos.x.v), 0., double_t(_dim.x.v - 1)));
+    auto y = int_t(std::clamp(std::floor(pos.y.v), 0., double_t(_dim.y.v - 1)));
+    return uint_t(y * _dim.x.v + x);
+}
+
+void cargo_index::rebuild(const dcoords_t & dim, uint_t size, const std::function<ccoords_t(uint_t)> & position_of) {
+    _dim = dim;
+    _entries.clear();
+    if (size == 0u || dim.x.v <= 0 || dim.y.v <= 0) {
+        _starts.clear();
+        return;
+    }
+
+    //Counting sort by bucket
+    std::vector<uint_t> buckets(size);
+    _starts.assign(uint_t(dim.x.v * dim.y.v) + 1u, 0u);
+    for (uint_t i = 0; i < size; ++i) {
+        buckets[i] = bucket_of(position_of(i));
+        ++_starts[buckets[i] + 1u];
+    }
+    for (uint_t b = 1; b < _starts.size(); ++b) {
+        _starts[b] += _starts[b - 1u];
+    }
+    _entries.resize(size);
+    std::vector<uint_t> fill(_starts.begin(), _starts.end() - 1);
+    for (uint_t i = 0; i < size; ++i) {
+        _entries[fill[buckets[i]]++] = i;
+    }
+}
+
+uint_t cargo_index::size() const {
+    return uint_t(_entries.size());
+}
+
+cargo_index::~cargo_index() = default;
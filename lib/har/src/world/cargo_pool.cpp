@@ -0,0 +1,204 @@
+#include <stdexcept>
+
+#include "world/cargo_pool.hpp"
+
+using namespace har;
+
+cargo_pool::cargo_pool() : _blocks(new std::unique_ptr<slot[]>[MAX_SLOTS / BLOCK_SIZE]),
+                           _slots(0u),
+                           _free(),
+                           _dense(),
+                           _poolex() {
+
+}
+
+cargo_pool::cargo_pool(cargo_pool && fref) noexcept: _blocks(std::move(fref._blocks)),
+                                                      _slots(fref._slots.load(std::memory_order_acquire)),
+                                                      _free(std::move(fref._free)),
+                                                      _dense(std::move(fref._dense)),
+                                                      _poolex() {
+    fref._slots.store(0u, std::memory_order_release);
+}
+
+cargo_pool::slot * cargo_pool::lookup(cargo_h num) const {
+    auto index = index_of(num);
+    //Slots are taken concurrently, the count is only raised once the block of a slot is set up
+    if (uint_t(num) >= (uint_t(1u) << (SLOT_BITS + GENERATION_BITS)) ||
+        index >= _slots.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    auto & s = slot_at(index);
+    if (s.state == slot_state::FREE || s.generation != generation_of(num)) {
+        return nullptr;
+    }
+    return &s;
+}
+
+uint_t cargo_pool::take() {
+    std::lock_guard lock{ _poolex };
+    if (!_free.empty()) {
+        auto index = _free.back();
+        _free.pop_back();
+        return index;
+    }
+    auto slots = _slots.load(std::memory_order_relaxed);
+    if (slots == MAX_SLOTS) {
+        raise(std::length_error("cargo_pool::take: too much cargo"));
+    }
+    if (slots % BLOCK_SIZE == 0u) {
+        auto & block = _blocks[slots / BLOCK_SIZE];
+        block.reset(new slot[BLOCK_SIZE]);
+        for (uint_t i = 0; i < BLOCK_SIZE; ++i) {
+            block[i].generation = 0u;
+            block[i].dense = NONE;
+            block[i].state = slot_state::FREE;
+        }
+    }
+    _slots.store(slots + 1u, std::memory_order_release);
+    return slots;
+}
+
+void cargo_pool::destroy() {
+    auto slots = _slots.load(std::memory_order_acquire);
+    for (uint_t i = 0; i < slots; ++i) {
+        auto & s = slot_at(i);
+        if (s.state != slot_state::FREE) {
+            s.cargo().~cargo_cell_base();
+            s.state = slot_state::FREE;
+            s.dense = NONE;
+        }
+    }
+}
+
+cargo_cell_base & cargo_pool::reserve(const part & pt, const ccoords_t & pos) {
+    auto index = take();
+    auto & s = slot_at(index);
+    new(&s.storage) cargo_cell_base(handle_of(index, s.generation), pt, pos);
+    s.state = slot_state::RESERVED;
+    return s.cargo();
+}
+
+cargo_cell_base & cargo_pool::reserve(cargo_cell_base && cclb) {
+    auto index = take();
+    auto & s = slot_at(index);
+    auto & cargo = *new(&s.storage) cargo_cell_base(std::forward<cargo_cell_base>(cclb));
+    cargo._id = handle_of(index, s.generation);
+    s.state = slot_state::RESERVED;
+    return cargo;
+}
+
+cargo_cell_base & cargo_pool::admit(cargo_h num) {
+    auto * s = lookup(num);
+    if (!s) {
+        raise(std::out_of_range("cargo_pool::admit: no reserved cargo"));
+    }
+    if (s->state == slot_state::RESERVED) {
+        s->dense = uint_t(_dense.size());
+        s->state = slot_state::ADMITTED;
+        _dense.emplace_back(index_of(num));
+    }
+    return s->cargo();
+}
+
+bool_t cargo_pool::release(cargo_h num) {
+    auto * s = lookup(num);
+    if (!s) {
+        return false;
+    }
+    if (s->state == slot_state::ADMITTED) {
+        //Swaps the last admitted cargo into the gap
+        auto moved = _dense.back();
+        _dense[s->dense] = moved;
+        slot_at(moved).dense = s->dense;
+        _dense.pop_back();
+    }
+    s->cargo().~cargo_cell_base();
+    s->state = slot_state::FREE;
+    s->dense = NONE;
+    //Handles of the next generation never collide with the invalid handle
+    do {
+        s->generation = (s->generation + 1u) & ((1u << GENERATION_BITS) - 1u);
+    } while (handle_of(index_of(num), s->generation) == CARGO[-1]);
+    std::lock_guard lock{ _poolex };
+    _free.emplace_back(index_of(num));
+    return true;
+}
+
+cargo_cell_base * cargo_pool::find(cargo_h num) const {
+    auto * s = lookup(num);
+    return s && s->state == slot_state::ADMITTED ? &s->cargo() : nullptr;
+}
+
+cargo_cell_base & cargo_pool::at(cargo_h num) const {
+    auto * s = lookup(num);
+    if (!s) {
+        raise(std::out_of_range("cargo_pool::at: no cargo with handle " + std::to_string(uint_t(num))));
+    }
+    return s->cargo();
+}
+
+uint_t cargo_pool::count(cargo_h num) const {
+    return find(num) ? 1u : 0u;
+}
+
+uint_t cargo_pool::size() const {
+    return uint_t(_dense.size());
+}
+
+bool_t cargo_pool::empty() const {
+    return _dense.empty();
+}
+
+cargo_cell_base & cargo_pool::nth(uint_t index) const {
+    return slot_at(_dense[index]).cargo();
+}
+
+uint_t cargo_pool::capacity() const {
+    return _slots.load(std::memory_order_acquire);
+}
+
+void cargo_pool::clear() {
+    auto slots = _slots.load(std::memory_order_acquire);
+    for (uint_t i = 0; i < slots; ++i) {
+        auto & s = slot_at(i);
+        if (s.state != slot_state::FREE) {
+            release(handle_of(i, s.generation));
+        }
+    }
+}
+
+cargo_pool::iterator cargo_pool::begin() {
+    return iterator(*this, _dense.cbegin());
+}
+
+cargo_pool::const_iterator cargo_pool::begin() const {
+    return const_iterator(*this, _dense.cbegin());
+}
+
+cargo_pool::iterator cargo_pool::end() {
+    return iterator(*this, _dense.cend());
+}
+
+cargo_pool::const_iterator cargo_pool::end() const {
+    return const_iterator(*this, _dense.cend());
+}
+
+cargo_pool & cargo_pool::operator=(cargo_pool && fref) noexcept {
+    if (this != &fref) {
+        if (_blocks) {
+            destroy();
+        }
+        _blocks = std::move(fref._blocks);
+        _slots.store(fref._slots.load(std::memory_order_acquire), std::memory_order_release);
+        _free = std::move(fref._free);
+        _dense = std::move(fref._dense);
+        fref._slots.store(0u, std::memory_order_release);
+    }
+    return *this;
+}
+
+cargo_pool::~cargo_pool() {
+    if (_blocks) {
+        destroy();
+    }
+}
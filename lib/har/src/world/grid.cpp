@@ -2,6 +2,8 @@
 // Created by Johannes on 10.06.2020.
 //
 
+#include <algorithm>
+
 #include "world/grid.hpp"
 
 using namespace har;
@@ -40,8 +42,8 @@ grid_t grid::cat() const {
 }
 
 grid_cell_base & grid::at(const har::dcoords_t & pos) {
-    if (pos.x < _size.x && pos.y < _size.y) {
-        return _data.at(pos);
+    if (pos.in(_size)) {
+        return _data[slot(pos)].second;
     } else {
         DEBUG_LOG("index " << pos << " exceeds the dimension of the grid (" << gcoords_t(_cat, _size) << ")");
         return grid_cell_base::invalid();
@@ -49,14 +51,22 @@ grid_cell_base & grid::at(const har::dcoords_t & pos) {
 }
 
 const grid_cell_base & grid::at(const har::dcoords_t & pos) const {
-    if (pos.x < _size.x && pos.y < _size.y) {
-        return _data.at(pos);
+    if (pos.in(_size)) {
+        return _data[slot(pos)].second;
     } else {
         DEBUG_LOG("index " << pos << " exceeds the dimension of the grid (" << gcoords_t(_cat, _size) << ")");
         return grid_cell_base::invalid();
     }
 }
 
+grid_cell_base & grid::nth(uint_t n) {
+    return _data[n].second;
+}
+
+const grid_cell_base & grid::nth(uint_t n) const {
+    return _data[n].second;
+}
+
 dcoords_t grid::dim() const {
     return _size;
 }
@@ -69,40 +79,56 @@ const string_t & grid::title() const {
     return _title;
 }
 
-void grid::insert_column(const part & pt) {
-    insert_column(pt, _size.x);
-}
-
-void grid::insert_column(const part & pt, const dcoord_t & x) {
-    //Alte Spalten verschieben
-    for (dcoord_t ix = _size.x; ix > x; --ix) {
-        for (dcoord_t iy = 0; iy < _size.y; ++iy) {
-            auto npos = (ix, iy);
-            auto pair = _data.extract((ix - 1, iy));
-            pair.key() = npos;
-            auto & c = _data.insert(std::move(pair)).position->second;
-            c.move_to(npos);
+template<typename F>
+void grid::reshape(const part & pt, const dcoords_t & to, F && source) {
+    decltype(_data) data{ };
+    data.reserve(to.size());
+    for (dcoord_t y = 0; y < to.y; ++y) {
+        for (dcoord_t x = 0; x < to.x; ++x) {
+            dcoords_t pos{ x, y };
+            dcoords_t from = source(pos);
+            if (from.in(_size)) {
+                auto & gclb = _data[slot(from)].second;
+                gclb.move_to(pos);
+                data.emplace_back(pos, std::move(gclb));
+            } else {
+                data.emplace_back(pos, create_cell(pt, x, y));
+            }
         }
     }
-    //Neue Spalte einfügen
+    //Verbleibende Zellen werden hier zerstört
+    _data = std::move(data);
+    _size = to;
+    link();
+    //TODO: Alle Cargos bewegter Zellen invalidieren
+}
+
+void grid::link() {
     for (dcoord_t y = 0; y < _size.y; ++y) {
-        auto & c = _data.emplace((x, y), create_cell(pt, x, y)).first->second;
-        auto pos = (x, y);
-        if (_size.x > 0) {
-            if (x > 0) {
-                c.set_neighbor(direction::LEFT, &_data.at(pos + dcoords_t(direction::LEFT)));
-            }
-            if (x < _size.x - 1) {
-                c.set_neighbor(direction::RIGHT, &_data.at(pos + dcoords_t(direction::RIGHT)));
-            }
-        }
-        if (y > 0) {
-            c.set_neighbor(direction::UP, &_data.at(pos + dcoords_t(direction::UP)));
+        for (dcoord_t x = 0; x < _size.x; ++x) {
+            auto & gclb = _data[slot(dcoords_t(x, y))].second;
+            gclb.set_neighbor(direction::UP, y > 0 ? &_data[slot(dcoords_t(x, y - 1))].second : nullptr);
+            gclb.set_neighbor(direction::RIGHT, x < _size.x - 1 ? &_data[slot(dcoords_t(x + 1, y))].second : nullptr);
+            gclb.set_neighbor(direction::DOWN, y < _size.y - 1 ? &_data[slot(dcoords_t(x, y + 1))].second : nullptr);
+            gclb.set_neighbor(direction::LEFT, x > 0 ? &_data[slot(dcoords_t(x - 1, y))].second : nullptr);
         }
     }
-    //TODO: Alle Cargos bewegter Zellen invalidieren
+}
 
-    _size.x++;
+void grid::insert_column(const part & pt) {
+    insert_column(pt, _size.x);
+}
+
+void grid::insert_column(const part & pt, const dcoord_t & x) {
+    reshape(pt, _size + dcoords_t(1, 0), [x](const dcoords_t & pos) {
+        if (pos.x < x) {
+            return pos;
+        } else if (pos.x == x) {
+            return dcoords_t(-1, -1);
+        } else {
+            return pos - dcoords_t(1, 0);
+        }
+    });
 }
 
 void grid::insert_row(const part & pt) {
@@ -110,35 +136,15 @@ void grid::insert_row(const part & pt) {
 }
 
 void grid::insert_row(const part & pt, const dcoord_t & y) {
-    //Alte Spalten verschieben
-    for (dcoord_t iy = _size.y; iy > y; --iy) {
-        for (dcoord_t ix = 0; ix < _size.x; ++ix) {
-            auto npos = (ix, iy);
-            auto pair = _data.extract((ix, iy - 1));
-            pair.key() = npos;
-            auto & c = _data.insert(std::move(pair)).position->second;
-            c.move_to(npos);
-        }
-    }
-    //Neue Spalte einfügen
-    for (dcoord_t x = 0; x < _size.x; ++x) {
-        auto & c = _data.emplace((x, y), create_cell(pt, x, y)).first->second;
-        auto pos = (x, y);
-        if (_size.y > 0) {
-            if (y > 0) {
-                c.set_neighbor(direction::UP, &_data.at(pos + dcoords_t(direction::UP)));
-            }
-            if (y < _size.y - 1) {
-                c.set_neighbor(direction::DOWN, &_data.at(pos + dcoords_t(direction::DOWN)));
-            }
-        }
-        if (x > 0) {
-            c.set_neighbor(direction::LEFT, &_data.at(pos + dcoords_t(direction::LEFT)));
+    reshape(pt, _size + dcoords_t(0, 1), [y](const dcoords_t & pos) {
+        if (pos.y < y) {
+            return pos;
+        } else if (pos.y == y) {
+            return dcoords_t(-1, -1);
+        } else {
+            return pos - dcoords_t(0, 1);
         }
-    }
-    //TODO: Alle Cargos bewegter Zellen invalidieren
-
-    _size.y++;
+    });
 }
 
 void grid::remove_column() {
@@ -146,30 +152,9 @@ void grid::remove_column() {
 }
 
 void grid::remove_column(dcoord_t x) {
-    //Spalte entfernen
-    for (dcoord_t y = 0; y < _size.y; ++y) {
-        _data.erase((x, y));
-    }
-
-    //Positionen und Nachbarn aller bewegten Zellen aktualisieren
-    for (dcoord_t ix = x + 1; ix < _size.x; ++ix) {
-        for (dcoord_t iy = 0; iy < _size.y; ++iy) {
-            auto node = _data.extract((ix, iy));
-            node.key() = (ix - 1, iy);
-            node.mapped().move_to((ix - 1, iy));
-            _data.insert(std::move(node));
-        }
-    }
-
-    _size.x--;
-
-    if (x > 0 && x < _size.x) {
-        for (dcoord_t y = 0; y < _size.y; ++y) {
-            _data.at((x, y)).set_neighbor(direction::LEFT, &_data.at((x - 1, y)));
-        }
-    }
-
-    //TODO: Alle Cargos bewegter Zellen invalidieren
+    reshape(part::invalid(), _size - dcoords_t(1, 0), [x](const dcoords_t & pos) {
+        return pos.x < x ? pos : pos + dcoords_t(1, 0);
+    });
 }
 
 void grid::remove_row() {
@@ -177,30 +162,9 @@ void grid::remove_row() {
 }
 
 void grid::remove_row(const dcoord_t & y) {
-    //Zeile entfernen
-    for (dcoord_t x = 0; x < _size.x; ++x) {
-        _data.erase((x, y));
-    }
-
-    //Positionen und Nachbarn aller bewegten Zellen aktualisieren
-    for (dcoord_t iy = y + 1; iy < _size.y; ++iy) {
-        for (dcoord_t ix = 0; ix < _size.x; ++ix) {
-            auto node = _data.extract((ix, iy));
-            node.key() = (ix, iy - 1);
-            node.mapped().move_to((ix, iy - 1));
-            _data.insert(std::move(node));
-        }
-    }
-
-    _size.y--;
-
-    if (y > 0 && y < _size.y) {
-        for (dcoord_t x = 0; x < _size.x; ++x) {
-            _data.at((x, y)).set_neighbor(direction::UP, &_data.at((x, y - 1)));
-        }
-    }
-
-    //TODO: Alle Cargos bewegter Zellen invalidieren
+    reshape(part::invalid(), _size - dcoords_t(0, 1), [y](const dcoords_t & pos) {
+        return pos.y < y ? pos : pos + dcoords_t(0, 1);
+    });
 }
 
 void grid::resize_to(const part & pt, const dcoords_t & to) {
@@ -208,24 +172,13 @@ void grid::resize_to(const part & pt, const dcoords_t & to) {
 }
 
 void grid::resize_by(const part & pt, const dcoords_t & by) {
-    if (by.x > 0) {
-        for (dcoord_t x = 0; x < by.x; ++x) {
-            insert_column(pt);
-        }
-    } else if (by.x < 0) {
-        for (dcoord_t x = by.x; x < 0; ++x) {
-            remove_column();
-        }
-    }
-
-    if (by.y > 0) {
-        for (dcoord_t y = 0; y < by.y; ++y) {
-            insert_row(pt);
-        }
-    } else if (by.y < 0) {
-        for (dcoord_t y = by.y; y < 0; ++y) {
-            remove_row();
-        }
+    auto to = _size + by;
+    to.x = std::max<dcoord_t>(to.x, 0);
+    to.y = std::max<dcoord_t>(to.y, 0);
+    if (to != _size) {
+        reshape(pt, to, [](const dcoords_t & pos) {
+            return pos;
+        });
     }
 }
 
@@ -75,17 +75,23 @@ grid_cell_base::grid_cell_base(grid_cell_base && fref) noexcept: cell_base(std::
                                                                  _iconnected(std::move(fref._iconnected)),
                                                                  _cargo(std::move(fref._cargo)),
                                                                  _artifacts(std::move(fref._artifacts)),
-                                                                 _no_artifacts(std::move(fref._artifacts)),
+                                                                 _no_artifacts(std::move(fref._no_artifacts)),
                                                                  _neighbors(fref._neighbors) {
     for (auto d : direction::cardinal) {
         auto ptr = _neighbors[d];
         if (ptr)
             ptr->_neighbors[!d] = this;
+        fref._neighbors[d] = nullptr;
     }
 
     for (auto & pair : _connected) {
         pair.second.get().bend_connection(*&fref, *this);
     }
+    for (auto & pair : _iconnected) {
+        pair.first->bend_connection(*&fref, *this);
+    }
+    fref._connected.clear();
+    fref._iconnected.clear();
 }
 
 void grid_cell_base::add_connection_inverse(grid_cell_base & cell) {
@@ -225,8 +231,8 @@ void grid_cell_base::remove_connection(direction_t use) {
     _connected.erase(use);
 }
 
-void grid_cell_base::add_cargo(cargo_h num, artifact && arti) {
-    _cargo.emplace(num, std::forward<artifact>(arti));
+artifact & grid_cell_base::add_cargo(cargo_h num, artifact && arti) {
+    return _cargo.emplace(num, std::forward<artifact>(arti)).first->second;
 }
 
 artifact grid_cell_base::remove_cargo(cargo_h num) {
@@ -234,8 +240,8 @@ artifact grid_cell_base::remove_cargo(cargo_h num) {
     return std::move(node.mapped());
 }
 
-void grid_cell_base::add_artifact(artifact_h num, artifact && arti) {
-    _artifacts.emplace(num, std::forward<artifact>(arti));
+artifact & grid_cell_base::add_artifact(artifact_h num, artifact && arti) {
+    return _artifacts.emplace(num, std::forward<artifact>(arti)).first->second;
 }
 
 artifact grid_cell_base::remove_artifact(artifact_h num) {
@@ -263,8 +269,11 @@ void grid_cell_base::move_to(const dcoords_t & pos) {
 
 void grid_cell_base::swap_with(grid_cell_base & rhs) {
     std::swap(_logic, rhs._logic);
-    std::swap(_properties, rhs._properties);
-    std::swap(_intermediate, rhs._intermediate);
+    std::swap(_buffers, rhs._buffers);
+    std::swap(_front, rhs._front);
+    std::swap(_dirty, rhs._dirty);
+    std::swap(_loose, rhs._loose);
+    std::swap(_iloose, rhs._iloose);
     std::swap(_connected, rhs._connected);
     bend_connection(rhs, *this);
     bend_connection(*this, rhs);
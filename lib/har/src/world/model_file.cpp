@@ -0,0 +1,460 @@
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define HAR_MAPPED_FILES
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#endif
+
+#include "world/model_file.hpp"
+
+using namespace har;
+
+//region model_file::mapping
+
+model_file::mapping::mapping(const std::filesystem::path & path) : _data(nullptr),
+                                                                   _size(0u),
+                                                                   _buffer(),
+                                                                   _mapped(false) {
+#ifdef HAR_MAPPED_FILES
+    if (auto fd = ::open(path.c_str(), O_RDONLY); fd >= 0) {
+        struct stat st{ };
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            auto size = std::size_t(st.st_size);
+            auto addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED) {
+                _data = static_cast<const char *>(addr);
+                _size = size;
+                _mapped = true;
+            }
+        }
+        ::close(fd);
+    }
+#endif
+    if (!_mapped) {
+        std::ifstream ifs{ path, std::ios::binary };
+        _buffer.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+        _data = _buffer.data();
+        _size = _buffer.size();
+    }
+}
+
+span<const char> model_file::mapping::bytes() const {
+    return span<const char>(_data, _size);
+}
+
+model_file::mapping::~mapping() {
+#ifdef HAR_MAPPED_FILES
+    if (_mapped) {
+        ::munmap(const_cast<char *>(_data), _size);
+    }
+#endif
+}
+
+//endregion
+
+//region model_file
+
+std::uint32_t model_file::store_slots(const cell_base & clb, std::vector<slot> & slots, std::vector<char> & blob) {
+    //Same selection and order as the text format
+    std::map<entry_h, std::tuple<const entry &, const value &>> props;
+    const auto & pmodel = clb.logic().model();
+    clb.for_each_property([&](of id, const value & val) {
+        auto eit = pmodel.find(id);
+        if (eit != pmodel.end()) {
+            const entry & ent = eit->second;
+            if (ent.serializable == serialize::ANYWAY ||
+                (ent.serializable == serialize::SERIALIZE && !ent.is_standard(val))) {
+                props.emplace(id, std::forward_as_tuple(ent, val));
+            }
+        }
+    });
+
+    auto put = [&](const void * data, std::size_t size) {
+        auto offset = std::uint64_t(blob.size());
+        blob.insert(blob.end(), static_cast<const char *>(data), static_cast<const char *>(data) + size);
+        return offset;
+    };
+
+    for (auto &[id, prop] : props) {
+        auto &[ent, val] = prop;
+        slot s{ std::uint64_t(id), std::uint32_t(val.type()), 0u, 0u };
+        switch (val.type()) {
+            case datatype::BOOLEAN: {
+                s.data = get<bool_t>(val);
+                break;
+            }
+            case datatype::INTEGER: {
+                auto v = std::int64_t(get<int_t>(val));
+                std::memcpy(&s.data, &v, sizeof(v));
+                break;
+            }
+            case datatype::UNSIGNED: {
+                s.data = get<uint_t>(val);
+                break;
+            }
+            case datatype::DOUBLE: {
+                auto v = get<double_t>(val);
+                std::memcpy(&s.data, &v, sizeof(v));
+                break;
+            }
+            case datatype::DIRECTION: {
+                auto v = std::int64_t(get<direction_t>(val));
+                std::memcpy(&s.data, &v, sizeof(v));
+                break;
+            }
+            case datatype::COLOR: {
+                auto & c = get<color_t>(val);
+                std::array<std::uint8_t, 4> v{ c.r, c.g, c.b, c.a };
+                std::memcpy(&s.data, v.data(), v.size());
+                break;
+            }
+            case datatype::HASH: {
+                s.data = std::uint64_t(get<part_h>(val));
+                break;
+            }
+            case datatype::STRING: {
+                auto & str = get<string_t>(val);
+                s.size = std::uint32_t(str.size());
+                s.data = put(str.data(), str.size() * sizeof(char_t));
+                break;
+            }
+            case datatype::C_COORDINATES: {
+                auto & pos = get<ccoords_t>(val);
+                std::array<double_t, 2> v{ pos.x.v, pos.y.v };
+                s.size = sizeof(v);
+                s.data = put(v.data(), sizeof(v));
+                break;
+            }
+            case datatype::D_COORDINATES: {
+                auto & pos = get<dcoords_t>(val);
+                std::array<std::int64_t, 2> v{ pos.x.v, pos.y.v };
+                s.size = sizeof(v);
+                s.data = put(v.data(), sizeof(v));
+                break;
+            }
+            default: {
+                //Values without a binary representation are stored as the text format would store them
+                auto str = ent.to_string(val);
+                s.type = TEXT;
+                s.size = std::uint32_t(str.size());
+                s.data = put(str.data(), str.size() * sizeof(char_t));
+                break;
+            }
+        }
+        slots.emplace_back(s);
+    }
+    return std::uint32_t(props.size());
+}
+
+bool_t model_file::load_slots(cell_base & clb, span<const slot> slots, span<const char> blob) {
+    const auto & pmodel = clb.logic().model();
+    for (auto & s : slots) {
+        auto id = of(s.id);
+        auto eit = pmodel.find(id);
+        if (eit == pmodel.end()) {
+            return false;
+        }
+
+        std::size_t bytes;
+        switch (s.type) {
+            case uint_t(datatype::STRING):
+            case TEXT: {
+                bytes = s.size * sizeof(char_t);
+                break;
+            }
+            case uint_t(datatype::C_COORDINATES):
+            case uint_t(datatype::D_COORDINATES): {
+                bytes = 16u;
+                break;
+            }
+            default: {
+                bytes = 0u;
+                break;
+            }
+        }
+        if (bytes && (s.data > blob.size() || bytes > blob.size() - s.data)) {
+            return false;
+        }
+        auto at = blob.data() + (bytes ? s.data : 0u);
+
+        switch (s.type) {
+            case uint_t(datatype::BOOLEAN): {
+                clb.set(id, value(bool_t(s.data)));
+                break;
+            }
+            case uint_t(datatype::INTEGER): {
+                std::int64_t v;
+                std::memcpy(&v, &s.data, sizeof(v));
+                clb.set(id, value(int_t(v)));
+                break;
+            }
+            case uint_t(datatype::UNSIGNED): {
+                clb.set(id, value(uint_t(s.data)));
+                break;
+            }
+            case uint_t(datatype::DOUBLE): {
+                double_t v;
+                std::memcpy(&v, &s.data, sizeof(v));
+                clb.set(id, value(v));
+                break;
+            }
+            case uint_t(datatype::DIRECTION): {
+                std::int64_t v;
+                std::memcpy(&v, &s.data, sizeof(v));
+                clb.set(id, value(direction_t(v)));
+                break;
+            }
+            case uint_t(datatype::COLOR): {
+                std::array<std::uint8_t, 4> v{ };
+                std::memcpy(v.data(), &s.data, v.size());
+                color_t c;
+                c.r = v[0];
+                c.g = v[1];
+                c.b = v[2];
+                c.a = v[3];
+                clb.set(id, value(c));
+                break;
+            }
+            case uint_t(datatype::HASH): {
+                clb.set(id, value(part_h(s.data)));
+                break;
+            }
+            case uint_t(datatype::STRING): {
+                clb.set(id, value(string_t(reinterpret_cast<const char_t *>(at), s.size)));
+                break;
+            }
+            case uint_t(datatype::C_COORDINATES): {
+                std::array<double_t, 2> v{ };
+                std::memcpy(v.data(), at, sizeof(v));
+                clb.set(id, value(ccoords_t(v[0], v[1])));
+                break;
+            }
+            case uint_t(datatype::D_COORDINATES): {
+                std::array<std::int64_t, 2> v{ };
+                std::memcpy(v.data(), at, sizeof(v));
+                clb.set(id, value(dcoords_t(v[0], v[1])));
+                break;
+            }
+            case TEXT: {
+                clb.set(id, eit->second.from_string(string_t(reinterpret_cast<const char_t *>(at), s.size)));
+                break;
+            }
+            default: {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool_t model_file::is_binary(span<const char> bytes) {
+    return bytes.size() >= MAGIC.size() && std::equal(MAGIC.begin(), MAGIC.end(), bytes.begin());
+}
+
+bool_t model_file::is_binary(istream & is) {
+    return is.peek() == istream::traits_type::to_int_type(MAGIC[0]);
+}
+
+void model_file::store(ostream & os, const model & model) {
+    std::vector<part_record> parts{ };
+    std::map<part_h, std::uint32_t> indices{ };
+    std::vector<cell_record> cells{ };
+    std::vector<cargo_record> cargo{ };
+    std::vector<slot> slots{ };
+    std::vector<wire> wires{ };
+    std::vector<char> blob{ };
+
+    auto put_text = [&](const string_t & str) {
+        text_ref ref{ std::uint32_t(blob.size()), std::uint32_t(str.size()) };
+        auto data = reinterpret_cast<const char *>(str.data());
+        blob.insert(blob.end(), data, data + str.size() * sizeof(char_t));
+        return ref;
+    };
+    auto index_of = [&](const part & pt) {
+        auto[it, added] = indices.try_emplace(pt.id(), std::uint32_t(parts.size()));
+        if (added) {
+            parts.push_back({ std::uint64_t(pt.id()), put_text(pt.unique_name()) });
+        }
+        return it->second;
+    };
+
+    for (auto & grid : { std::cref(model.get_model()), std::cref(model.get_bank()) }) {
+        for (auto & c : grid.get()) {
+            auto & gclb = c.second;
+            if (gclb.logic().traits() & traits::EMPTY_PART) {
+                continue;
+            }
+            auto & pos = gclb.position();
+            cell_record rec{ std::int32_t(pos.cat), std::int32_t(pos.pos.x.v), std::int32_t(pos.pos.y.v),
+                             index_of(gclb.logic()),
+                             std::uint32_t(slots.size()), 0u,
+                             std::uint32_t(wires.size()), 0u };
+            rec.slots = store_slots(gclb, slots, blob);
+            for (auto &[use, ncl] : gclb.connected()) {
+                auto & npos = ncl.get().position();
+                wires.push_back({ std::int64_t(use), std::int32_t(npos.cat),
+                                  std::int32_t(npos.pos.x.v), std::int32_t(npos.pos.y.v), 0 });
+            }
+            rec.wires = std::uint32_t(wires.size()) - rec.first_wire;
+            cells.emplace_back(rec);
+        }
+    }
+    for (auto & cclb : model.cargo()) {
+        auto & pos = cclb.position();
+        cargo_record rec{ pos.x.v, pos.y.v, index_of(cclb.logic()), std::uint32_t(slots.size()), 0u, 0u };
+        rec.slots = store_slots(cclb, slots, blob);
+        cargo.emplace_back(rec);
+    }
+
+    header head{ };
+    head.magic = MAGIC;
+    head.version = VERSION;
+    head.order = ORDER;
+    head.parts = std::uint32_t(parts.size());
+    head.cells = std::uint32_t(cells.size());
+    head.cargo = std::uint32_t(cargo.size());
+    head.slots = std::uint32_t(slots.size());
+    head.wires = std::uint32_t(wires.size());
+    head.title = put_text(model.title());
+    head.author = put_text(model.author());
+    head.description = put_text(model.description());
+    head.model_title = put_text(model.get_model().title());
+    head.bank_title = put_text(model.get_bank().title());
+    head.model_x = std::int32_t(model.get_model().dim().x.v);
+    head.model_y = std::int32_t(model.get_model().dim().y.v);
+    head.bank_x = std::int32_t(model.get_bank().dim().x.v);
+    head.bank_y = std::int32_t(model.get_bank().dim().y.v);
+    head.editable = model.editable();
+    blob.resize((blob.size() + 7u) / 8u * 8u);
+    head.blob = blob.size();
+
+    auto write = [&os](const void * data, std::size_t size) {
+        os.write(static_cast<const char_t *>(data), std::streamsize(size / sizeof(char_t)));
+    };
+    write(&head, sizeof(head));
+    write(parts.data(), parts.size() * sizeof(part_record));
+    write(cells.data(), cells.size() * sizeof(cell_record));
+    write(cargo.data(), cargo.size() * sizeof(cargo_record));
+    write(slots.data(), slots.size() * sizeof(slot));
+    write(wires.data(), wires.size() * sizeof(wire));
+    write(blob.data(), blob.size());
+}
+
+bool_t model_file::load(span<const char> bytes, model & model, const std::map<part_h, part> & inv) {
+    if (!is_binary(bytes) || bytes.size() < sizeof(header)) {
+        return false;
+    }
+    auto & head = *reinterpret_cast<const header *>(bytes.data());
+    if (head.version != VERSION || head.order != ORDER) {
+        return false;
+    }
+
+    //Every array is read in place
+    std::size_t offset = sizeof(header);
+    auto take = [&](auto * type, std::size_t count) {
+        using T = std::remove_pointer_t<decltype(type)>;
+        span<const T> array{ reinterpret_cast<const T *>(bytes.data() + offset), count };
+        offset += count * sizeof(T);
+        return array;
+    };
+    auto size = sizeof(header) + head.parts * sizeof(part_record) + head.cells * sizeof(cell_record) +
+                head.cargo * sizeof(cargo_record) + head.slots * sizeof(slot) + head.wires * sizeof(wire);
+    if (size > bytes.size() || head.blob > bytes.size() - size) {
+        return false;
+    }
+    auto parts = take(static_cast<part_record *>(nullptr), head.parts);
+    auto cells = take(static_cast<cell_record *>(nullptr), head.cells);
+    auto cargo = take(static_cast<cargo_record *>(nullptr), head.cargo);
+    auto slots = take(static_cast<slot *>(nullptr), head.slots);
+    auto wires = take(static_cast<wire *>(nullptr), head.wires);
+    span<const char> blob{ bytes.data() + offset, std::size_t(head.blob) };
+
+    bool_t ok = true;
+    auto read_text = [&](const text_ref & ref) {
+        if (ref.offset > blob.size() || ref.size * sizeof(char_t) > blob.size() - ref.offset) {
+            ok = false;
+            return string_t();
+        }
+        return string_t(reinterpret_cast<const char_t *>(blob.data() + ref.offset), ref.size);
+    };
+
+    model.title() = read_text(head.title);
+    model.author() = read_text(head.author);
+    model.description() = read_text(head.description);
+    model.editable() = head.editable;
+    model.get_model().title() = read_text(head.model_title);
+    model.get_bank().title() = read_text(head.bank_title);
+    model.get_model().resize_to(inv.at(PART[0]), dcoords_t(head.model_x, head.model_y));
+    model.get_bank().resize_to(inv.at(PART[0]), dcoords_t(head.bank_x, head.bank_y));
+
+    std::vector<const part *> used{ };
+    for (auto & p : parts) {
+        auto name = read_text(p.name);
+        auto pit = std::find_if(inv.begin(), inv.end(), [&name](const auto & e) {
+            return e.second.unique_name() == name;
+        });
+        if (pit == inv.end()) {
+            return false;
+        }
+        used.emplace_back(&pit->second);
+    }
+
+    auto in = [](std::uint32_t first, std::uint32_t count, std::size_t size) {
+        return first <= size && count <= size - first;
+    };
+    auto on_grid = [&model](const gcoords_t & pos) {
+        auto & grid = pos.cat == grid_t::MODEL_GRID ? model.get_model() : model.get_bank();
+        return pos.cat != grid_t::INVALID_GRID && pos.pos.in(grid.dim());
+    };
+
+    for (auto & rec : cells) {
+        gcoords_t pos{ grid_t(rec.grid), rec.x, rec.y };
+        if (rec.part >= used.size() || !in(rec.first_slot, rec.slots, slots.size()) ||
+            !in(rec.first_wire, rec.wires, wires.size()) || !on_grid(pos)) {
+            return false;
+        }
+        auto & pt = *used[rec.part];
+        grid_cell_base gclb{ part::invalid(), pos };
+        gclb.set_type(pt);
+        pt.init_standard(gclb);
+        if (!load_slots(gclb, span<const slot>(slots.data() + rec.first_slot, rec.slots), blob)) {
+            return false;
+        }
+        gclb.transit();
+        for (auto & w : span<const wire>(wires.data() + rec.first_wire, rec.wires)) {
+            gcoords_t npos{ grid_t(w.grid), w.x, w.y };
+            if (!on_grid(npos)) {
+                return false;
+            }
+            gclb.add_connection(direction_t(w.use), model.at(npos));
+        }
+        model.at(pos).adopt(std::move(gclb));
+    }
+    for (auto & rec : cargo) {
+        if (rec.part >= used.size() || !in(rec.first_slot, rec.slots, slots.size())) {
+            return false;
+        }
+        auto & pt = *used[rec.part];
+        cargo_cell_base cclb{ CARGO[0], part::invalid(), ccoords_t(rec.x, rec.y) };
+        cclb.set_type(pt);
+        pt.init_standard(cclb);
+        if (!load_slots(cclb, span<const slot>(slots.data() + rec.first_slot, rec.slots), blob)) {
+            return false;
+        }
+        cclb.transit();
+        model.add_cargo(std::move(cclb));
+    }
+
+    model.info().titles.try_emplace(grid_t::MODEL_GRID, model.get_model().title());
+    model.info().titles.try_emplace(grid_t::BANK_GRID, model.get_bank().title());
+    return ok;
+}
+
+//endregion
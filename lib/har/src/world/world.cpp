@@ -2,12 +2,23 @@
 // Created by Johannes on 26.05.2020.
 //
 
+#include <cmath>
 #include <iomanip>
 
 #include "world/world.hpp"
 
 using namespace har;
 
+/// \brief Determines the rectangle of grid cells cargo covers
+/// \return Top left and bottom right corner of the rectangle, exclusive
+static std::pair<dcoords_t, dcoords_t> cover_of(const cargo_cell_base & cclb, const dcoords_t & dim) {
+    auto half = cclb.size() / 2.;
+    auto & pos = cclb.position();
+    dcoords_t tl{ int_t(std::floor((pos.x - half.x).v)), int_t(std::floor((pos.y - half.y).v)) };
+    dcoords_t br{ int_t(std::ceil((pos.x + half.x).v)), int_t(std::ceil((pos.y + half.y).v)) };
+    return std::make_pair(dcoords_t::clamp(tl, dcoords_t(), dim), dcoords_t::clamp(br, dcoords_t(), dim));
+}
+
 world::world() : _model({ MODEL_GRID, dcoords_t() }, part::invalid()),
                  _bank({ BANK_GRID, dcoords_t() }, part::invalid()),
                  _cargo() {
@@ -110,30 +121,124 @@ cell_base & world::at(const cell_h & hnd) {
     }
 }
 
-void world::resize(grid_t grid, const part & pt, const dcoords_t & to) {
-    switch (grid) {
-        case MODEL_GRID:
-            _model.resize_to(pt, to);
-            return;
-        case BANK_GRID:
-            _bank.resize_to(pt, to);
-            return;
-        case INVALID_GRID:
-            return;
+const grid_cell_base & world::at(const gcoords_t & pos) const {
+    return const_cast<world &>(*this).at(pos);
+}
+
+const cargo_cell_base & world::at(cargo_h num) const {
+    return const_cast<world &>(*this).at(num);
+}
+
+const cell_base & world::at(const cell_h & hnd) const {
+    return const_cast<world &>(*this).at(hnd);
+}
+
+cargo_cell_base & world::reserve_cargo(const part & pt, const ccoords_t & pos) {
+    return _cargo.reserve(pt, pos);
+}
+
+cargo_cell_base & world::add_cargo(cargo_h num) {
+    auto & added = _cargo.admit(num);
+    if (added.overlays().empty()) {
+        place(added);
     }
+    return added;
 }
 
-void world::resize(grid_t grid, const part & pt, dcoords_t && to) {
+cargo_cell_base & world::add_cargo(const part & pt, const ccoords_t & pos) {
+    return add_cargo(_cargo.reserve(pt, pos).id());
+}
+
+cargo_cell_base & world::add_cargo(cargo_cell_base && cclb) {
+    cclb._overlays.clear();
+    return add_cargo(_cargo.reserve(std::forward<cargo_cell_base>(cclb)).id());
+}
+
+bool_t world::move_cargo(cargo_cell_base & cclb, const ccoords_t & to) {
+    auto dim = _model.dim();
+    auto pos = ccoords_t::clamp(to, ccoords_t(), ccoords_t(dim) - 1e-9);
+    if (pos == cclb._position) {
+        return false;
+    }
+    auto cover = cover_of(cclb, dim);
+    dcoords_t center{ cclb._position };
+    cclb._position = pos;
+    if (cover != cover_of(cclb, dim) || center != dcoords_t(pos)) {
+        cclb._position = ccoords_t(center);
+        lift(cclb);
+        cclb._position = pos;
+        place(cclb);
+    }
+    return true;
+}
+
+bool_t world::remove_cargo(cargo_h num) {
+    if (auto * cclb = _cargo.find(num)) {
+        lift(*cclb);
+    }
+    return _cargo.release(num);
+}
+
+void world::place(cargo_cell_base & cclb) {
+    auto[tl, br] = cover_of(cclb, _model.dim());
+    dcoords_t center{ cclb._position };
+    for (auto y = tl.y; y < br.y; ++y) {
+        for (auto x = tl.x; x < br.x; ++x) {
+            dcoords_t pos{ x, y };
+            auto & gclb = _model.at(pos);
+            artifact arti{ cclb, pos - center };
+            auto & placed = (pos == center) ?
+                            gclb.add_cargo(cclb._id, std::move(arti)) :
+                            gclb.add_artifact(cclb._id, std::move(arti));
+            cclb._overlays.try_emplace(pos, &placed, &gclb);
+        }
+    }
+}
+
+void world::lift(cargo_cell_base & cclb) {
+    for (auto &[pos, overlay] : cclb._overlays) {
+        auto & gclb = *overlay.second;
+        if (gclb.cargo().count(cclb._id)) {
+            gclb.remove_cargo(cclb._id);
+        } else {
+            gclb.remove_artifact(cclb._id);
+        }
+    }
+    cclb._overlays.clear();
+}
+
+std::vector<cargo_h> world::resize(grid_t grid, const part & pt, const dcoords_t & to) {
+    std::vector<cargo_h> removed{ };
     switch (grid) {
         case MODEL_GRID:
+            //Cells may be reallocated, so the overlays are rebuilt
+            for (auto & cclb : _cargo) {
+                lift(cclb);
+            }
             _model.resize_to(pt, to);
-            return;
+            for (uint_t i = 0; i < _cargo.size();) {
+                auto & cclb = _cargo.nth(i);
+                if (dcoords_t(cclb._position).in(_model.dim())) {
+                    place(cclb);
+                    ++i;
+                } else {
+                    //Releasing swaps the last cargo into the current index
+                    removed.emplace_back(cclb._id);
+                    _cargo.release(cclb._id);
+                }
+            }
+            break;
         case BANK_GRID:
             _bank.resize_to(pt, to);
-            return;
+            break;
         case INVALID_GRID:
-            return;
+            break;
     }
+    return removed;
+}
+
+std::vector<cargo_h> world::resize(grid_t grid, const part & pt, dcoords_t && to) {
+    return resize(grid, pt, static_cast<const dcoords_t &>(to));
 }
 
 void world::minimize(grid_t grid) {
@@ -146,9 +251,9 @@ void world::purge_part(const part & pt, const part & with) {
     _model.purge_part(pt, with);
     _bank.purge_part(pt, with);
 
-    for (auto & c : _cargo) {
-        if (c.second.logic().id() == pt.id()) {
-            c.second.set_type(with);
+    for (auto & cclb : _cargo) {
+        if (cclb.logic().id() == pt.id()) {
+            cclb.set_type(with);
         }
     }
 }
@@ -183,8 +288,8 @@ ostream & har::operator<<(ostream & os, const world & world) {
             os << '\n' << c.second;
         }
     }
-    for (auto & c : world._cargo) {
-        os << '\n' << c.second;
+    for (auto & cclb : world._cargo) {
+        os << '\n' << cclb;
     }
     return os;
 }
@@ -259,7 +364,7 @@ har::operator>>(std::tuple<istream &, const std::map<part_h, part> &> is_inv, st
                 cargo_cell_base cclb{ CARGO[0], part::invalid() };
                 is_inv >> cclb;
                 cclb.transit();
-                world.cargo().try_emplace(cclb.id(), std::forward<cargo_cell_base>(cclb));
+                world.add_cargo(std::move(cclb));
                 break;
             }
             case 'g': {
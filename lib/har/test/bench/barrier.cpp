@@ -0,0 +1,153 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "logic/barrier.hpp"
+
+using namespace har;
+
+//region legacy
+
+/// \brief Mutex handoff the automaton synchronized its substeps with before
+///
+/// Kept as reference for the benchmark only. As before, mutexes are unlocked by threads not owning them.
+class legacy_barrier {
+private:
+    std::atomic<std::ptrdiff_t> _count;
+    const std::ptrdiff_t _expected;
+
+    std::mutex _mutex;
+
+public:
+    explicit legacy_barrier(std::ptrdiff_t expected) : _count(expected), _expected(expected), _mutex() {
+
+    }
+
+    void arrive() {
+        if (_count.fetch_sub(1, std::memory_order_acq_rel) <= 1) {
+            _mutex.unlock();
+        }
+    }
+
+    void wait() {
+        std::scoped_lock lock{ _mutex };
+    }
+
+    void reset() {
+        _count.exchange(_expected, std::memory_order_acq_rel);
+        _mutex.lock();
+    }
+};
+
+/// \brief Runs substeps with one mutex per worker to unblock it and a legacy_barrier to wait for it
+double_t run_legacy(uint_t workers, uint_t substeps) {
+    legacy_barrier bar{ std::ptrdiff_t(workers) };
+    std::unique_ptr<std::mutex[]> workex{ new std::mutex[workers] };
+    std::vector<std::thread> threads{ };
+    volatile bool_t valid = true;
+
+    for (uint_t i = 0; i < workers; ++i) {
+        workex[i].lock();
+        threads.emplace_back([&, i]() {
+            while (true) {
+                workex[i].lock();
+                bool_t run = valid;
+                bar.arrive();
+                if (!run) {
+                    return;
+                }
+            }
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint_t s = 0; s < substeps; ++s) {
+        bar.reset();
+        for (uint_t i = 0; i < workers; ++i) {
+            workex[i].unlock();
+        }
+        bar.wait();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    valid = false;
+    bar.reset();
+    for (uint_t i = 0; i < workers; ++i) {
+        workex[i].unlock();
+    }
+    bar.wait();
+    for (auto & t : threads) {
+        t.join();
+    }
+
+    return std::chrono::duration<double_t, std::nano>(end - start).count() / substeps;
+}
+
+//endregion
+
+//region barrier
+
+/// \brief Runs substeps the way the automaton does, passing a barrier to unblock the workers and another to join them
+double_t run_barrier(uint_t workers, uint_t substeps, uint_t spin) {
+    barrier bar{ std::ptrdiff_t(workers + 1), spin };
+    std::vector<std::thread> threads{ };
+    volatile bool_t valid = true;
+
+    for (uint_t i = 0; i < workers; ++i) {
+        threads.emplace_back([&]() {
+            while (true) {
+                bar.arrive_and_wait();
+                if (!valid) {
+                    return;
+                }
+                bar.arrive_and_wait();
+            }
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint_t s = 0; s < substeps; ++s) {
+        bar.arrive_and_wait();
+        bar.arrive_and_wait();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    valid = false;
+    bar.arrive_and_wait();
+    for (auto & t : threads) {
+        t.join();
+    }
+
+    return std::chrono::duration<double_t, std::nano>(end - start).count() / substeps;
+}
+
+//endregion
+
+/// \brief Measures the synchronization overhead per substep for 1 to N workers
+///
+/// \param argc Argument count
+/// \param argv <tt>[max workers [substeps]]</tt>
+/// \return Exit code
+int main(int argc, char * argv[]) {
+    uint_t max_workers = argc > 1 ? uint_t(std::strtoul(argv[1], nullptr, 10))
+                                  : std::max(std::thread::hardware_concurrency(), 2u) - 1u;
+    uint_t substeps = argc > 2 ? uint_t(std::strtoul(argv[2], nullptr, 10)) : 10000u;
+
+    std::cout << std::setw(8) << "workers"
+              << std::setw(16) << "legacy [ns]"
+              << std::setw(16) << "no spin [ns]"
+              << std::setw(16) << "spin [ns]" << std::endl;
+
+    for (uint_t w = 1; w <= max_workers; ++w) {
+        std::cout << std::setw(8) << w
+                  << std::setw(16) << std::fixed << std::setprecision(1) << run_legacy(w, substeps)
+                  << std::setw(16) << run_barrier(w, substeps, 0u)
+                  << std::setw(16) << run_barrier(w, substeps, 1u << 12u) << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+#include <har/part_type.hpp>
+
+#include "logic/inner_simulation.hpp"
+
+using namespace har;
+
+/// \brief Part type stepping a counter, differently for every <tt>K</tt>
+template<uint_t K>
+struct stepper : public part_type<stepper<K>, static_slot<of::VALUE, uint_t>> {
+    using count = static_slot<of::VALUE, uint_t>;
+
+    static void cycle(typed_cell<count> & cl) {
+        auto n = cl.template get<count>();
+        cl.template set<count>(n % 2u ? n * K + 1u : n / 2u + K);
+    }
+};
+
+/// \brief Creates a part of a stepper
+template<uint_t K>
+part stepper_part() {
+    part pt{ PART[K], "stepper" + std::to_string(K), traits::COMPONENT_PART };
+    pt.add_entry(entry{ of::VALUE,
+                        "VALUE",
+                        "Count",
+                        value(uint_t(K)),
+                        ui_access::VISIBLE,
+                        serialize::NO_SERIALIZE,
+                        std::array<uint_t, 3>{ 0u, 1000u, 1u }});
+    stepper<K>::bind(pt);
+    return pt;
+}
+
+/// \brief Cycles a model of steppers
+///
+/// \param [in] dim Size of the model
+/// \param [in] kinds Number of different parts, in bands of rows
+/// \param [in] scattered Whether the parts are scattered randomly instead
+/// \param [in] batched Whether runs of cells of the same part are cycled in batches
+/// \param [in] cycles Number of cycles
+/// \return Nanoseconds per cell and cycle
+double_t run(const dcoords_t & dim, uint_t kinds, bool_t scattered, bool_t batched, uint_t cycles) {
+    inner_simulation sim{ 0, nullptr, nullptr };
+    sim.include_part(stepper_part<1>());
+    sim.include_part(stepper_part<2>());
+    sim.include_part(stepper_part<3>());
+    sim.include_part(stepper_part<4>());
+
+    auto & model = sim.get_model();
+    model.resize(grid_t::MODEL_GRID, sim.part_of(PART[1]), dcoords_t(dim));
+    uint_t seed = 1u;
+    for (auto &[pos, clb] : model.get_model()) {
+        seed = seed * 1103515245u + 12345u;
+        clb.set_type(sim.part_of(PART[1u + (scattered ? seed >> 16u : uint_t(pos.y) / 8u) % kinds]));
+    }
+
+    sim.commence();
+    auto & atm = sim.get_automaton();
+    atm.set_batched(batched);
+    atm.set_state(PARTICIPANT.no_one(), automaton::state::RUN);
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint_t c = 0; c < cycles; ++c) {
+        atm.cycle();
+    }
+    auto end = std::chrono::steady_clock::now();
+    atm.set_state(PARTICIPANT.no_one(), automaton::state::STOP);
+
+    return std::chrono::duration<double_t, std::nano>(end - start).count() / (cycles * dim.size());
+}
+
+/// \brief Measures the cost of cycling cells one by one and in batches
+///
+/// \param argc Argument count
+/// \param argv <tt>[side [cycles]]</tt>
+/// \return Exit code
+int main(int argc, char * argv[]) {
+    int_t side = argc > 1 ? int_t(std::strtol(argv[1], nullptr, 10)) : 128;
+    uint_t cycles = argc > 2 ? uint_t(std::strtoul(argv[2], nullptr, 10)) : 100u;
+    dcoords_t dim{ side, side };
+
+    std::cout << std::setw(8) << "parts"
+              << std::setw(12) << "layout"
+              << std::setw(16) << "single [ns]"
+              << std::setw(16) << "batched [ns]" << std::endl;
+
+    for (bool_t scattered : { false, true }) {
+        for (uint_t kinds : { 1u, 2u, 4u }) {
+            std::cout << std::setw(8) << kinds
+                      << std::setw(12) << (scattered ? "scattered" : "banded")
+                      << std::setw(16) << std::fixed << std::setprecision(1)
+                      << run(dim, kinds, scattered, false, cycles)
+                      << std::setw(16) << run(dim, kinds, scattered, true, cycles) << std::endl;
+        }
+    }
+
+    return 0;
+}
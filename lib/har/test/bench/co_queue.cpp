@@ -0,0 +1,186 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <har/co_queue.hpp>
+
+#include "logic/inner_simulation.hpp"
+
+using namespace har;
+
+using callback = std::function<void()>;
+
+//region legacy
+
+/// \brief Mutex guarded deque co_queue was before
+///
+/// Kept as reference for the benchmark only.
+class legacy_queue {
+private:
+    mutable std::mutex _queex;
+    std::deque<callback> _queue;
+
+public:
+    legacy_queue() : _queex(), _queue() {
+
+    }
+
+    [[nodiscard]]
+    bool_t empty() const {
+        std::scoped_lock lock{ _queex };
+        return _queue.empty();
+    }
+
+    void push(callback && fref) {
+        std::scoped_lock lock{ _queex };
+        _queue.push_front(std::move(fref));
+    }
+
+    callback pop() {
+        std::scoped_lock lock{ _queex };
+        callback t{ std::move(_queue.back()) };
+        _queue.pop_back();
+        return t;
+    }
+};
+
+/// \brief Processes all queued callbacks one lock at a time, as the GUI did
+uint_t consume(legacy_queue & queue) {
+    uint_t count = 0u;
+    while (!queue.empty()) {
+        queue.pop()();
+        ++count;
+    }
+    return count;
+}
+
+//endregion
+
+//region co_queue
+
+/// \brief Processes all queued callbacks as one batch, as the GUI does
+uint_t consume(co_queue<callback> & queue) {
+    return queue.drain([](callback & fun) {
+        fun();
+    });
+}
+
+//endregion
+
+/// \brief Pushes callbacks from a number of threads while the calling thread consumes them
+///
+/// \return Nanoseconds per callback
+template<typename Q>
+double_t run_threads(uint_t producers, uint_t pushes) {
+    Q queue{ };
+    uint_t called = 0u;
+    std::atomic<bool_t> go{ false };
+    std::vector<std::thread> threads{ };
+
+    for (uint_t i = 0; i < producers; ++i) {
+        threads.emplace_back([&]() {
+            while (!go.load(std::memory_order_acquire));
+            for (uint_t n = 0; n < pushes; ++n) {
+                queue.push([&called]() { ++called; });
+            }
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    uint_t consumed = 0u;
+    while (consumed < producers * pushes) {
+        consumed += consume(queue);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    for (auto & t : threads) {
+        t.join();
+    }
+
+    return std::chrono::duration<double_t, std::nano>(end - start).count() / (producers * pushes);
+}
+
+/// \brief Cycles a model whose cells push a callback every cycle, consumed by another thread
+///
+/// The automaton's worker threads are the producers.
+/// \return Nanoseconds per cycle
+template<typename Q>
+double_t run_automaton(const dcoords_t & dim, uint_t cycles) {
+    Q queue{ };
+    uint_t called = 0u;
+    std::atomic<bool_t> done{ false };
+
+    inner_simulation sim{ 0, nullptr, nullptr };
+    part pusher{ PART[1], text("pusher"), traits::COMPONENT_PART };
+    pusher.delegates.cycle = [&](cell & cl) {
+        queue.push([&called]() { ++called; });
+    };
+    sim.include_part(pusher);
+    sim.get_model().resize(grid_t::MODEL_GRID, sim.part_of(PART[1]), dcoords_t(dim));
+    sim.commence();
+    sim.get_automaton().set_state(PARTICIPANT.no_one(), automaton::state::RUN);
+
+    std::thread consumer{ [&]() {
+        while (!done.load(std::memory_order_acquire)) {
+            consume(queue);
+        }
+        consume(queue);
+    } };
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint_t c = 0; c < cycles; ++c) {
+        sim.get_automaton().cycle();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    done.store(true, std::memory_order_release);
+    consumer.join();
+    sim.get_automaton().set_state(PARTICIPANT.no_one(), automaton::state::STOP);
+
+    return std::chrono::duration<double_t, std::nano>(end - start).count() / cycles;
+}
+
+/// \brief Measures the cost of pushing to and draining the queue for 1 to N producers
+///
+/// \param argc Argument count
+/// \param argv <tt>[max producers [pushes per producer [cycles]]]</tt>
+/// \return Exit code
+int main(int argc, char * argv[]) {
+    uint_t max_producers = argc > 1 ? uint_t(std::strtoul(argv[1], nullptr, 10))
+                                    : std::max(std::thread::hardware_concurrency(), 2u) - 1u;
+    uint_t pushes = argc > 2 ? uint_t(std::strtoul(argv[2], nullptr, 10)) : 100000u;
+    uint_t cycles = argc > 3 ? uint_t(std::strtoul(argv[3], nullptr, 10)) : 200u;
+
+    std::cout << std::setw(10) << "producers"
+              << std::setw(16) << "legacy [ns]"
+              << std::setw(16) << "co_queue [ns]" << std::endl;
+
+    for (uint_t p = 1; p <= max_producers; ++p) {
+        std::cout << std::setw(10) << p
+                  << std::setw(16) << std::fixed << std::setprecision(1) << run_threads<legacy_queue>(p, pushes)
+                  << std::setw(16) << run_threads<co_queue<callback>>(p, pushes) << std::endl;
+    }
+
+    std::cout << std::endl
+              << std::setw(10) << "cells"
+              << std::setw(16) << "legacy [us]"
+              << std::setw(16) << "co_queue [us]" << std::endl;
+
+    for (int_t side : { 16, 64, 128 }) {
+        dcoords_t dim{ side, side };
+        std::cout << std::setw(10) << dim.size()
+                  << std::setw(16) << std::fixed << std::setprecision(1)
+                  << run_automaton<legacy_queue>(dim, cycles) / 1000.
+                  << std::setw(16) << run_automaton<co_queue<callback>>(dim, cycles) / 1000. << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,133 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <har/field.hpp>
+#include <har/grid_cell.hpp>
+
+#include "logic/inner_simulation.hpp"
+#include "world/grid_cell_base.hpp"
+
+using namespace har;
+
+/// \brief Grants access to the diagonal neighbors of a grid cell
+struct neighborhood : public grid_cell {
+    static grid_cell_base & base_of(grid_cell & gcl) {
+        grid_cell_base & (grid_cell::* base)() noexcept = &neighborhood::as_grid_cell_base;
+        return (gcl.*base)();
+    }
+};
+
+/// \brief Cycles a cell of the Game of Life on its own
+void cycle_cell(cell & cl) {
+    uint_t count{ 0 };
+    auto & gclb = neighborhood::base_of(cl.as_grid_cell());
+    auto alive_at = [&](const grid_cell_base * ncl) {
+        return ncl && &ncl->logic() == &gclb.logic() && get<bool_t>(ncl->get(of::VALUE));
+    };
+
+    for (auto dir : direction::cardinal) {
+        auto ncl = gclb.get_cell(dir);
+        if (ncl) {
+            count += alive_at(ncl);
+            count += alive_at(ncl->get_cell(cw(dir)));
+        }
+    }
+
+    bool_t alive{ cl[of::VALUE] };
+    bool_t next = count == 3u || (alive && count == 2u);
+    if (next != alive) {
+        cl[of::VALUE] = next;
+    }
+}
+
+/// \brief Cycles all cells of the Game of Life as a field
+void cycle_field(const field<bool_t> & in, field<bool_t> & out) {
+    std::vector<std::uint8_t> counts(in.width());
+
+    for (std::size_t y = 0u; y < in.height(); ++y) {
+        moore_count(in, y, counts.data());
+
+        auto alive = in.row(y);
+        auto mask = in.mask(y);
+        auto next = out.row(y);
+        for (std::size_t x = 0u; x < in.width(); ++x) {
+            next[x] = std::uint8_t(mask[x] && (counts[x] == 3u || (alive[x] && counts[x] == 2u)));
+        }
+    }
+}
+
+/// \brief Creates a part of the Game of Life
+part life_part(bool_t as_field) {
+    part pt{ PART[1], "life", traits::COMPONENT_PART };
+    pt.add_entry(entry{ of::VALUE,
+                        "VALUE",
+                        "Alive",
+                        value(bool_t()),
+                        ui_access::VISIBLE,
+                        serialize::NO_SERIALIZE });
+    if (as_field) {
+        pt.set_field(of::VALUE, field_kernel<bool_t>(cycle_field));
+    } else {
+        pt.delegates.cycle = cycle_cell;
+    }
+    return pt;
+}
+
+/// \brief Cycles a random board of the Game of Life
+///
+/// \param [in] dim Size of the board
+/// \param [in] as_field Whether the cells are cycled as a field
+/// \param [in] cycles Number of cycles
+/// \return Nanoseconds per cell and cycle
+double_t run(const dcoords_t & dim, bool_t as_field, uint_t cycles) {
+    inner_simulation sim{ 0, nullptr, nullptr };
+    sim.include_part(life_part(as_field));
+
+    auto & model = sim.get_model();
+    model.resize(grid_t::MODEL_GRID, sim.part_of(PART[1]), dcoords_t(dim));
+    uint_t seed = 1u;
+    for (auto &[pos, clb] : model.get_model()) {
+        seed = seed * 1103515245u + 12345u;
+        clb.set_type(sim.part_of(PART[1]));
+        clb.set(of::VALUE, value(bool_t((seed >> 16u) % 3u == 0u)));
+        clb.transit();
+    }
+
+    sim.commence();
+    auto & atm = sim.get_automaton();
+    atm.set_state(PARTICIPANT.no_one(), automaton::state::RUN);
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint_t c = 0; c < cycles; ++c) {
+        atm.cycle();
+    }
+    auto end = std::chrono::steady_clock::now();
+    atm.set_state(PARTICIPANT.no_one(), automaton::state::STOP);
+
+    return std::chrono::duration<double_t, std::nano>(end - start).count() / (cycles * dim.size());
+}
+
+/// \brief Measures the cost of cycling the Game of Life cell by cell and as a field
+///
+/// \param argc Argument count
+/// \param argv <tt>[cycles]</tt>
+/// \return Exit code
+int main(int argc, char * argv[]) {
+    uint_t cycles = argc > 1 ? uint_t(std::strtoul(argv[1], nullptr, 10)) : 50u;
+
+    std::cout << std::setw(8) << "side"
+              << std::setw(16) << "cells [ns]"
+              << std::setw(16) << "field [ns]" << std::endl;
+
+    for (int_t side : { 64, 128, 256 }) {
+        dcoords_t dim{ side, side };
+        std::cout << std::setw(8) << side
+                  << std::setw(16) << std::fixed << std::setprecision(1) << run(dim, false, cycles)
+                  << std::setw(16) << run(dim, true, cycles) << std::endl;
+    }
+
+    return 0;
+}
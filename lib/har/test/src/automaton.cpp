@@ -4,10 +4,21 @@
 
 #define HAR_ENABLE_REQUEST_MACROS
 
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#include <har/cell_batch.hpp>
+#include <har/field.hpp>
 #include <har/program.hpp>
 
 #include "logic/automaton.hpp"
 #include "logic/inner_simulation.hpp"
+#include "logic/scheduler.hpp"
 
 #include "world/grid.hpp"
 
@@ -15,6 +26,86 @@
 
 using namespace har;
 
+/// \brief Program counting the notifications it receives
+class counting_program : public program {
+public:
+    uint_t redraws{ };
+    uint_t updates{ };
+    uint_t batches{ };
+    uint_t commits{ };
+    uint_t spawns{ };
+    uint_t moves{ };
+    uint_t destroys{ };
+    uint_t cycles{ };
+    bool_t images{ true };
+
+    using participant::set_viewport;
+    using participant::reset_viewport;
+    using participant::set_drawing;
+    using participant::set_cycling;
+    using participant::set_probes;
+    using participant::read_probes;
+    using participant::set_trigger;
+    using participant::clear_trigger;
+    using participant::take_trigger;
+
+    [[nodiscard]]
+    bool_t wants_images() const override {
+        return images;
+    }
+
+    void on_cycle(participant::context & ctx) override {
+        ++cycles;
+    }
+
+    void on_selection_update(const cell_h & hnd, entry_h id, const value & val, bool_t commit) override {
+        ++updates;
+    }
+
+    void on_redraw(const cell_h & hnd, image_t && img, bool_t commit) override {
+        ++redraws;
+    }
+
+    void on_redraw_batch(span<redraw_t> batch) override {
+        ++batches;
+        participant::on_redraw_batch(batch);
+    }
+
+    void on_cargo_spawned(cargo_h num) override {
+        ++spawns;
+    }
+
+    void on_cargo_moved(cargo_h num, ccoords_t to) override {
+        ++moves;
+    }
+
+    void on_cargo_destroyed(cargo_h num) override {
+        ++destroys;
+    }
+
+    void on_commit() override {
+        ++commits;
+    }
+};
+
+/// \brief Program keeping the images it is offered
+class keeping_program : public counting_program {
+public:
+    har::map<look_t, image_t> kept{ };
+    std::mutex keptex{ };
+
+    std::optional<image_t> find_image(const cell_h & hnd, const look_t & look) override {
+        std::scoped_lock lock{ keptex };
+        auto it = kept.find(look);
+        return it != kept.end() ? std::make_optional(it->second) : std::nullopt;
+    }
+
+    void keep_image(const cell_h & hnd, const look_t & look, const image_t & img) override {
+        std::scoped_lock lock{ keptex };
+        kept.try_emplace(look, img);
+    }
+};
+
 TEST_CASE("Automaton", "[!mayfail][automaton]") {
     inner_simulation isim{ 0, nullptr, nullptr };
     automaton & automaton = isim.get_automaton();
@@ -45,6 +136,202 @@ TEST_CASE("Automaton", "[!mayfail][automaton]") {
         REQUIRE(automaton.state() == automaton::state::STOP);
     }
 
+    SECTION("Cycling participants are called back every cycle") {
+        counting_program counter{ };
+        auto id = isim.attach(counter);
+        isim.commence();
+        automaton.set_state(PARTICIPANT.no_one(), automaton::state::RUN);
+
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(counter.cycles == 0u);
+
+        counter.set_cycling(true);
+        for (uint_t i = 0; i < 5u; ++i) {
+            REQUIRE_NOTHROW(automaton.cycle());
+        }
+        REQUIRE(counter.cycles == 5u);
+
+        counter.set_cycling(false);
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(counter.cycles == 5u);
+
+        isim.detach(id);
+    }
+
+    SECTION("Probed properties are published after every cycle") {
+        counting_program counter{ };
+        auto id = isim.attach(counter);
+        isim.commence();
+
+        part blink{ PART[1] };
+        blink.add_entry(entry{ of::VALUE,
+                               text("__VALUE"),
+                               text("Blink value"),
+                               value(uint_t()),
+                               ui_access::VISIBLE,
+                               serialize::NO_SERIALIZE,
+                               std::array<uint_t, 3>{ 0, std::numeric_limits<uint_t>::max(), 1 }});
+        blink.delegates.cycle = [](cell & cl) {
+            cl[of::VALUE] = uint_t(1u) - uint_t(cl[of::VALUE]);
+        };
+
+        isim.include_part(blink);
+        auto & model = isim.get_model();
+        model.resize(grid_t::MODEL_GRID, isim.part_of(PART[1]), dcoords_t(2, 2));
+        automaton.set_state(PARTICIPANT.no_one(), automaton::state::RUN);
+
+        std::array<double_t, 3> values{ };
+        REQUIRE(counter.read_probes(values) == 0u);
+
+        counter.set_probes({{ gcoords_t(grid_t::MODEL_GRID, 1, 1), of::VALUE },
+                            { gcoords_t(grid_t::MODEL_GRID, 1, 1), of::MOVED_UP },
+                            { gcoords_t(grid_t::MODEL_GRID, 5, 5), of::VALUE }});
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(counter.read_probes(values) == 1u);
+        REQUIRE(values[0] == 1.);
+        REQUIRE(std::isnan(values[1]));
+        REQUIRE(std::isnan(values[2]));
+
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(counter.read_probes(values) == 2u);
+        REQUIRE(values[0] == 0.);
+
+        counter.set_probes({{ gcoords_t(grid_t::MODEL_GRID, 0, 0), of::VALUE }});
+        REQUIRE(counter.read_probes(values) == 2u);
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(counter.read_probes(values) == 3u);
+        REQUIRE(values[0] == 1.);
+        REQUIRE(std::isnan(values[1]));
+
+        //The targets grow and shrink while being read, reads stay within the published values
+        std::atomic<bool_t> reading{ true };
+        std::atomic<uint_t> torn{ };
+        std::thread reader{ [&]() {
+            std::array<double_t, 3> value{ };
+            while (reading.load(std::memory_order_acquire)) {
+                auto published = counter.read_probes(value);
+                if (value[0] != double_t(published % 2u)) {
+                    torn.fetch_add(1u, std::memory_order_relaxed);
+                }
+            }
+        }};
+        for (uint_t i = 0; i < 100u; ++i) {
+            if (i % 2u) {
+                counter.set_probes({{ gcoords_t(grid_t::MODEL_GRID, 0, 0), of::VALUE }});
+            } else {
+                counter.set_probes({{ gcoords_t(grid_t::MODEL_GRID, 0, 0), of::VALUE },
+                                    { gcoords_t(grid_t::MODEL_GRID, 0, 1), of::VALUE },
+                                    { gcoords_t(grid_t::MODEL_GRID, 1, 0), of::VALUE }});
+            }
+            automaton.cycle();
+        }
+        reading.store(false, std::memory_order_release);
+        reader.join();
+        REQUIRE(torn == 0u);
+
+        isim.detach(id);
+    }
+
+    SECTION("Triggers are raised by changes of probed properties") {
+        counting_program counter{ };
+        auto id = isim.attach(counter);
+        isim.commence();
+
+        part blink{ PART[1] };
+        blink.add_entry(entry{ of::VALUE,
+                               text("__VALUE"),
+                               text("Blink value"),
+                               value(uint_t()),
+                               ui_access::VISIBLE,
+                               serialize::NO_SERIALIZE,
+                               std::array<uint_t, 3>{ 0, std::numeric_limits<uint_t>::max(), 1 }});
+        blink.delegates.cycle = [](cell & cl) {
+            cl[of::VALUE] = uint_t(1u) - uint_t(cl[of::VALUE]);
+        };
+
+        isim.include_part(blink);
+        auto & model = isim.get_model();
+        model.resize(grid_t::MODEL_GRID, isim.part_of(PART[1]), dcoords_t(2, 2));
+        automaton.set_state(PARTICIPANT.no_one(), automaton::state::RUN);
+
+        auto target = std::make_pair(gcoords_t(grid_t::MODEL_GRID, 1, 1), of::VALUE);
+        counter.set_trigger(0u, target, edge::RISE, .5);
+        counter.set_trigger(1u, target, edge::FALL, .5);
+        counter.set_trigger(2u, target, edge::BOTH, .5);
+        counter.set_trigger(3u, target, edge::LEVEL_LOW, .5);
+        REQUIRE_THROWS(counter.set_trigger(16u, target, edge::RISE, .5));
+
+        //Values after every cycle are 1, 0, 1, 0, 1, 0, 1
+        for (uint_t i = 0; i < 7u; ++i) {
+            REQUIRE_NOTHROW(automaton.cycle());
+        }
+        REQUIRE(counter.take_trigger(0u) == 3u);
+        REQUIRE(counter.take_trigger(1u) == 3u);
+        REQUIRE(counter.take_trigger(2u) == 6u);
+        REQUIRE(counter.take_trigger(3u) == 3u);
+        REQUIRE(counter.take_trigger(0u) == 0u);
+        REQUIRE(counter.take_trigger(4u) == 0u);
+
+        counter.clear_trigger(2u);
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(counter.take_trigger(1u) == 1u);
+        REQUIRE(counter.take_trigger(2u) == 0u);
+
+        isim.detach(id);
+    }
+
+    SECTION("Requests can be recorded and replayed") {
+        part tally{ PART[1] };
+        tally.add_entry(entry{ of::VALUE,
+                               text("__VALUE"),
+                               text("Tally value"),
+                               value(uint_t()),
+                               ui_access::VISIBLE,
+                               serialize::NO_SERIALIZE,
+                               std::array<uint_t, 3>{ 0, std::numeric_limits<uint_t>::max(), 1 }});
+        tally.delegates.cycle = [](cell & cl) {
+            cl[of::VALUE] = (uint_t(cl[of::VALUE]) * 3u + 1u) % 1000u;
+        };
+
+        auto run = [&](inner_simulation & sim, program & parti, bool_t requesting) {
+            sim.include_part(tally);
+            sim.get_model().resize(grid_t::MODEL_GRID, sim.part_of(PART[1]), dcoords_t(2, 2));
+            sim.commence();
+            sim.get_automaton().set_state(PARTICIPANT.no_one(), automaton::state::RUN);
+
+            std::vector<uint_t> states{ };
+            for (uint_t i = 0; i < 8u; ++i) {
+                if (requesting && (i == 2u || i == 5u)) {
+                    REQUEST(ctx, parti) {
+                        ctx.at(gcoords_t(grid_t::MODEL_GRID, 1, i % 2u))[of::VALUE] = uint_t(i);
+                    }
+                }
+                sim.get_automaton().cycle();
+                for (dcoords_t xy{ }; xy.in(dcoords_t(2, 2)); xy.rectangle(dcoords_t(2, 2))) {
+                    auto & gclb = sim.get_model().at(gcoords_t(grid_t::MODEL_GRID, xy));
+                    states.emplace_back(har::get<uint_t>(gclb.get(of::VALUE)));
+                }
+            }
+            return states;
+        };
+
+        std::stringstream log{ std::ios::in | std::ios::out | std::ios::binary };
+        automaton.get_journal().record(log);
+        auto recorded = run(isim, prog, true);
+        REQUIRE(automaton.cycles() == 8u);
+
+        inner_simulation replaying{ 0, nullptr, nullptr };
+        program idle{ };
+        replaying.attach(idle);
+        REQUIRE_NOTHROW(replaying.get_automaton().get_journal().replay(log));
+        auto replayed = run(replaying, idle, false);
+        REQUIRE(replayed == recorded);
+        REQUIRE_FALSE(replaying.get_automaton().get_journal().replaying());
+
+        std::stringstream garbage{ "HARX" };
+        REQUIRE_THROWS(journal().replay(garbage));
+    }
+
     SECTION("The automaton can keep tabs on how to process single cells") {
         part pt{ PART[0] };
         gcoords_t pos{ };
@@ -168,7 +455,9 @@ TEST_CASE("Automaton", "[!mayfail][automaton]") {
             auto & active = tab.get_active();
             auto & inactive = tab.get_inactive();
             for (dcoords_t xy{ }; xy.in(to.pos - 1); xy.rectangle(to.pos - 1)) {
-                REQUIRE_NOTHROW(inactive.at(gcoords_t(grid_t::MODEL_GRID, xy)));
+                gcoords_t ipos{ grid_t::MODEL_GRID, xy };
+                REQUIRE_NOTHROW(inactive.at(ipos));
+                REQUIRE(&inactive.at(ipos).get() == &model.at(ipos));
             }
             for (dcoord_t y = 0; y < to.pos.y; ++y) {
                 REQUIRE_NOTHROW(active.at(gcoords_t(grid_t::MODEL_GRID, to.pos.x - 1, y)));
@@ -213,6 +502,713 @@ TEST_CASE("Automaton", "[!mayfail][automaton]") {
         }
     }
 
+    SECTION("A sparse cycle only updates active cells") {
+        isim.commence();
+
+        part latch{ PART[1] };
+        latch.add_entry(entry{ of::VALUE,
+                               text("__VALUE"),
+                               text("Latch value"),
+                               value(uint_t()),
+                               ui_access::VISIBLE,
+                               serialize::NO_SERIALIZE,
+                               std::array<uint_t, 3>{ 0, std::numeric_limits<uint_t>::max(), 1 }});
+
+        std::atomic<uint_t> cycles{ };
+        latch.add_waking(of::VALUE);
+        latch.delegates.cycle = [&](cell & cl) {
+            cycles.fetch_add(1u, std::memory_order_relaxed);
+            if (uint_t(cl[of::VALUE]) == 0u) {
+                cl[of::VALUE] = uint_t(1u);
+            }
+        };
+
+        isim.include_part(latch);
+        auto & model = isim.get_model();
+        auto & tab = automaton.get_tab();
+        model.resize(grid_t::MODEL_GRID, isim.part_of(PART[1]), dcoords_t(3, 3));
+        automaton.set_schedule(automaton::schedule::SPARSE);
+        automaton.set_state(PARTICIPANT.no_one(), automaton::state::RUN);
+
+        REQUIRE(tab.get_active().size() == tab.size());
+
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(cycles == 9u);
+        for (auto &[pos, clb] : model.get_model()) {
+            REQUIRE(get<uint_t>(clb.get(of::VALUE)) == 1u);
+            REQUIRE_NOTHROW(tab.get_active().at(clb.position()));
+        }
+
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(cycles == 18u);
+        for (auto &[pos, clb] : model.get_model()) {
+            REQUIRE_THROWS(tab.get_active().at(clb.position()));
+        }
+
+        //Inactive cells are not cycled
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(cycles == 18u);
+
+        //A changed cell wakes up itself and the neighbors waking on the changed entry
+        gcoords_t center{ grid_t::MODEL_GRID, 1, 1 };
+        auto woken = [&]() {
+            REQUIRE(tab.get_active().size() == 5u);
+            REQUIRE_NOTHROW(tab.get_active().at(center));
+            for (auto dir : direction::cardinal) {
+                REQUIRE_NOTHROW(tab.get_active().at(model.at(center).get_neighbor(dir)->position()));
+            }
+        };
+        REQUEST(ctx, prog) {
+            ctx.at(center)[of::VALUE] = uint_t(0u);
+        }
+        woken();
+
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(cycles == 23u);
+        REQUIRE(get<uint_t>(model.at(center).get(of::VALUE)) == 1u);
+        woken();
+
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(cycles == 28u);
+        REQUIRE(tab.get_active().empty());
+
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(cycles == 28u);
+    }
+
+    SECTION("Runs of cells of the same part can be cycled in batches") {
+        isim.commence();
+
+        part runs{ PART[1], text("runs"), traits::COMPONENT_PART };
+        part single{ PART[2], text("single"), traits::COMPONENT_PART };
+        for (part * pt : { &runs, &single }) {
+            pt->add_entry(entry{ of::VALUE,
+                                 text("__VALUE"),
+                                 text("Counter value"),
+                                 value(uint_t()),
+                                 ui_access::VISIBLE,
+                                 serialize::NO_SERIALIZE,
+                                 std::array<uint_t, 3>{ 0, std::numeric_limits<uint_t>::max(), 1 }});
+        }
+
+        std::atomic<uint_t> batches{ 0u };
+        std::atomic<uint_t> batched{ 0u };
+        std::atomic<bool_t> mixed{ false };
+        runs.delegates.cycle = [](cell & cl) {
+            cl[of::VALUE] = uint_t(cl[of::VALUE]) + 1u;
+        };
+        runs.delegates.cycle_batch = [&](cell_batch & cells) {
+            ++batches;
+            batched += cells.size();
+            cells.for_each([&](cell & cl) {
+                if (cl.logic().id() != PART[1]) {
+                    mixed = true;
+                }
+                cl[of::VALUE] = uint_t(cl[of::VALUE]) + 1u;
+            });
+        };
+        single.delegates.cycle = [](cell & cl) {
+            cl[of::VALUE] = uint_t(cl[of::VALUE]) + 2u;
+        };
+
+        isim.include_part(runs);
+        isim.include_part(single);
+        auto & model = isim.get_model();
+        model.resize(grid_t::MODEL_GRID, isim.part_of(PART[1]), dcoords_t(4, 4));
+        for (auto &[pos, clb] : model.get_model()) {
+            if (pos.x / 2 % 2) {
+                clb.set_type(isim.part_of(PART[2]));
+            }
+        }
+
+        REQUIRE_FALSE(automaton.set_batched(true));
+        REQUIRE(automaton.batched());
+        automaton.set_state(PARTICIPANT.no_one(), automaton::state::RUN);
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE_NOTHROW(automaton.cycle());
+
+        REQUIRE(batches >= 2u * 4u);
+        REQUIRE(batched == 2u * 8u);
+        REQUIRE_FALSE(mixed);
+        for (auto &[pos, clb] : model.get_model()) {
+            REQUIRE(get<uint_t>(clb.get(of::VALUE)) == (pos.x / 2 % 2 ? 4u : 2u));
+        }
+    }
+
+    SECTION("Fields of a part are cycled by their kernel") {
+        isim.commence();
+
+        part life{ PART[1], text("life"), traits::COMPONENT_PART };
+        part wall{ PART[2], text("wall"), traits::COMPONENT_PART };
+        for (part * pt : { &life, &wall }) {
+            pt->add_entry(entry{ of::VALUE,
+                                 text("__ALIVE"),
+                                 text("Alive"),
+                                 value(bool_t()),
+                                 ui_access::VISIBLE,
+                                 serialize::NO_SERIALIZE });
+        }
+
+        std::atomic<bool_t> cycled{ false };
+        life.delegates.cycle = [&](cell & cl) {
+            cycled = true;
+        };
+        REQUIRE_THROWS(life.set_field(of::VALUE, field_kernel<double_t>()));
+        life.set_field(of::VALUE, [](const field<bool_t> & in, field<bool_t> & out) {
+            std::vector<std::uint8_t> counts(in.width());
+            for (std::size_t y = 0u; y < in.height(); ++y) {
+                moore_count(in, y, counts.data());
+                auto alive = in.row(y);
+                auto mask = in.mask(y);
+                auto next = out.row(y);
+                for (std::size_t x = 0u; x < in.width(); ++x) {
+                    next[x] = mask[x] && (counts[x] == 3u || (alive[x] && counts[x] == 2u));
+                }
+            }
+        });
+        REQUIRE(life.field_id() == of::VALUE);
+
+        isim.include_part(life);
+        isim.include_part(wall);
+        auto & model = isim.get_model();
+        model.resize(grid_t::MODEL_GRID, isim.part_of(PART[1]), dcoords_t(5, 5));
+        auto & grid = model.get_model();
+        //The wall isn't part of the field, so it doesn't count as neighbor
+        grid.at(dcoords_t(3, 3)).set_type(isim.part_of(PART[2]));
+        for (auto pos : { dcoords_t(2, 1), dcoords_t(2, 2), dcoords_t(2, 3), dcoords_t(3, 3) }) {
+            grid.at(pos).set(of::VALUE, value(true));
+            grid.at(pos).transit();
+        }
+
+        auto alive = [&]() {
+            std::set<std::pair<int_t, int_t>> cells{ };
+            for (auto &[pos, clb] : grid) {
+                if (&clb.logic() == &isim.part_of(PART[1]) && get<bool_t>(clb.get(of::VALUE))) {
+                    cells.emplace(pos.x.v, pos.y.v);
+                }
+            }
+            return cells;
+        };
+
+        automaton.set_state(PARTICIPANT.no_one(), automaton::state::RUN);
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(alive() == std::set<std::pair<int_t, int_t>>{{ 1, 2 }, { 2, 2 }, { 3, 2 }});
+        REQUIRE(get<bool_t>(grid.at(dcoords_t(3, 3)).get(of::VALUE)));
+
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(alive() == std::set<std::pair<int_t, int_t>>{{ 2, 1 }, { 2, 2 }, { 2, 3 }});
+        REQUIRE_FALSE(cycled);
+    }
+
+    SECTION("Fields are only cycled while one of their cells is active") {
+        isim.commence();
+
+        part latch{ PART[1], text("latch"), traits::COMPONENT_PART };
+        latch.add_entry(entry{ of::VALUE,
+                               text("__SET"),
+                               text("Set"),
+                               value(bool_t()),
+                               ui_access::VISIBLE,
+                               serialize::NO_SERIALIZE });
+        uint_t kernels = 0u;
+        latch.set_field(of::VALUE, [&kernels](const field<bool_t> & in, field<bool_t> & out) {
+            ++kernels;
+            for (std::size_t n = 0u; n < in.size(); ++n) {
+                out[n] = in.covers(n);
+            }
+        });
+
+        isim.include_part(latch);
+        auto & model = isim.get_model();
+        auto & tab = automaton.get_tab();
+        model.resize(grid_t::MODEL_GRID, isim.part_of(PART[1]), dcoords_t(3, 3));
+        automaton.set_schedule(automaton::schedule::SPARSE);
+        automaton.set_state(PARTICIPANT.no_one(), automaton::state::RUN);
+
+        //The set cells wake up once more, after which none of them is active
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(kernels == 1u);
+        for (auto &[pos, clb] : model.get_model()) {
+            REQUIRE(get<bool_t>(clb.get(of::VALUE)));
+        }
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(kernels == 2u);
+        REQUIRE(tab.get_active().empty());
+
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(kernels == 2u);
+    }
+
+    SECTION("Voltages settle on nets of connected cells within one cycle") {
+        isim.commence();
+
+        part pin{ PART[1], text("pin"), traits::COMPONENT_PART };
+        for (auto id : { of::POWERING_PIN, of::POWERED_PIN }) {
+            pin.add_entry(entry{ id,
+                                 text("__PIN"),
+                                 text("Pin"),
+                                 value(double_t()),
+                                 ui_access::VISIBLE,
+                                 serialize::NO_SERIALIZE });
+        }
+        REQUIRE_THROWS(pin.set_net(of::VALUE));
+        pin.set_net(of::POWERING_PIN, of::POWERED_PIN);
+        REQUIRE(pin.net_drive() == of::POWERING_PIN);
+        REQUIRE(pin.net_sense() == of::POWERED_PIN);
+
+        isim.include_part(pin);
+        auto & model = isim.get_model();
+        model.resize(grid_t::MODEL_GRID, isim.part_of(PART[1]), dcoords_t(6, 2));
+        auto & grid = model.get_model();
+        for (auto &[pos, clb] : grid) {
+            clb.set(of::POWERING_PIN, value(pos == dcoords_t(0, 0) ? 5. : std::nan("1")));
+            clb.transit();
+        }
+        //A chain of pins, which took one cycle per pin to pass a voltage on
+        for (int_t x = 0; x < 5; ++x) {
+            grid.at(dcoords_t(x, 0)).add_connection(direction::PIN[0], grid.at(dcoords_t(x + 1, 0)));
+        }
+
+        auto powered = [&](int_t x, int_t y) {
+            return get<double_t>(grid.at(dcoords_t(x, y)).get(of::POWERED_PIN));
+        };
+        auto & nets = automaton.get_nets();
+
+        automaton.set_state(PARTICIPANT.no_one(), automaton::state::RUN);
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(nets.size() == 1u);
+        for (int_t x = 0; x < 6; ++x) {
+            REQUIRE(powered(x, 0) == 5.);
+            REQUIRE(powered(x, 1) == 0.);
+        }
+
+        //Removing a connection splits the net, the part without a driver floats
+        REQUEST(ctx, prog) {
+            ctx.at(gcoords_t(grid_t::MODEL_GRID, 2, 0)).remove_connection(direction::PIN[0]);
+        }
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(nets.size() == 2u);
+        REQUIRE_FALSE(nets.joined(grid.at(dcoords_t(2, 0)), grid.at(dcoords_t(3, 0))));
+        for (int_t x = 0; x < 3; ++x) {
+            REQUIRE(powered(x, 0) == 5.);
+        }
+        for (int_t x = 3; x < 6; ++x) {
+            REQUIRE(std::isnan(powered(x, 0)));
+        }
+
+        //Adding one joins the nets again, which resolve to the mean of their drivers
+        REQUEST(ctx, prog) {
+            ctx.at(gcoords_t(grid_t::MODEL_GRID, 5, 0)).add_connection(direction::PIN[0],
+                                                                      ctx.at(gcoords_t(grid_t::MODEL_GRID, 5, 1)));
+            ctx.at(gcoords_t(grid_t::MODEL_GRID, 5, 1))[of::POWERING_PIN] = 1.;
+            ctx.at(gcoords_t(grid_t::MODEL_GRID, 2, 0)).add_connection(direction::PIN[0],
+                                                                      ctx.at(gcoords_t(grid_t::MODEL_GRID, 3, 0)));
+        }
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(nets.size() == 1u);
+        for (int_t x = 0; x < 6; ++x) {
+            REQUIRE(powered(x, 0) == Approx(3.));
+        }
+        REQUIRE(powered(5, 1) == Approx(3.));
+        REQUIRE(powered(0, 1) == 0.);
+    }
+
+    SECTION("Terminals of a component that doesn't take part in nets stay on separate nets") {
+        isim.commence();
+
+        part pin{ PART[1], text("pin"), traits::COMPONENT_PART };
+        for (auto id : { of::POWERING_PIN, of::POWERED_PIN }) {
+            pin.add_entry(entry{ id,
+                                 text("__PIN"),
+                                 text("Pin"),
+                                 value(double_t()),
+                                 ui_access::VISIBLE,
+                                 serialize::NO_SERIALIZE });
+        }
+        pin.set_net(of::POWERING_PIN, of::POWERED_PIN);
+        part led{ PART[2], text("led"), traits::COMPONENT_PART };
+        led.add_connection_uses({{ direction::PIN[0], text("Anode") },
+                                 { direction::PIN[1], text("Cathode") }});
+        REQUIRE(pin.in_net());
+        REQUIRE_FALSE(led.in_net());
+
+        isim.include_part(pin);
+        isim.include_part(led);
+        auto & model = isim.get_model();
+        model.resize(grid_t::MODEL_GRID, isim.part_of(PART[1]), dcoords_t(3, 2));
+        auto & grid = model.get_model();
+        grid.at(dcoords_t(1, 0)).set_type(isim.part_of(PART[2]));
+        for (auto &[pos, clb] : grid) {
+            if (clb.has(of::POWERING_PIN)) {
+                clb.set(of::POWERING_PIN, value(pos == dcoords_t(0, 0) ? 5. :
+                                                pos == dcoords_t(2, 0) ? 1. : std::nan("1")));
+                clb.transit();
+            }
+        }
+        //Two driven pins on the terminals of the component, each with a pin sensing it
+        grid.at(dcoords_t(1, 0)).add_connection(direction::PIN[0], grid.at(dcoords_t(0, 0)));
+        grid.at(dcoords_t(1, 0)).add_connection(direction::PIN[1], grid.at(dcoords_t(2, 0)));
+        grid.at(dcoords_t(0, 0)).add_connection(direction::PIN[0], grid.at(dcoords_t(0, 1)));
+        grid.at(dcoords_t(2, 0)).add_connection(direction::PIN[0], grid.at(dcoords_t(2, 1)));
+
+        auto powered = [&](int_t x, int_t y) {
+            return get<double_t>(grid.at(dcoords_t(x, y)).get(of::POWERED_PIN));
+        };
+        auto & nets = automaton.get_nets();
+
+        automaton.set_state(PARTICIPANT.no_one(), automaton::state::RUN);
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(nets.size() == 2u);
+        REQUIRE(nets.joined(grid.at(dcoords_t(0, 0)), grid.at(dcoords_t(0, 1))));
+        REQUIRE_FALSE(nets.joined(grid.at(dcoords_t(0, 0)), grid.at(dcoords_t(2, 0))));
+        REQUIRE_FALSE(nets.joined(grid.at(dcoords_t(0, 0)), grid.at(dcoords_t(1, 0))));
+        REQUIRE(powered(0, 0) == 5.);
+        REQUIRE(powered(0, 1) == 5.);
+        REQUIRE(powered(2, 0) == 1.);
+        REQUIRE(powered(2, 1) == 1.);
+
+        //A connection added later through the component doesn't join the nets either
+        REQUEST(ctx, prog) {
+            ctx.at(gcoords_t(grid_t::MODEL_GRID, 1, 1)).add_connection(direction::PIN[0],
+                                                                      ctx.at(gcoords_t(grid_t::MODEL_GRID, 1, 0)));
+        }
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(nets.size() == 2u);
+        REQUIRE(powered(0, 1) == 5.);
+        REQUIRE(powered(2, 1) == 1.);
+    }
+
+    SECTION("Endpoints sense the nets they are connected to without joining them") {
+        isim.commence();
+
+        part pin{ PART[1], text("pin"), traits::COMPONENT_PART };
+        part led{ PART[2], text("led"), traits::COMPONENT_PART };
+        for (auto * pt : { &pin, &led }) {
+            for (auto id : { of::POWERING_PIN, of::POWERED_PIN }) {
+                pt->add_entry(entry{ id,
+                                     text("__PIN"),
+                                     text("Pin"),
+                                     value(double_t()),
+                                     ui_access::VISIBLE,
+                                     serialize::NO_SERIALIZE });
+            }
+        }
+        pin.set_net(of::POWERING_PIN, of::POWERED_PIN);
+        led.set_net(of::POWERING_PIN, of::POWERED_PIN, false);
+        led.add_connection_uses({{ direction::PIN[0], text("Anode") },
+                                 { direction::PIN[1], text("Cathode") }});
+        REQUIRE(led.in_net());
+        REQUIRE_FALSE(led.joins_nets());
+        REQUIRE(led.net_drive() == of::VOID);
+
+        isim.include_part(pin);
+        isim.include_part(led);
+        auto & model = isim.get_model();
+        model.resize(grid_t::MODEL_GRID, isim.part_of(PART[1]), dcoords_t(3, 2));
+        auto & grid = model.get_model();
+        for (auto pos : { dcoords_t(1, 0), dcoords_t(1, 1) }) {
+            grid.at(pos).set_type(isim.part_of(PART[2]));
+        }
+        for (auto &[pos, clb] : grid) {
+            clb.set(of::POWERING_PIN, value(pos == dcoords_t(0, 0) ? 5. :
+                                            pos == dcoords_t(2, 0) ? 1. : std::nan("1")));
+            clb.set(of::POWERED_PIN, value(0.));
+            clb.transit();
+        }
+        grid.at(dcoords_t(1, 0)).add_connection(direction::PIN[0], grid.at(dcoords_t(0, 0)));
+        grid.at(dcoords_t(1, 0)).add_connection(direction::PIN[1], grid.at(dcoords_t(2, 0)));
+
+        auto powered = [&](int_t x, int_t y) {
+            return get<double_t>(grid.at(dcoords_t(x, y)).get(of::POWERED_PIN));
+        };
+        auto & nets = automaton.get_nets();
+
+        automaton.set_state(PARTICIPANT.no_one(), automaton::state::RUN);
+        REQUIRE_NOTHROW(automaton.cycle());
+        //Connected only through the endpoint, each pin stays a net of its own
+        REQUIRE(nets.size() == 0u);
+        REQUIRE_FALSE(nets.joined(grid.at(dcoords_t(0, 0)), grid.at(dcoords_t(2, 0))));
+        REQUIRE(powered(1, 0) == 5.);
+        REQUIRE(std::isnan(powered(1, 1)));
+
+        //Without the higher one, the endpoint senses the lower one
+        REQUEST(ctx, prog) {
+            ctx.at(gcoords_t(grid_t::MODEL_GRID, 1, 0)).remove_connection(direction::PIN[0]);
+        }
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(powered(1, 0) == 1.);
+    }
+
+    SECTION("Changes of a cycle are committed and drawn as one batch") {
+        counting_program counter{ };
+        auto id = isim.attach(counter);
+        isim.commence();
+
+        part blink{ PART[1] };
+        blink.add_entry(entry{ of::VALUE,
+                               text("__VALUE"),
+                               text("Blink value"),
+                               value(uint_t()),
+                               ui_access::VISIBLE,
+                               serialize::NO_SERIALIZE,
+                               std::array<uint_t, 3>{ 0, std::numeric_limits<uint_t>::max(), 1 }});
+        blink.add_visual(of::VALUE);
+        blink.delegates.cycle = [](cell & cl) {
+            cl[of::VALUE] = uint_t(1u) - uint_t(cl[of::VALUE]);
+        };
+
+        isim.include_part(blink);
+        auto & model = isim.get_model();
+        model.resize(grid_t::MODEL_GRID, isim.part_of(PART[1]), dcoords_t(4, 4));
+        counter.select(gcoords_t(grid_t::MODEL_GRID, 1, 1));
+        automaton.set_state(PARTICIPANT.no_one(), automaton::state::RUN);
+
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(counter.redraws == 16u);
+        REQUIRE(counter.batches == 1u);
+        REQUIRE(counter.updates == 1u);
+        REQUIRE(counter.commits == 1u);
+        for (auto &[pos, clb] : model.get_model()) {
+            REQUIRE(get<uint_t>(clb.get(of::VALUE)) == 1u);
+        }
+
+        counter.images = false;
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(counter.redraws == 16u);
+        REQUIRE(counter.batches == 1u);
+        REQUIRE(counter.updates == 2u);
+        REQUIRE(counter.commits == 2u);
+
+        isim.detach(id);
+    }
+
+    SECTION("Cells out of view are drawn once they are displayed") {
+        counting_program counter{ };
+        auto id = isim.attach(counter);
+        isim.commence();
+
+        part blink{ PART[1] };
+        blink.add_entry(entry{ of::VALUE,
+                               text("__VALUE"),
+                               text("Blink value"),
+                               value(uint_t()),
+                               ui_access::VISIBLE,
+                               serialize::NO_SERIALIZE,
+                               std::array<uint_t, 3>{ 0, std::numeric_limits<uint_t>::max(), 1 }});
+        blink.add_visual(of::VALUE);
+        blink.delegates.cycle = [](cell & cl) {
+            cl[of::VALUE] = uint_t(1u) - uint_t(cl[of::VALUE]);
+        };
+
+        isim.include_part(blink);
+        auto & model = isim.get_model();
+        model.resize(grid_t::MODEL_GRID, isim.part_of(PART[1]), dcoords_t(4, 4));
+        automaton.set_state(PARTICIPANT.no_one(), automaton::state::RUN);
+
+        counter.set_viewport(grid_t::MODEL_GRID, dcoords_t(0, 0), dcoords_t(2, 2));
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(counter.redraws == 4u);
+
+        counter.reset_viewport(grid_t::MODEL_GRID);
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(counter.redraws == 20u);
+
+        counter.set_drawing(false);
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(counter.redraws == 20u);
+        REQUIRE(counter.commits == 3u);
+
+        counter.set_drawing(true);
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(counter.redraws == 36u);
+
+        isim.detach(id);
+    }
+
+    SECTION("Cells scrolled into view are drawn while the automaton is stopped") {
+        counting_program counter{ };
+        auto id = isim.attach(counter);
+        isim.commence();
+
+        part blink{ PART[1] };
+        blink.add_entry(entry{ of::VALUE,
+                               text("__VALUE"),
+                               text("Blink value"),
+                               value(uint_t()),
+                               ui_access::VISIBLE,
+                               serialize::NO_SERIALIZE,
+                               std::array<uint_t, 3>{ 0, std::numeric_limits<uint_t>::max(), 1 }});
+        blink.add_visual(of::VALUE);
+        blink.delegates.cycle = [](cell & cl) {
+            cl[of::VALUE] = uint_t(1u) - uint_t(cl[of::VALUE]);
+        };
+
+        isim.include_part(blink);
+        auto & model = isim.get_model();
+        model.resize(grid_t::MODEL_GRID, isim.part_of(PART[1]), dcoords_t(4, 4));
+        automaton.set_state(PARTICIPANT.no_one(), automaton::state::STEP);
+
+        counter.set_viewport(grid_t::MODEL_GRID, dcoords_t(0, 0), dcoords_t(2, 2));
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(automaton.state() == automaton::state::STOP);
+        REQUIRE(counter.redraws == 4u);
+
+        counter.set_viewport(grid_t::MODEL_GRID, dcoords_t(0, 0), dcoords_t(4, 2));
+        REQUIRE(counter.redraws == 8u);
+
+        counter.set_viewport(grid_t::MODEL_GRID, dcoords_t(0, 0), dcoords_t(4, 2));
+        REQUIRE(counter.redraws == 8u);
+
+        counter.reset_viewport(grid_t::MODEL_GRID);
+        REQUIRE(counter.redraws == 16u);
+
+        isim.detach(id);
+    }
+
+    SECTION("Cells that look alike are drawn once") {
+        keeping_program keeper{ };
+        auto id = isim.attach(keeper);
+        isim.commence();
+
+        std::atomic<uint_t> draws{ };
+        part blink{ PART[1] };
+        blink.add_entry(entry{ of::VALUE,
+                               text("__VALUE"),
+                               text("Blink value"),
+                               value(uint_t()),
+                               ui_access::VISIBLE,
+                               serialize::NO_SERIALIZE,
+                               std::array<uint_t, 3>{ 0, std::numeric_limits<uint_t>::max(), 1 }});
+        blink.add_visual(of::VALUE);
+        blink.delegates.cycle = [](cell & cl) {
+            cl[of::VALUE] = uint_t(1u) - uint_t(cl[of::VALUE]);
+        };
+        blink.delegates.draw = [&draws](cell & cl, image_t & img) {
+            ++draws;
+        };
+        blink.set_shared_images();
+
+        isim.include_part(blink);
+        auto & model = isim.get_model();
+        model.resize(grid_t::MODEL_GRID, isim.part_of(PART[1]), dcoords_t(4, 4));
+        automaton.set_state(PARTICIPANT.no_one(), automaton::state::RUN);
+
+        //prog keeps no images, so its 16 cells are drawn every cycle
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE_NOTHROW(automaton.cycle());
+        auto drawn = draws.load() - 32u;
+        REQUIRE(drawn >= 2u);
+        REQUIRE(drawn <= 32u);
+        REQUIRE(keeper.kept.size() == 2u);
+
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(draws == drawn + 64u);
+        REQUIRE(keeper.redraws == 64u);
+
+        isim.detach(id);
+    }
+
+    SECTION("Cargo is moved by the cells under it without overlapping") {
+        counting_program counter{ };
+        auto id = isim.attach(counter);
+        isim.commence();
+
+        part belt{ PART[1] };
+        belt.add_entry(entry{ of::MOVED_LEFT, text("__MOVED_LEFT"), text("Speed"),
+                              value(double_t(.5)), ui_access::VISIBLE, serialize::SERIALIZE });
+        part box{ PART[2] };
+
+        isim.include_part(belt);
+        isim.include_part(box);
+        auto & model = isim.get_model();
+        model.resize(grid_t::MODEL_GRID, isim.part_of(PART[1]), dcoords_t(4, 2));
+        auto & stop = model.at(gcoords_t(grid_t::MODEL_GRID, 3, 0));
+        stop.set(of::MOVED_LEFT, value(double_t(0.)));
+        stop.transit();
+
+        auto spawn = [&](double_t x, double_t y) {
+            return model.add_cargo(isim.part_of(PART[2]), ccoords_t(x, y)).id();
+        };
+        auto stopped = spawn(3.5, .5);
+        auto behind = spawn(2.5, .5);
+        auto last = spawn(1.5, .5);
+        auto free = spawn(.5, 1.5);
+        automaton.set_state(PARTICIPANT.no_one(), automaton::state::RUN);
+
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(model.at(stopped).position() == ccoords_t(3.5, .5));
+        REQUIRE(model.at(behind).position() == ccoords_t(2.5, .5));
+        REQUIRE(model.at(last).position() == ccoords_t(1.5, .5));
+        REQUIRE(model.at(free).position() == ccoords_t(1., 1.5));
+        REQUIRE(model.get_model().at(dcoords_t(1, 1)).cargo().count(free));
+        REQUIRE(model.get_model().at(dcoords_t(0, 1)).artifacts().count(free));
+        REQUIRE(counter.moves == 1u);
+
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(model.at(free).position() == ccoords_t(1.5, 1.5));
+        REQUIRE(model.get_model().at(dcoords_t(0, 1)).artifacts().empty());
+        REQUIRE(counter.moves == 2u);
+
+        isim.detach(id);
+    }
+
+    SECTION("Spawned and destroyed cargo reuses its slots") {
+        counting_program counter{ };
+        auto id = isim.attach(counter);
+        isim.commence();
+
+        part box{ PART[2] };
+        box.delegates.cycle = [](cell & cl) {
+            cl.as_cargo_cell().destroy();
+        };
+        isim.include_part(box);
+        part source{ PART[1] };
+        source.delegates.cycle = [&isim](cell & cl) {
+            cl.as_grid_cell().spawn(isim.part_of(PART[2]));
+        };
+        isim.include_part(source);
+        auto & model = isim.get_model();
+        model.resize(grid_t::MODEL_GRID, isim.part_of(PART[1]), dcoords_t(1, 1));
+        automaton.set_state(PARTICIPANT.no_one(), automaton::state::RUN);
+
+        for (uint_t i = 0; i < 8u; ++i) {
+            REQUIRE_NOTHROW(automaton.cycle());
+            REQUIRE(model.cargo().size() == 1u);
+        }
+        REQUIRE(counter.spawns == 8u);
+        REQUIRE(counter.destroys == 7u);
+        REQUIRE(model.cargo().capacity() == 2u);
+        REQUIRE(model.get_model().at(dcoords_t(0, 0)).cargo().size() == 1u);
+
+        isim.detach(id);
+    }
+
+    SECTION("Cargo left outside of a shrunk grid is destroyed") {
+        counting_program counter{ };
+        auto id = isim.attach(counter);
+        isim.commence();
+
+        part box{ PART[2] };
+        isim.include_part(box);
+        auto & model = isim.get_model();
+        model.resize(grid_t::MODEL_GRID, isim.part_of(PART[0]), dcoords_t(4, 2));
+        auto kept = model.add_cargo(isim.part_of(PART[2]), ccoords_t(.5, .5)).id();
+        auto lost = model.add_cargo(isim.part_of(PART[2]), ccoords_t(3.5, .5)).id();
+        automaton.set_state(PARTICIPANT.no_one(), automaton::state::RUN);
+
+        REQUEST(ctx, counter) {
+            ctx.resize_grid(gcoords_t(grid_t::MODEL_GRID, 2, 2));
+        }
+        REQUIRE(model.cargo().size() == 1u);
+        REQUIRE(model.cargo().count(kept));
+        REQUIRE_FALSE(model.cargo().count(lost));
+        REQUIRE(model.get_model().at(dcoords_t(0, 0)).cargo().count(kept));
+        REQUIRE(counter.destroys == 1u);
+
+        isim.detach(id);
+    }
+
     SECTION("The automaton can be interrupted by requests from programs") {
         FAIL("Not implemented");
     }
@@ -229,3 +1225,36 @@ TEST_CASE("Automaton", "[!mayfail][automaton]") {
         FAIL("Not implemented");
     }
 }
+
+TEST_CASE("Scheduler", "[automaton][scheduler]") {
+    scheduler sched{ 2u };
+    std::vector<uint_t> visited(1000u, 0u);
+    auto process = [&](uint_t first, uint_t last) {
+        for (uint_t i = first; i < last; ++i) {
+            ++visited[i];
+        }
+    };
+
+    SECTION("Every cell is processed exactly once") {
+        sched.distribute(uint_t(visited.size()));
+        sched.run(0u, process);
+        sched.run(1u, process);
+        sched.settle();
+
+        REQUIRE(std::all_of(visited.begin(), visited.end(), [](uint_t v) { return v == 1u; }));
+        REQUIRE(sched.stats_of(0u).chunks_done > 0u);
+        REQUIRE(sched.stats_of(1u).chunks_done == 0u);
+    }
+
+    SECTION("Idle workers steal remaining chunks") {
+        sched.distribute(uint_t(visited.size()));
+        sched.run(1u, process);
+
+        REQUIRE(std::all_of(visited.begin(), visited.end(), [](uint_t v) { return v == 1u; }));
+        REQUIRE(sched.stats_of(1u).chunks_stolen > 0u);
+        REQUIRE(sched.stats_of(1u).chunks_stolen < sched.stats_of(1u).chunks_done);
+
+        sched.reset_stats();
+        REQUIRE(sched.stats_of(1u).chunks_done == 0u);
+    }
+}
@@ -5,6 +5,7 @@
 #include <har/grid_cell.hpp>
 
 #include "logic/context.hpp"
+#include "logic/inner_simulation.hpp"
 #include "world/grid_cell_base.hpp"
 
 #include "static_for.hpp"
@@ -148,7 +149,7 @@ struct variant_type_iterator {
                 for (auto & [num, ccl] : gcl.cargo()) {
                     type t = get<type>(values.at(count));
                     REQUIRE_NOTHROW(ccl[id] = t);
-                    const type & tr = get<type>(cclbs.at(count).intermediate().at(id));
+                    const type tr = get<type>(cclbs.at(count).intermediate().at(id));
                     if constexpr(!std::is_same_v<special_t, type>) {
                         REQUIRE(tr == t);
                     } else {
@@ -215,14 +216,23 @@ TEST_CASE("Grid cells") {
     artis.reserve(size);
 
     SECTION("Cargos can be spawned from contexts") {
-        cargo_cell ccl = gcl.spawn(gcl.logic(), offset);
+        //Spawned cargo is reserved in the context's model
+        inner_simulation isim{ 0, nullptr, nullptr };
+        isim.get_model().resize(MODEL_GRID, pt, dcoords_t(1, 1));
+        context mctx{ isim.get_model() };
+        grid_cell mgcl{ mctx, isim.get_model().at(gcoords_t(MODEL_GRID, 0, 0)) };
+        cargo_cell ccl = mgcl.spawn(mgcl.logic(), offset);
 
-        REQUIRE(ctx.spawned().size() == 1u);
+        REQUIRE(mctx.spawned().size() == 1u);
 
-        cargo_cell_base & cclb = *ctx.spawned().at(0);
+        cargo_cell_base & cclb = isim.get_model().cargo().at(mctx.spawned().at(0));
 
         REQUIRE(cclb.position() == offset);
-        REQUIRE(cclb.position() == ccoords_t(clb.position().pos) + offset);
+        REQUIRE(cclb.position() == ccoords_t(dcoords_t(0, 0)) + offset);
+        REQUIRE(!isim.get_model().cargo().count(cclb.id()));
+
+        mctx.reset();
+        REQUIRE_THROWS(isim.get_model().cargo().at(cclb.id()));
     }
 
     SECTION("Cargos can be moved from contexts") {
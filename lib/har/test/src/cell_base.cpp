@@ -5,6 +5,7 @@
 #include <har/coords.hpp>
 
 #include "world/grid_cell_base.hpp"
+#include "world/world.hpp"
 
 #include "static_for.hpp"
 
@@ -124,6 +125,93 @@ TEST_CASE("Grid cell bases", "[cell_base][grid_cell_base]") {
     }
 }
 
+TEST_CASE("Slotted cell bases", "[cell_base]") {
+    part pt{ PART[1] };
+    pt.add_entry(entry{ of::VALUE, text("__VALUE"), text("Value"),
+                        value(uint_t(1u)), ui_access::VISIBLE, serialize::SERIALIZE });
+    pt.add_entry(entry{ of::NAME, text("__NAME"), text("Name"),
+                        value(string_t()), ui_access::VISIBLE, serialize::SERIALIZE });
+    cell_base clb{ pt };
+
+    SECTION("Properties of the part's model are stored in slots") {
+        REQUIRE(pt.layout().size() == 2u);
+        REQUIRE(pt.slot_of(of::VALUE) == 0u);
+        REQUIRE(pt.slot_of(of::NAME) == 1u);
+        REQUIRE(pt.slot_of(of::COLOR) == part::NO_SLOT);
+        REQUIRE(get<uint_t>(clb.get(of::VALUE)) == 1u);
+        REQUIRE(clb.has(of::VALUE));
+        REQUIRE(!clb.has(of::COLOR));
+    }
+
+    SECTION("Slotted properties can be written, transited and rolled back") {
+        clb.set(of::VALUE, value(uint_t(2u)));
+        REQUIRE(clb.has_intermediate());
+        REQUIRE(clb.intermediate().size() == 1u);
+        REQUIRE(get<uint_t>(clb.get(of::VALUE, true)) == 2u);
+        REQUIRE(get<uint_t>(clb.get(of::VALUE, false)) == 1u);
+
+        clb.rollback();
+        REQUIRE(!clb.has_intermediate());
+        REQUIRE(get<uint_t>(clb.get(of::VALUE, true)) == 1u);
+
+        clb.set(of::VALUE, value(uint_t(3u)));
+        clb.set(of::COLOR, value(uint_t(4u)));
+        clb.transit();
+        REQUIRE(!clb.has_intermediate());
+        REQUIRE(get<uint_t>(clb.get(of::VALUE)) == 3u);
+        REQUIRE(get<uint_t>(clb.get(of::COLOR)) == 4u);
+        REQUIRE(clb.properties().size() == 3u);
+    }
+
+    SECTION("Committing flips the buffers of written slots only") {
+        clb.set(of::VALUE, value(uint_t(2u)));
+        clb.transit();
+        clb.set(of::VALUE, value(uint_t(3u)));
+        REQUIRE(get<uint_t>(clb.get(of::VALUE, false)) == 2u);
+        REQUIRE(get<uint_t>(clb.get(of::VALUE, true)) == 3u);
+
+        clb.transit();
+        REQUIRE(get<uint_t>(clb.get(of::VALUE)) == 3u);
+        REQUIRE(get<string_t>(clb.get(of::NAME)).empty());
+    }
+
+    SECTION("Cells with equal visual properties look alike") {
+        pt.add_visual(of::VALUE);
+        cell_base other{ pt };
+        REQUIRE_FALSE(clb.look(true).has_value());
+
+        pt.set_shared_images();
+        REQUIRE(clb.look(true).has_value());
+        REQUIRE(clb.look(true) == other.look(true));
+        REQUIRE(clb.look(true) != other.look(false));
+
+        other.set(of::NAME, value(string_t(text("other"))));
+        other.transit();
+        REQUIRE(clb.look(true) == other.look(true));
+
+        other.set(of::VALUE, value(uint_t(2u)));
+        other.transit();
+        REQUIRE(clb.look(true) != other.look(true));
+
+        pt.add_visual(of::COLOR);
+        clb.set(of::COLOR, value(special_t()));
+        clb.transit();
+        REQUIRE(!clb.look(true).has_value());
+    }
+
+    SECTION("Properties are kept when the part changes its layout") {
+        part other{ PART[2] };
+        other.add_entry(entry{ of::NAME, text("__NAME"), text("Name"),
+                               value(string_t()), ui_access::VISIBLE, serialize::SERIALIZE });
+        clb.set(of::NAME, value(string_t(text("cell"))));
+
+        clb.set_type(other);
+        REQUIRE(other.slot_of(of::NAME) == 0u);
+        REQUIRE(get<uint_t>(clb.get(of::VALUE)) == 1u);
+        REQUIRE(get<string_t>(clb.get(of::NAME, true)) == text("cell"));
+    }
+}
+
 TEST_CASE("Connections between cell bases", "[grid_cell_base]") {
     part pt{ };
     grid_cell_base gclb1{ pt, gcoords_t(MODEL_GRID, 0, 0) };
@@ -166,24 +254,77 @@ TEST_CASE("Connections between cell bases", "[grid_cell_base]") {
     }
 }
 
-TEST_CASE("Cargo on a grid", "[!mayfail][cargo_cell_base][artifact]") {
+TEST_CASE("Cargo on a grid", "[cargo_cell_base][artifact]") {
+    part pt{ PART[1] };
+    world world{ dcoords_t(4, 4), pt, dcoords_t(1, 1), pt };
+    auto & model = world.get_model();
+    auto & cclb = world.add_cargo(pt, ccoords_t(1.5, 1.5));
+    auto num = cclb.id();
+
     SECTION("New cargo_cell_base can be spawned") {
-        FAIL("Not implemented");
+        REQUIRE(num == CARGO[0]);
+        REQUIRE(world.cargo().size() == 1u);
+        REQUIRE(model.at(dcoords_t(1, 1)).cargo().count(num));
+        REQUIRE(cclb.overlays().size() == 1u);
+
+        auto & other = world.add_cargo(pt, ccoords_t(.5, .5));
+        REQUIRE(other.id() != num);
+        REQUIRE(world.cargo().size() == 2u);
     }
 
     SECTION("Cargo can be moved") {
-        FAIL("Not implemented");
+        REQUIRE(world.move_cargo(cclb, ccoords_t(2., 1.5)));
+        REQUIRE(cclb.position() == ccoords_t(2., 1.5));
+        REQUIRE(model.at(dcoords_t(1, 1)).cargo().empty());
+        REQUIRE(model.at(dcoords_t(1, 1)).artifacts().count(num));
+        REQUIRE(model.at(dcoords_t(2, 1)).cargo().count(num));
+        REQUIRE(cclb.overlays().size() == 2u);
+
+        REQUIRE(!world.move_cargo(cclb, ccoords_t(2., 1.5)));
     }
 
     SECTION("Cargo can't be moved over the grid's bounds") {
-        FAIL("Not implemented");
+        REQUIRE(world.move_cargo(cclb, ccoords_t(10., -3.)));
+        REQUIRE(cclb.position().x < 4.);
+        REQUIRE(cclb.position().y == 0.);
+        REQUIRE(model.at(dcoords_t(3, 0)).cargo().count(num));
     }
 
     SECTION("Cargo can be removed") {
-        FAIL("Not implemented");
+        REQUIRE(world.remove_cargo(num));
+        REQUIRE(world.cargo().empty());
+        REQUIRE(model.at(dcoords_t(1, 1)).cargo().empty());
+        REQUIRE(!world.remove_cargo(num));
+    }
+
+    SECTION("Handles of removed cargo are not reused") {
+        world.remove_cargo(num);
+        auto & other = world.add_cargo(pt, ccoords_t(.5, .5));
+        REQUIRE(cargo_pool::index_of(other.id()) == cargo_pool::index_of(num));
+        REQUIRE(other.id() != num);
+        REQUIRE(world.cargo().find(num) == nullptr);
+        REQUIRE(world.cargo().find(other.id()) == &other);
+        REQUIRE(world.cargo().capacity() == 1u);
+    }
+
+    SECTION("Reserved cargo is only found once it is added") {
+        auto & reserved = world.reserve_cargo(pt, ccoords_t(2.5, 2.5));
+        REQUIRE(!world.cargo().count(reserved.id()));
+        REQUIRE(&world.cargo().at(reserved.id()) == &reserved);
+        REQUIRE(model.at(dcoords_t(2, 2)).cargo().empty());
+
+        world.add_cargo(reserved.id());
+        REQUIRE(world.cargo().count(reserved.id()));
+        REQUIRE(model.at(dcoords_t(2, 2)).cargo().count(reserved.id()));
+        REQUIRE(world.cargo().size() == 2u);
     }
 
     SECTION("When a grid_cell_base is removed, it's cargo_cells are removed as well") {
-        FAIL("Not implemented");
+        auto kept = world.add_cargo(pt, ccoords_t(.5, .5)).id();
+        auto removed = world.resize(MODEL_GRID, pt, dcoords_t(1, 1));
+        REQUIRE(removed == std::vector<cargo_h>{ num });
+        REQUIRE(!world.cargo().count(num));
+        REQUIRE(world.cargo().count(kept));
+        REQUIRE(model.at(dcoords_t(0, 0)).cargo().count(kept));
     }
 }
@@ -2,8 +2,12 @@
 // Created by Johannes on 26.05.2020.
 //
 
+#include <array>
+
 #include <har/cell.hpp>
+#include <har/cell_batch.hpp>
 #include <har/grid_cell.hpp>
+#include <har/part_type.hpp>
 #include <har/simulation.hpp>
 
 #include "logic/context.hpp"
@@ -200,3 +204,95 @@ TEST_CASE("Parts") {
     }
 
 }
+
+/// \brief Part counting its cycles and halving its voltage
+struct counter : public part_type<counter,
+                                  static_slot<of::VALUE, uint_t>,
+                                  static_slot<of::ANALOG_VOLTAGE, double_t>> {
+    using count = static_slot<of::VALUE, uint_t>;
+    using voltage = static_slot<of::ANALOG_VOLTAGE, double_t>;
+
+    static void cycle(view & cl) {
+        cl.set<count>(cl.get<count>() + 1u);
+        cl.replace<voltage>(cl.get<voltage>() / 2.);
+    }
+};
+
+TEST_CASE("Statically typed parts", "[part]") {
+    static_assert(counter::slot_of<counter::count> == 0u && counter::slot_of<counter::voltage> == 1u);
+
+    part pt{ PART[1], "counter", traits::COMPONENT_PART };
+    pt.add_entry(entry{ of::VALUE,
+                        "VALUE",
+                        "Count",
+                        value(uint_t()),
+                        ui_access::VISIBLE,
+                        serialize::SERIALIZE,
+                        std::array<uint_t, 3>{ 0u, 1000u, 1u }});
+    pt.add_entry(entry{ of::ANALOG_VOLTAGE,
+                        "ANALOG_VOLTAGE",
+                        "Analog voltage",
+                        value(double_t(4.)),
+                        ui_access::VISIBLE,
+                        serialize::SERIALIZE,
+                        std::array<double_t, 3>{ 0., 5., .1 }});
+
+    SECTION("Part types install their delegates into parts") {
+        REQUIRE_NOTHROW(counter::bind(pt));
+        REQUIRE(pt.delegates.cycle);
+        REQUIRE(pt.delegates.cycle_static);
+        REQUIRE_FALSE(pt.delegates.draw);
+
+        grid_cell_base gclb{ pt, gcoords_t(grid_t::MODEL_GRID, 0, 0) };
+        pt.init_standard(gclb);
+        gclb.transit();
+
+        context ctx{ };
+        pt.delegates.cycle_static(ctx, gclb);
+        gclb.transit();
+        REQUIRE(har::get<uint_t>(gclb.get(of::VALUE)) == 1u);
+        REQUIRE(har::get<double_t>(gclb.get(of::ANALOG_VOLTAGE)) == 2.);
+        REQUIRE(ctx.changed().size() == 1u);
+
+        grid_cell gcl{ ctx, gclb };
+        pt.cycle(gcl);
+        gclb.transit();
+        REQUIRE(uint_t(gcl[of::VALUE]) == 2u);
+        REQUIRE(double_t(gcl[of::ANALOG_VOLTAGE]) == 1.);
+    }
+
+    SECTION("Part types cycle batches of cells in one call") {
+        REQUIRE_NOTHROW(counter::bind(pt));
+        REQUIRE(pt.delegates.cycle_batch);
+
+        std::array<grid_cell_base, 3> gclbs{ grid_cell_base{ pt, gcoords_t(grid_t::MODEL_GRID, 0, 0) },
+                                             grid_cell_base{ pt, gcoords_t(grid_t::MODEL_GRID, 1, 0) },
+                                             grid_cell_base{ pt, gcoords_t(grid_t::MODEL_GRID, 2, 0) }};
+        std::array<grid_cell_base *, 3> cells{ &gclbs[0], &gclbs[1], &gclbs[2] };
+        for (auto & gclb : gclbs) {
+            pt.init_standard(gclb);
+            gclb.transit();
+        }
+
+        context ctx{ };
+        cell_batch batch{ ctx, cells.data(), cells.size() };
+        REQUIRE(batch.size() == 3u);
+        pt.cycle(batch);
+        for (auto & gclb : gclbs) {
+            gclb.transit();
+            REQUIRE(har::get<uint_t>(gclb.get(of::VALUE)) == 1u);
+            REQUIRE(har::get<double_t>(gclb.get(of::ANALOG_VOLTAGE)) == 2.);
+        }
+        REQUIRE(ctx.changed().size() == 3u);
+        REQUIRE(uint_t(batch.at(1u)[of::VALUE]) == 1u);
+    }
+
+    SECTION("Part types require the property model to begin with their properties") {
+        part swapped{ PART[2], "swapped", traits::COMPONENT_PART };
+        swapped.add_entry(pt.model().at(of::ANALOG_VOLTAGE));
+        swapped.add_entry(pt.model().at(of::VALUE));
+
+        REQUIRE_THROWS(counter::bind(swapped));
+        REQUIRE_FALSE(swapped.delegates.cycle_static);
+    }
+}
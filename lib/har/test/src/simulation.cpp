@@ -2,10 +2,15 @@
 // Created by Johannes on 26.05.2020.
 //
 
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
 #include <har/program.hpp>
 #include <har/simulation.hpp>
 
 #include "logic/inner_simulation.hpp"
+#include "world/model_file.hpp"
 
 #include <catch2/catch.hpp>
 
@@ -57,6 +62,104 @@ TEST_CASE("Models", "[!mayfail][world][cargo_cell_base][grid_cell_base][parser]"
     }
 }
 
+TEST_CASE("Binary models", "[simulation][world][parser]") {
+    inner_simulation isim{ 0, nullptr, nullptr };
+    part lamp{ PART[1], text("lamp"), traits::COMPONENT_PART };
+    lamp.add_entry(entry{ of::VALUE,
+                          text("__VALUE"),
+                          text("Brightness"),
+                          value(double_t()),
+                          ui_access::CHANGEABLE,
+                          serialize::SERIALIZE,
+                          std::array<double_t, 3>{ 0., 1., .1 }});
+    lamp.add_entry(entry{ of::NEXT_FREE,
+                          text("label"),
+                          text("Label"),
+                          value(string_t()),
+                          ui_access::CHANGEABLE,
+                          serialize::SERIALIZE });
+    part box{ PART[2], text("box"), traits::CARGO_PART };
+    box.add_entry(entry{ of::COLOR,
+                         text("__COLOR"),
+                         text("Color"),
+                         value(color_t()),
+                         ui_access::CHANGEABLE,
+                         serialize::ANYWAY });
+    isim.include_part(lamp);
+    isim.include_part(box);
+
+    auto & model = isim.get_model();
+    model.title() = text("Binary \"test\"");
+    model.author() = text("HAR");
+    model.get_model().title() = text("Model");
+    model.resize(grid_t::MODEL_GRID, isim.part_of(PART[0]), dcoords_t(3, 2));
+    model.resize(grid_t::BANK_GRID, isim.part_of(PART[0]), dcoords_t(1, 1));
+    for (auto & pos : { gcoords_t(grid_t::MODEL_GRID, 0, 0), gcoords_t(grid_t::MODEL_GRID, 2, 1) }) {
+        grid_cell_base gclb{ isim.part_of(PART[1]), pos };
+        model.at(pos).adopt(std::move(gclb));
+    }
+    auto & first = model.at(gcoords_t(grid_t::MODEL_GRID, 0, 0));
+    auto & second = model.at(gcoords_t(grid_t::MODEL_GRID, 2, 1));
+    auto & cargo = model.add_cargo(isim.part_of(PART[2]), ccoords_t(1.25, .75));
+    first.set(of::VALUE, value(.5));
+    second.set(of::NEXT_FREE, value(string_t(text("on \"top\""))));
+    cargo.set(of::COLOR, value(color_t(255, 0, 127, 255)));
+    first.transit();
+    second.transit();
+    cargo.transit();
+    first.add_connection(direction::PIN[0], second);
+
+    std::stringstream original{ };
+    isim.store_model(original);
+    std::stringstream binary{ std::ios::in | std::ios::out | std::ios::binary };
+    isim.store_model(binary, model_format::BINARY);
+    auto bytes = binary.str();
+
+    SECTION("Models are stored in the binary format") {
+        REQUIRE(original.str().find(text("prop label \"on \\\"top\\\"\"")) != string_t::npos);
+        REQUIRE(model_file::is_binary(span<const char>(bytes.data(), bytes.size())));
+        REQUIRE(bytes.size() % 8u == 0u);
+        REQUIRE_FALSE(model_file::is_binary(original));
+    }
+
+    SECTION("Models convert between the text and the binary format without losses") {
+        class model loaded{ isim };
+        std::vector<char> aligned{ bytes.begin(), bytes.end() };
+        REQUIRE(model_file::load(span<const char>(aligned.data(), aligned.size()), loaded, isim.inventory()));
+        REQUIRE(loaded.get_model().at(dcoords_t(0, 0)).connected().size() == 1u);
+
+        std::stringstream converted{ };
+        converted << loaded;
+        REQUIRE(converted.str() == original.str());
+
+        std::stringstream again{ std::ios::in | std::ios::out | std::ios::binary };
+        model_file::store(again, loaded);
+        REQUIRE(again.str() == bytes);
+    }
+
+    SECTION("The simulation loads models from mapped files") {
+        auto path = std::filesystem::temp_directory_path() / "har_binary_model.hamb";
+        {
+            std::ofstream ofs{ path, std::ios::binary };
+            ofs << bytes;
+        }
+        context ctx{ };
+        model.resize(grid_t::MODEL_GRID, isim.part_of(PART[0]), dcoords_t(1, 1));
+        isim.load_model(ctx, path);
+        std::filesystem::remove(path);
+
+        std::stringstream loaded{ };
+        isim.store_model(loaded);
+        REQUIRE(loaded.str() == original.str());
+    }
+
+    SECTION("Damaged binary models are rejected") {
+        class model loaded{ isim };
+        std::vector<char> cut{ bytes.begin(), bytes.begin() + bytes.size() / 2u };
+        REQUIRE_FALSE(model_file::load(span<const char>(cut.data(), cut.size()), loaded, isim.inventory()));
+    }
+}
+
 TEST_CASE("Participants", "[simulation][participant]") {
     inner_simulation & isim = *new inner_simulation{ 0, nullptr, nullptr };
     simulation sim{ isim };
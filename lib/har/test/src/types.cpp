@@ -2,8 +2,127 @@
 // Created by Johannes on 26.05.2020.
 //
 
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <har/co_queue.hpp>
+#include <har/field.hpp>
 #include <har/value.hpp>
 
 #include <catch2/catch.hpp>
 
 using namespace har;
+
+TEST_CASE("Concurrent queues", "[co_queue]") {
+    co_queue<uint_t> queue{ };
+
+    SECTION("Elements are popped in the order they were pushed in") {
+        REQUIRE(queue.empty());
+        queue.push(1u);
+        queue.push(2u);
+        std::vector<uint_t> range{ 3u, 4u };
+        auto begin = range.begin();
+        auto end = range.end();
+        queue.push(begin, end);
+        REQUIRE_FALSE(queue.empty());
+
+        REQUIRE(queue.pop() == 1u);
+        queue.push(5u);
+        std::vector<uint_t> drained{ };
+        REQUIRE(queue.drain([&](uint_t & n) { drained.emplace_back(n); }) == 4u);
+        REQUIRE(drained == std::vector<uint_t>{ 2u, 3u, 4u, 5u });
+        REQUIRE(queue.empty());
+    }
+
+    SECTION("Draining leaves elements pushed while draining for the next call") {
+        queue.push(1u);
+        uint_t drained = queue.drain([&](uint_t & n) {
+            if (n < 3u) {
+                queue.push(n + 1u);
+            }
+        });
+        REQUIRE(drained == 1u);
+
+        std::vector<uint_t> processed{ };
+        queue.process_all([&](uint_t & n) {
+            processed.emplace_back(n);
+            if (n < 3u) {
+                queue.push(n + 1u);
+            }
+        });
+        REQUIRE(processed == std::vector<uint_t>{ 2u, 3u });
+
+        queue.push(7u);
+        REQUIRE(queue.pop_check() == std::make_tuple(7u, true));
+    }
+
+    SECTION("Elements of many producers are all consumed in order per producer") {
+        constexpr uint_t producers = 4u;
+        constexpr uint_t pushes = 10000u;
+        std::vector<std::thread> threads{ };
+        for (uint_t p = 0u; p < producers; ++p) {
+            threads.emplace_back([&queue, p]() {
+                for (uint_t n = 0u; n < pushes; ++n) {
+                    queue.push(p * pushes + n);
+                }
+            });
+        }
+
+        std::vector<uint_t> next(producers, 0u);
+        uint_t consumed = 0u;
+        bool_t ordered = true;
+        while (consumed < producers * pushes) {
+            consumed += queue.drain([&](uint_t & n) {
+                auto & expected = next[n / pushes];
+                ordered &= n % pushes == expected;
+                ++expected;
+            });
+        }
+        for (auto & t : threads) {
+            t.join();
+        }
+
+        REQUIRE(ordered);
+        REQUIRE(queue.empty());
+    }
+}
+
+TEST_CASE("Fields", "[field]") {
+    field<bool_t> fd{ };
+    fd.reset(dcoords_t(45, 3));
+
+    SECTION("Fields are cleared when they are reset") {
+        REQUIRE(fd.width() == 45u);
+        REQUIRE(fd.height() == 3u);
+        REQUIRE(fd.size() == 45u * 3u);
+        for (std::size_t n = 0u; n < fd.size(); ++n) {
+            REQUIRE(fd[n] == 0u);
+            REQUIRE_FALSE(fd.covers(n));
+        }
+    }
+
+    SECTION("Moore neighborhoods are counted like cell by cell") {
+        for (std::size_t n = 0u; n < fd.size(); ++n) {
+            fd[n] = std::uint8_t(n * 7u % 3u == 0u);
+        }
+
+        std::vector<std::uint8_t> counts(fd.width());
+        for (std::size_t y = 0u; y < fd.height(); ++y) {
+            moore_count(fd, y, counts.data());
+            for (std::size_t x = 0u; x < fd.width(); ++x) {
+                uint_t count = 0u;
+                for (int_t dy = -1; dy <= 1; ++dy) {
+                    for (int_t dx = -1; dx <= 1; ++dx) {
+                        auto nx = int_t(x) + dx;
+                        auto ny = int_t(y) + dy;
+                        if ((dx || dy) && nx >= 0 && ny >= 0 && nx < int_t(fd.width()) && ny < int_t(fd.height())) {
+                            count += fd.row(std::size_t(ny))[nx];
+                        }
+                    }
+                }
+                REQUIRE(counts[x] == count);
+            }
+        }
+    }
+}
@@ -3,7 +3,8 @@
 //
 
 #include <chrono>
-#include <random>
+#include <fstream>
+#include <string_view>
 #include <thread>
 
 #include <har.hpp>
@@ -38,6 +39,8 @@ inline har::duino & rt() {
 /// \param envp Environment variables
 /// \return Return code of the process
 int WEAK main(int argc, char * argv[], char * envp[]) {
+    //Declared first, as the simulation records to it until it is destroyed
+    std::ofstream journal{ };
     har::simulation sim{ argc, argv, envp };
     har::gui gui{ };
     auto & runtime = rt();
@@ -78,6 +81,15 @@ int WEAK main(int argc, char * argv[], char * envp[]) {
         sim.include_part(har::duino::parts::keying_pin());
     }
 
+    /*Record requests*/ {
+        for (auto i = 1; i < argc; ++i) {
+            if (std::string_view(argv[i - 1]) == "--record") {
+                journal.open(argv[i], std::ios::binary);
+                sim.record(journal);
+            }
+        }
+    }
+
     /*Add participants*/ {
         sim.attach(runtime);
         sim.attach(gui);
@@ -97,6 +109,8 @@ int WEAK main(int argc, char * argv[], char * envp[]) {
     while (!exit.load(std::memory_order_acquire)) {
         runtime.maybe_setup();
         loop();
+        runtime.service();
+        runtime.flush();
     }
     DEBUG_LOG("Done calling loop()");
 }
@@ -128,38 +142,35 @@ void analogWrite(uint8_t pin, int val) {
 }
 
 void delay(unsigned long ms) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    rt().delay(std::chrono::milliseconds(ms));
 }
 
 void delayMicroseconds(unsigned int us) {
-    std::this_thread::sleep_for(std::chrono::microseconds(us));
+    rt().delay(std::chrono::microseconds(us));
 }
 
 unsigned long millis() {
-    return std::chrono::duration_cast<std::chrono::milliseconds>(har::clock::now() - rt().start()).count();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(rt().elapsed()).count();
 }
 
 unsigned long micros() {
-    return std::chrono::duration_cast<std::chrono::microseconds>(har::clock::now() - rt().start()).count();
+    return rt().elapsed().count();
 }
 
 unsigned long pulseIn(uint8_t pin, uint8_t state, unsigned long timeout) {
-    //TODO: Implement
-    return 0u;
+    return rt().pulseIn(pin, state, timeout);
 }
 
 unsigned long pulseInLong(uint8_t pin, uint8_t state, unsigned long timeout) {
-    //TODO: Implement
-    return 0u;
+    return rt().pulseIn(pin, state, timeout);
 }
 
 void shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t val) {
-    //TODO: Implement;
+    rt().shiftOut(dataPin, clockPin, bitOrder, val);
 }
 
 uint8_t shiftIn(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder) {
-    //TODO: Implement
-    return 0u;
+    return rt().shiftIn(dataPin, clockPin, bitOrder);
 }
 
 uint8_t digitalPinToInterrupt(uint8_t pin) {
@@ -174,22 +185,16 @@ void detachInterrupt(uint8_t interruptNum) {
     rt().detachInterrupt(interruptNum);
 }
 
-std::mt19937_64 & random_base() {
-    static std::random_device rd;
-    static std::mt19937_64 gen(rd());
-    return gen;
+long randomMax(long max) {
+    return rt().randomMax(max);
 }
 
-long random_max(long max) {
-    return std::uniform_int_distribution<>(0, max)(random_base());
+long randomMinMax(long min, long max) {
+    return rt().randomMinMax(min, max);
 }
 
-long random_min_max(long min, long max) {
-    return std::uniform_int_distribution<>(min, max)(random_base());
-}
-
-void randomSeed([[maybe_unused]] unsigned long seed) {
-
+void randomSeed(unsigned long seed) {
+    rt().randomSeed(seed);
 }
 
 long map(long value, long fromLow, long fromHigh, long toLow, long toHigh) {
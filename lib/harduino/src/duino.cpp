@@ -2,9 +2,14 @@
 // Created by Johannes on 28.08.2020.
 //
 
+#include <algorithm>
+#include <charconv>
+#include <cmath>
 #include <cstdlib>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <iostream>
 
 #include <har/duino.hpp>
 
@@ -13,49 +18,213 @@ extern unsigned int uno_ham_len;
 
 using namespace har;
 
+/// \brief Parses an integer argument of an option
+///
+/// Malformed arguments are reported along with the option's usage.
+/// \param [in] option Option the argument belongs to
+/// \param [in] arg Argument to parse
+/// \param [in] least Smallest valid value
+/// \param [out] into Parsed value, left unchanged if the argument is malformed
+/// \return <tt>TRUE</tt>, if the argument was parsed
+static bool_t parse_count(std::string_view option, const char * arg, unsigned long least, unsigned long & into) {
+    auto last = arg + std::strlen(arg);
+    unsigned long value{ };
+    auto[end, err] = std::from_chars(arg, last, value);
+    if (err != std::errc() || end != last || end == arg || value < least) {
+        std::cerr << "Ignoring malformed argument \"" << arg << "\" of " << option << "\n"
+                  << "Usage: " << option << " <integer of at least " << least << ">\n";
+        return false;
+    }
+    into = value;
+    return true;
+}
+
 duino::duino() : _start(clock::now()),
-                 _setup(1u) {
+                 _setup(1u),
+                 _virtual(false),
+                 _tick(std::chrono::milliseconds(1)),
+                 _cycles(0u),
+                 _epoch(0u),
+                 _tickex(),
+                 _ticked(),
+                 _pinex(),
+                 _writes(),
+                 _pins(),
+                 _snapped(NEVER),
+                 _handlers(),
+                 _interrupting(false),
+                 _job(),
+                 _random(std::random_device()()) {
 
 }
 
-full_grid_cell duino::map_cell_digital(context & ctx, uint8_t pin) {
+gcoords_t duino::map_digital(uint8_t pin) {
     if (pin <= 7u) {
-        return ctx.at(gcoords_t(grid_t::BANK_GRID, 8, 20 - pin));
+        return gcoords_t(grid_t::BANK_GRID, 8, 20 - pin);
     } else if (pin <= 13u) {
-        return ctx.at(gcoords_t(grid_t::BANK_GRID, 8, 19 - pin));
+        return gcoords_t(grid_t::BANK_GRID, 8, 19 - pin);
     } else {
         raise(std::runtime_error(std::string("Illegal digital pin number ") + std::to_string(pin)));
     }
 }
 
-full_grid_cell duino::map_cell_analog(context & ctx, uint8_t pin) {
-    if (pin - 14 <= 5) {
-        return ctx.at({ grid_t::BANK_GRID, dcoords_t(0, 15 + pin - 14) });
+gcoords_t duino::map_analog(uint8_t pin) {
+    if (pin >= 14u) {
+        pin -= 14u;
+    }
+    if (pin <= 5u) {
+        return gcoords_t(grid_t::BANK_GRID, 0, 15 + pin);
     } else {
-        raise(std::runtime_error(std::string("Illegal analog pin number ") + std::to_string(pin - 14)));
+        raise(std::runtime_error(std::string("Illegal analog pin number ") + std::to_string(pin)));
     }
 }
 
-full_grid_cell duino::map_cell_interrupt(context & ctx, uint8_t num) {
+gcoords_t duino::map_interrupt(uint8_t num) {
     switch (num) {
         case 0u:
-            return ctx.at(gcoords_t{ grid_t::BANK_GRID, 8, 18 });
+            return gcoords_t{ grid_t::BANK_GRID, 8, 18 };
         case 1u:
-            return ctx.at(gcoords_t{ grid_t::BANK_GRID, 8, 17 });
+            return gcoords_t{ grid_t::BANK_GRID, 8, 17 };
         default:
             raise(std::runtime_error(std::string("Illegal interrupt number ") + std::to_string(num)));
     }
 }
 
+void duino::write(const pin_write & write) {
+    std::scoped_lock lock{ _pinex };
+    _writes.emplace_back(write);
+}
+
+void duino::apply(context & ctx) {
+    for (auto & w : _writes) {
+        switch (w.op) {
+            case pin_op::MODE: {
+                ctx.at(map_digital(w.pin))[of::PIN_MODE] = uint_t(w.val);
+                break;
+            }
+            case pin_op::DIGITAL: {
+                set_high(ctx, w.pin, w.val != 0.);
+                break;
+            }
+            case pin_op::ANALOG: {
+                ctx.at(map_digital(w.pin))[of::PWM_DUTY] = double_t(w.val / 255.);
+                break;
+            }
+            case pin_op::REFERENCE: {
+                ctx.at(map_analog(w.pin))[of::HIGH_VOLTAGE] = double_t(w.val);
+                break;
+            }
+            case pin_op::INTERRUPT: {
+                auto fgcl = ctx.at(map_interrupt(w.pin));
+                fgcl[of::INT_HANDLER] = w.fun ? har::callback_t(w.fun) : har::callback_t();
+                break;
+            }
+        }
+    }
+    _writes.clear();
+}
+
+std::vector<std::pair<gcoords_t, entry_h>> duino::board_probes() {
+    std::vector<std::pair<gcoords_t, entry_h>> probes{ };
+    probes.reserve(PROBES);
+    for (uint8_t pin = 0; pin < 14u; ++pin) {
+        probes.emplace_back(map_digital(pin), of::POWERED_PIN);
+    }
+    for (uint8_t pin = 0; pin < 6u; ++pin) {
+        probes.emplace_back(map_analog(pin), of::POWERED_PIN);
+    }
+    for (uint8_t pin = 0; pin < 6u; ++pin) {
+        probes.emplace_back(map_analog(pin), of::HIGH_VOLTAGE);
+    }
+    probes.emplace_back(gcoords_t(grid_t::BANK_GRID, 8, 4), of::POWERED_PIN);
+    return probes;
+}
+
+duino::pin_snapshot duino::read() {
+    flush();
+    std::array<double_t, PROBES> values{ };
+    if (read_probes(values) != 0u) {
+        pin_snapshot pins{ };
+        std::copy_n(values.begin(), 14u, pins.digital.begin());
+        std::copy_n(values.begin() + 14u, 6u, pins.analog.begin());
+        std::copy_n(values.begin() + 20u, 6u, pins.reference.begin());
+        pins.aref = values[26u];
+        return pins;
+    }
+
+    std::scoped_lock lock{ _pinex };
+    auto cycle = _cycles.load(std::memory_order_acquire);
+    if (!_writes.empty() || _snapped != cycle) {
+        auto ctx = request_or_terminate();
+        apply(ctx);
+
+        auto powered = [&](const gcoords_t & pos) {
+            auto fgcl = ctx.at(pos);
+            return fgcl.has(of::POWERED_PIN) ? double_t(fgcl[of::POWERED_PIN]) : 0.;
+        };
+        for (uint8_t pin = 0; pin < _pins.digital.size(); ++pin) {
+            _pins.digital[pin] = powered(map_digital(pin));
+        }
+        for (uint8_t pin = 0; pin < _pins.analog.size(); ++pin) {
+            auto fgcl = ctx.at(map_analog(pin));
+            _pins.analog[pin] = double_t(fgcl[of::POWERED_PIN]);
+            _pins.reference[pin] = double_t(fgcl[of::HIGH_VOLTAGE]);
+        }
+        _pins.aref = powered(gcoords_t(grid_t::BANK_GRID, 8, 4));
+        _snapped = cycle;
+    }
+    return _pins;
+}
+
+void duino::run(std::function<bool_t(context &)> && job) {
+    flush();
+    std::unique_lock lock{ _tickex };
+    _job = std::move(job);
+    while (_job) {
+        //Cycles stop once detached, so check back from time to time
+        if (!attached()) {
+            std::exit(0);
+        }
+        _ticked.wait_for(lock, std::chrono::milliseconds(100));
+    }
+}
+
+bool_t duino::is_high(context & ctx, uint8_t pin) {
+    auto fgcl = ctx.at(map_digital(pin));
+    return fgcl.has(of::POWERED_PIN) && double_t(fgcl[of::POWERED_PIN]) > .01;
+}
+
+void duino::set_high(context & ctx, uint8_t pin, bool_t high) {
+    auto fgcl = ctx.at(map_digital(pin));
+    if (fgcl.has(of::PWM_DUTY)) {
+        fgcl[of::PWM_DUTY] = double_t(high ? 1. : 0.);
+    } else {
+        fgcl[of::POWERING_PIN] = fgcl[high ? of::HIGH_VOLTAGE : of::LOW_VOLTAGE];
+    }
+}
+
 void duino::on_attach(int argc, char * const * argv, char * const * envp) {
     bool_t loaded{ false };
     for (auto i = 1; i < argc; ++i) {
         std::string_view model_option{ argv[i - 1] };
-        if (model_option == "-m" || model_option == "--model") {
+        if (std::string_view(argv[i]) == "--virtual-time") {
+            _virtual = true;
+        }
+        if (model_option == "-t" || model_option == "--tick") {
+            unsigned long tick;
+            if (parse_count(model_option, argv[i], 1u, tick)) {
+                _tick = std::chrono::microseconds(tick);
+                _virtual = true;
+            }
+        } else if (model_option == "--seed") {
+            unsigned long seed;
+            if (parse_count(model_option, argv[i], 0u, seed)) {
+                _random.seed(seed);
+            }
+        } else if (model_option == "-m" || model_option == "--model") {
             std::string_view model_path_view{ argv[i] };
             string_t model_path{ model_path_view.begin(), model_path_view.end() };
-            ifstream ifs{ std::filesystem::path(model_path) };
-            load_model(ifs);
+            load_model(std::filesystem::path(model_path));
             loaded = true;
         }
     }
@@ -63,14 +232,28 @@ void duino::on_attach(int argc, char * const * argv, char * const * envp) {
         imstream model{ reinterpret_cast<char *>(uno_ham), uno_ham_len };
         load_model(model);
     }
+    set_cycling(true);
+    set_probes(board_probes());
 }
 
 void duino::on_model_loaded() {
     program::on_model_loaded();
     _start = clock::now();
+    _epoch.store(_cycles.load(std::memory_order_acquire), std::memory_order_release);
     _setup.fetch_add(1, std::memory_order_acq_rel);
 }
 
+void duino::on_cycle(participant::context & ctx) {
+    {
+        std::scoped_lock lock{ _tickex };
+        _cycles.fetch_add(1u, std::memory_order_acq_rel);
+        if (_job && _job(ctx)) {
+            _job = nullptr;
+        }
+    }
+    _ticked.notify_all();
+}
+
 duino::context duino::request_or_terminate() {
     if (!attached()) {
         std::exit(0);
@@ -87,39 +270,103 @@ void duino::maybe_setup() {
     if (_setup.load(std::memory_order_acquire)) {
         DEBUG_LOG("Calling setup()");
         setup();
+        flush();
         _setup.fetch_sub(1, std::memory_order_acq_rel);
     }
 }
 
+std::chrono::microseconds duino::elapsed() const {
+    if (_virtual) {
+        auto ticks = _cycles.load(std::memory_order_acquire) - _epoch.load(std::memory_order_acquire);
+        return std::chrono::microseconds(_tick.count() * ticks);
+    } else {
+        return std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - _start);
+    }
+}
+
+void duino::delay(std::chrono::microseconds duration) {
+    flush();
+    auto until = elapsed() + duration;
+    std::unique_lock lock{ _tickex };
+    while (true) {
+        lock.unlock();
+        service();
+        flush();
+        lock.lock();
+        if (elapsed() >= until) {
+            break;
+        }
+        //Cycles stop once detached, so check back from time to time
+        if (!attached()) {
+            std::exit(0);
+        }
+        std::chrono::microseconds wait{ std::chrono::milliseconds(100) };
+        if (!_virtual) {
+            wait = std::min(wait, until - elapsed());
+        }
+        _ticked.wait_for(lock, wait);
+    }
+}
+
+void duino::flush() {
+    std::scoped_lock lock{ _pinex };
+    if (!_writes.empty()) {
+        auto ctx = request_or_terminate();
+        apply(ctx);
+        //Writes may change the read pin states without a cycle
+        _snapped = NEVER;
+    }
+}
+
+void duino::service() {
+    if (_interrupting || !attached()) {
+        return;
+    }
+    _interrupting = true;
+    for (uint8_t num = 0; num < _handlers.size(); ++num) {
+        if (auto * fun = _handlers[num]) {
+            for (auto raised = take_trigger(num); raised > 0u; --raised) {
+                fun();
+            }
+        }
+    }
+    _interrupting = false;
+}
+
 int duino::digitalRead(uint8_t pin) {
-    auto ctx = request_or_terminate();
-    auto fgcl = map_cell_digital(ctx, pin);
-    return double_t(fgcl[of::POWERED_PIN]) > .01;
+    service();
+    map_digital(pin);
+    return read().digital[pin] > .01;
 }
 
 void duino::digitalWrite(uint8_t pin, uint8_t val) {
-    auto ctx = request_or_terminate();
-    auto fgcl = map_cell_digital(ctx, pin);
-    if (fgcl.has(of::PWM_DUTY)) {
-        fgcl[of::PWM_DUTY] = double_t(val ? 1. : 0.);
-    } else {
-        fgcl[of::POWERING_PIN] = fgcl[val ? of::HIGH_VOLTAGE : of::LOW_VOLTAGE];
-    };
+    service();
+    map_digital(pin);
+    write({ pin_op::DIGITAL, pin, double_t(val), nullptr });
 }
 
 void duino::pinMode(uint8_t pin, uint8_t mode) {
-    auto ctx = request_or_terminate();
-    auto fgcl = map_cell_digital(ctx, pin);
-    fgcl[of::PIN_MODE] = uint_t(mode);
+    service();
+    map_digital(pin);
+    write({ pin_op::MODE, pin, double_t(mode), nullptr });
 }
 
 int duino::analogRead(uint8_t pin) {
-    auto ctx = request_or_terminate();
-    auto fgcl = map_cell_analog(ctx, pin);
-    return int(double_t(fgcl[of::POWERED_PIN]) / double_t(fgcl[of::HIGH_VOLTAGE]) * 1023.);
+    service();
+    map_analog(pin);
+    auto pins = read();
+    auto num = pin >= 14u ? pin - 14u : pin;
+    //Undriven nets and unpublished probes read NaN, without a reference there is no range to read in
+    auto voltage = pins.analog[num];
+    auto reference = pins.reference[num];
+    if (std::isnan(voltage) || !(reference > 0.)) {
+        return 0;
+    }
+    return int(std::clamp(voltage / reference, 0., 1.) * 1023.);
 }
 
 void duino::analogReference(uint8_t type) {
+    service();
     double ref;
     switch (type) {
         case 0: {
@@ -131,9 +378,7 @@ void duino::analogReference(uint8_t type) {
             break;
         }
         case 1: {
-            auto ctx = request_or_terminate();
-            auto fgcl = ctx.at(gcoords_t(grid_t::BANK_GRID, 8, 4));
-            ref = double_t(fgcl[of::POWERED_PIN]);
+            ref = read().aref;
             break;
         }
         default: {
@@ -141,16 +386,94 @@ void duino::analogReference(uint8_t type) {
             raise(std::runtime_error(""));
         }
     }
-    auto ctx = request_or_terminate();
-    for (uint8_t i = 0; i <= 5.; ++i) {
-        map_cell_analog(ctx, i)[of::HIGH_VOLTAGE] = double_t(ref);
+    for (uint8_t pin = 0; pin <= 5u; ++pin) {
+        write({ pin_op::REFERENCE, pin, double_t(ref), nullptr });
     }
 }
 
 void duino::analogWrite(uint8_t pin, int val) {
-    auto ctx = request_or_terminate();
-    auto fgcl = map_cell_digital(ctx, pin);
-    fgcl[of::PWM_DUTY] = double_t(double(val) / 255.);
+    service();
+    map_digital(pin);
+    write({ pin_op::ANALOG, pin, double_t(val), nullptr });
+}
+
+unsigned long duino::pulseIn(uint8_t pin, uint8_t state, unsigned long timeout) {
+    service();
+    map_digital(pin);
+    auto begin = elapsed();
+    std::chrono::microseconds limit{ timeout };
+    std::chrono::microseconds start{ };
+    std::chrono::microseconds width{ };
+    uint_t phase = 0u;
+    run([&](context & ctx) {
+        auto now = elapsed();
+        if (now - begin >= limit) {
+            return true;
+        }
+        bool_t in = is_high(ctx, pin) == (state != 0u);
+        switch (phase) {
+            case 0u: { //Waiting for a previous pulse to end
+                phase = in ? 0u : 1u;
+                break;
+            }
+            case 1u: { //Waiting for the pulse to start
+                if (in) {
+                    start = now;
+                    phase = 2u;
+                }
+                break;
+            }
+            default: { //Measuring the pulse
+                if (!in) {
+                    width = now - start;
+                    return true;
+                }
+                break;
+            }
+        }
+        return false;
+    });
+    return width.count();
+}
+
+void duino::shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t val) {
+    service();
+    map_digital(dataPin);
+    map_digital(clockPin);
+    uint_t step = 0u;
+    run([&](context & ctx) {
+        auto bit = step / 2u;
+        if (step % 2u == 0u) {
+            auto shift = bitOrder == 0u ? bit : 7u - bit; //LSBFIRST or MSBFIRST
+            set_high(ctx, dataPin, (val >> shift) & 1u);
+            set_high(ctx, clockPin, true);
+        } else {
+            set_high(ctx, clockPin, false);
+        }
+        return ++step == 16u;
+    });
+}
+
+uint8_t duino::shiftIn(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder) {
+    service();
+    map_digital(dataPin);
+    map_digital(clockPin);
+    uint8_t val = 0u;
+    uint_t step = 0u;
+    run([&](context & ctx) {
+        auto bit = step / 2u;
+        if (step % 2u == 0u) {
+            set_high(ctx, clockPin, true);
+        } else {
+            auto shift = bitOrder == 0u ? bit : 7u - bit; //LSBFIRST or MSBFIRST
+            if (is_high(ctx, dataPin)) {
+                val |= uint8_t(1u << shift);
+            }
+            set_high(ctx, clockPin, false);
+        }
+        return ++step == 16u;
+    });
+    return val;
 }
 
 uint8_t duino::digitalPinToInterrupt(uint8_t pin) {
@@ -165,15 +488,56 @@ uint8_t duino::digitalPinToInterrupt(uint8_t pin) {
 }
 
 void duino::attachInterrupt(uint8_t interruptNum, void (* userFunc)(), int mode) {
-    auto ctx = request_or_terminate();
-    auto fgcl = map_cell_interrupt(ctx, interruptNum);
-    fgcl[of::INT_HANDLER] = har::callback_t(userFunc);
+    auto pos = map_interrupt(interruptNum);
+    edge kind;
+    switch (mode) {
+        case 0: { //LOW
+            kind = edge::LEVEL_LOW;
+            break;
+        }
+        case 1: { //CHANGE
+            kind = edge::BOTH;
+            break;
+        }
+        case 2: { //FALLING
+            kind = edge::FALL;
+            break;
+        }
+        case 3: { //RISING
+            kind = edge::RISE;
+            break;
+        }
+        default: {
+            raise(std::runtime_error(std::string("Illegal interrupt mode ") + std::to_string(mode)));
+        }
+    }
+    _handlers[interruptNum] = userFunc;
+    set_trigger(interruptNum, { pos, of::POWERED_PIN }, kind, .01);
+    write({ pin_op::INTERRUPT, interruptNum, 0., userFunc });
 }
 
 void duino::detachInterrupt(uint8_t interruptNum) {
-    auto ctx = request_or_terminate();
-    auto fgcl = map_cell_interrupt(ctx, interruptNum);
-    fgcl[of::INT_HANDLER] = har::callback_t();
+    map_interrupt(interruptNum);
+    clear_trigger(interruptNum);
+    _handlers[interruptNum] = nullptr;
+    write({ pin_op::INTERRUPT, interruptNum, 0., nullptr });
+}
+
+long duino::randomMax(long max) {
+    return max > 0 ? randomMinMax(0, max) : 0;
+}
+
+long duino::randomMinMax(long min, long max) {
+    if (min >= max) {
+        return min;
+    }
+    return std::uniform_int_distribution<long>(min, max - 1)(_random);
+}
+
+void duino::randomSeed(unsigned long seed) {
+    if (seed != 0u) {
+        _random.seed(seed);
+    }
 }
 
 duino::~duino() noexcept = default;
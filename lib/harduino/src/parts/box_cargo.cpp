@@ -61,5 +61,7 @@ part duino::parts::box_cargo(part_h offset) {
 
     pt.add_visual(of::COLOR);
 
+    pt.set_shared_images();
+
     return pt;
 }
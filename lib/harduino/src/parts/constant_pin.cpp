@@ -73,7 +73,7 @@ part duino::parts::constant_pin(part_h offset) {
                            of::DESIGN
                    });
 
-    pt.add_waking(of::POWERING_PIN);
+    pt.set_net(of::POWERING_PIN);
 
     return pt;
 }
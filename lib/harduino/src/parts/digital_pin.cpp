@@ -39,36 +39,18 @@ part duino::parts::digital_pin(part_h offset) {
         auto mode = pin_mode(uint_t(cl[of::PIN_MODE]));
 
         switch (mode) {
-            case pin_mode::TRI_STATE: {
+            case pin_mode::TRI_STATE:
+            case pin_mode::INPUT: {
+                //Pins that don't output leave their net undriven, the net writes its voltage to them
                 auto out = double_t(gcl[of::POWERING_PIN]);
                 if (!std::isnan(out)) {
                     gcl[of::POWERING_PIN] = std::nan("1");
                 }
-
-                auto in = double_t(gcl[of::POWERED_PIN]);
-                if (!std::isnan(in)) {
-                    gcl[of::POWERED_PIN] = std::nan("1");
-                }
                 break;
             }
             case pin_mode::OUTPUT: {
                 break;
             }
-            case pin_mode::INPUT: {
-                auto before = double_t(gcl[of::POWERING_PIN]);
-
-                double_t after = 0.;
-                auto connected = gcl.connected();
-                for (auto & ccl : connected) {
-                    after += double_t(ccl.cell[of::POWERING_PIN]);
-                }
-                after /= connected.size();
-
-                if (before != after) {
-                    gcl[of::POWERED_PIN] = after;
-                }
-                break;
-            }
         }
     };
 
@@ -104,7 +86,7 @@ part duino::parts::digital_pin(part_h offset) {
                      of::PIN_MODE,
                      of::DESIGN });
 
-    pt.add_waking(of::POWERING_PIN);
+    pt.set_net(of::POWERING_PIN, of::POWERED_PIN);
 
     pt.add_connection_use(direction::PIN, text("Input"));
 
@@ -46,5 +46,7 @@ part duino::parts::empty(part_h offset) {
         }
     };
 
+    pt.set_shared_images();
+
     return pt;
 }
@@ -70,5 +70,9 @@ part duino::parts::push_button(part_h offset) {
                            of::FIRING
                    });
 
+    pt.set_net(of::POWERING_PIN);
+
+    pt.set_shared_images();
+
     return pt;
 }
@@ -51,16 +51,28 @@ part duino::parts::pwm_pin(part_h offset) {
                         std::array<double_t, 3>{ 0., 1., .01 }});
 
     pt.delegates.cycle = [](cell & cl) {
-        switch (pin_mode(uint_t(cl[PIN_MODE]))) {
-            case pin_mode::TRI_STATE: {
+        auto mode = pin_mode(uint_t(cl[PIN_MODE]));
+
+        switch (mode) {
+            case pin_mode::TRI_STATE:
+            case pin_mode::INPUT: {
+                //Pins that don't output leave their net undriven, the net writes its voltage to them
                 auto out = double_t(cl[of::POWERING_PIN]);
                 if (!std::isnan(out)) {
                     cl[of::POWERING_PIN] = std::nan("1");
                 }
 
-                auto in = double_t(cl[of::POWERED_PIN]);
-                if (!std::isnan(in)) {
-                    cl[of::POWERED_PIN] = std::nan("1");
+                if (mode == pin_mode::INPUT) {
+                    //A net only carries the mean voltage, which reads as the full duty cycle of that voltage
+                    auto in = double_t(cl[of::POWERED_PIN]);
+                    auto volt = std::isnan(in) ? 0. : in;
+                    auto duty = volt == 0. ? 0. : 1.;
+                    if (auto prop = cl[PWM_VOLTAGE]; double_t(prop) != volt) {
+                        prop = volt;
+                    }
+                    if (auto prop = cl[PWM_DUTY]; double_t(prop) != duty) {
+                        prop = duty;
+                    }
                 }
                 break;
             }
@@ -68,50 +80,6 @@ part duino::parts::pwm_pin(part_h offset) {
                 cl[POWERING_PIN] = double_t(cl[PWM_VOLTAGE]) * double_t(cl[PWM_DUTY]);
                 break;
             }
-            case pin_mode::INPUT: {
-                auto & gcl = cl.as_grid_cell();
-                if (!gcl.connected().empty()) {
-                    auto ngcl = gcl[direction::PIN];
-                    if (ngcl.has(PWM_VOLTAGE)) {
-                        auto nvolt = double_t(ngcl[PWM_VOLTAGE]);
-                        auto nduty = double_t(ngcl[PWM_DUTY]);
-
-                        cl[PWM_VOLTAGE] = nvolt;
-                        cl[PWM_DUTY] = nduty;
-                        cl[POWERED_PIN] = nvolt * nduty;
-                    } else if (ngcl.has(POWERING_PIN)) {
-                        auto npwrd = double_t(ngcl[POWERING_PIN]);
-
-                        cl[PWM_VOLTAGE] = npwrd;
-                        cl[PWM_DUTY] = (npwrd == 0. ? 0. : 1.);
-                        cl[POWERED_PIN] = npwrd;
-                    } else {
-                        if (auto prop = cl[PWM_VOLTAGE]; double_t(prop) != 0.) {
-                            prop = 0.;
-                        }
-                        if (auto prop = cl[PWM_DUTY]; double_t(prop) != 0.) {
-                            prop = 0.;
-                        }
-                        if (auto prop = cl[POWERED_PIN]; double_t(prop) != 0.) {
-                            prop = 0.;
-                        }
-                    }
-                } else {
-                    if (auto prop = cl[PWM_VOLTAGE]; double_t(prop) != 0.) {
-                        prop = 0.;
-                    }
-                    if (auto prop = cl[PWM_DUTY]; double_t(prop) != 0.) {
-                        prop = 0.;
-                    }
-                    if (auto prop = cl[POWERED_PIN]; double_t(prop) != 0.) {
-                        prop = 0.;
-                    }
-                }
-                if (auto prop = cl[POWERING_PIN]; double_t(prop) != 0.) {
-                    prop = 0.;
-                }
-                break;
-            }
         }
     };
 
@@ -149,7 +117,7 @@ part duino::parts::pwm_pin(part_h offset) {
                      of::PWM_DUTY,
                      of::NEXT_FREE });
 
-    pt.add_waking(of::POWERING_PIN);
+    pt.set_net(of::POWERING_PIN, of::POWERED_PIN);
 
     pt.add_connection_use(direction::PIN, text("Input"));
 
@@ -55,8 +55,6 @@ part duino::parts::serial_pin(part_h offset) {
                            of::NEXT_FREE
                    });
 
-    pt.add_waking(of::POWERING_PIN);
-
     pt.add_connection_use(direction::PIN, text("Counterpart"));
 
     return pt;
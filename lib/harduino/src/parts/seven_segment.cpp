@@ -103,6 +103,8 @@ part duino::parts::seven_segment(part_h offset) {
     pt.add_visuals({ of::COLOR,
                      of::POWERING_PIN });
 
+    pt.set_shared_images();
+
     pt.add_connection_uses({{ direction::PIN[0], text("A segment") },
                             { direction::PIN[1], text("B segment") },
                             { direction::PIN[2], text("C segment") },
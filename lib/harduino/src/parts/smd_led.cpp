@@ -48,6 +48,10 @@ part duino::parts::smd_led(part_h offset) {
 
             auto & gcl = cl.as_grid_cell();
             auto color = color_t(gcl[of::COLOR]);
+            //An undriven net counts as unpowered
+            auto powered = double_t(cl[POWERED_PIN]);
+            auto level = std::isnan(powered) ? 0. : powered;
+            auto dark = double_t(cl[HIGH_VOLTAGE]) - level > .1;
 
             cr->save();
 
@@ -79,7 +83,7 @@ part duino::parts::smd_led(part_h offset) {
                 cr->arc(128., 128., 96., 0., 2 * M_PI);
                 cr->fill();
                 cr->stroke();
-                if (double_t(cl[HIGH_VOLTAGE]) - double_t(cl[POWERED_PIN]) > .1) {
+                if (dark) {
                     cr->set_operator(Cairo::OPERATOR_OVER);
                     cr->set_source_rgba(0., 0., 0., .75);
                     cr->arc(128., 128., 96., 0., 2 * M_PI);
@@ -101,7 +105,7 @@ part duino::parts::smd_led(part_h offset) {
                 cr->fill();
                 cr->stroke();
 
-                if (double_t(cl[HIGH_VOLTAGE]) - double_t(cl[POWERED_PIN]) > .1) {
+                if (dark) {
                     cr->set_operator(Cairo::OPERATOR_OVER);
                     cr->set_source_rgba(0., 0., 0., .75);
                     cr->rectangle(80., 48., 256. - 160., 256. - 96.);
@@ -126,5 +130,7 @@ part duino::parts::smd_led(part_h offset) {
                            of::NEXT_FREE + 1
                    });
 
+    pt.set_net(of::VOID, of::POWERED_PIN, false);
+
     return pt;
 }
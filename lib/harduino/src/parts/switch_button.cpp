@@ -108,5 +108,9 @@ part duino::parts::switch_button(part_h offset) {
                            of::NEXT_FREE + 1
                    });
 
+    pt.set_shared_images();
+
+    pt.set_net(of::POWERING_PIN);
+
     return pt;
 }
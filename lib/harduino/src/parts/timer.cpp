@@ -71,94 +71,63 @@ part duino::parts::timer(part_h offset) {
                         serialize::SERIALIZE,
                         std::array<uint_t, 3>{ 1, std::numeric_limits<uint_t>::max(), 1 }});
 
+    pt.add_entry(entry{ of::NEXT_FREE + 3,
+                        text("__LAST_POWERED"),
+                        text("Last powered"),
+                        value(double_t()),
+                        ui_access::INVISIBLE,
+                        serialize::NO_SERIALIZE });
+
     pt.delegates.cycle = [](cell & cl) {
-        auto connected = cl.as_grid_cell().connected();
+        //The net of the clock writes its voltage to the timer, an undriven net counts as unpowered
         auto powered = double_t(cl[of::POWERED_PIN]);
+        auto level = std::isnan(powered) ? 0. : powered;
+        auto last = double_t(cl[of::NEXT_FREE + 3]);
         auto high = double_t(cl[of::HIGH_VOLTAGE]);
         auto value = uint_t(cl[of::VALUE]);
         auto max_value = uint_t(cl[of::MAX_VALUE]) + 1;
         auto condition = inc_condition(uint_t(cl[of::NEXT_FREE + 2]));
 
-        if (connected.empty()) {
-            switch (condition) {
-                case inc_condition::NEVER:
-                case inc_condition::RISING:
-                case inc_condition::HIGH:{
-                    break;
-                }
-                case inc_condition::FALLING:
-                case inc_condition::CHANGE: {
-                    if (powered >= high) {
-                        value = (value + 1) % max_value;
-                        cl[of::VALUE] = value;
-                    }
-                    break;
-                }
-                case inc_condition::LOW:
-                case inc_condition::ALWAYS: {
-                    value = (value + 1) % max_value;
-                    cl[of::VALUE] = value;
-                }
-                default: {
-                    break;
-                }
+        auto rising = last < high && level >= high;
+        auto falling = last >= high && level < high;
+        bool_t increment;
+        switch (condition) {
+            case inc_condition::RISING: {
+                increment = rising;
+                break;
+            }
+            case inc_condition::FALLING: {
+                increment = falling;
+                break;
+            }
+            case inc_condition::CHANGE: {
+                increment = rising || falling;
+                break;
+            }
+            case inc_condition::LOW: {
+                increment = level < high;
+                break;
+            }
+            case inc_condition::HIGH: {
+                increment = level >= high;
+                break;
             }
-            if (powered != 0.) {
-                cl[of::POWERED_PIN] = 0.;
+            case inc_condition::ALWAYS: {
+                increment = true;
+                break;
             }
-        } else {
-            for (auto &[use, ncl] : connected) {
-                auto powering = double_t(ncl[of::POWERING_PIN]);
-                switch (condition) {
-                    case inc_condition::NEVER: {
-                        break;
-                    }
-                    case inc_condition::RISING: {
-                        if (powered < high && powering >= high) {
-                            value = (value + 1) % max_value;
-                            cl[of::VALUE] = value;
-                        }
-                        break;
-                    }
-                    case inc_condition::FALLING: {
-                        if (powered >= high && powering < high) {
-                            value = (value + 1) % max_value;
-                            cl[of::VALUE] = value;
-                        }
-                        break;
-                    }
-                    case inc_condition::CHANGE: {
-                        if ((powered < high && powering >= high) || (powered >= high && powering < high)) {
-                            value = (value + 1) % max_value;
-                            cl[of::VALUE] = value;
-                        }
-                        break;
-                    }
-                    case inc_condition::LOW: {
-                        if (powering < high) {
-                            value = (value + 1) % max_value;
-                            cl[of::VALUE] = value;
-                        }
-                        break;
-                    }
-                    case inc_condition::HIGH: {
-                        if (powering >= high) {
-                            value = (value + 1) % max_value;
-                            cl[of::VALUE] = value;
-                        }
-                        break;
-                    }
-                    case inc_condition::ALWAYS: {
-                        value = (value + 1) % max_value;
-                        cl[of::VALUE] = value;
-                    }
-                    default: {
-                        break;
-                    }
-                }
-                cl[of::POWERED_PIN] = powering;
+            default: {
+                increment = false;
+                break;
             }
         }
+
+        if (increment) {
+            cl[of::VALUE] = (value + 1) % max_value;
+        }
+        if (last != level) {
+            cl[of::NEXT_FREE + 3] = level;
+        }
     };
 
     pt.delegates.draw = [](cell & cl, image_t & im) {
@@ -215,6 +184,10 @@ part duino::parts::timer(part_h offset) {
                            of::MAX_VALUE
                    });
 
+    pt.set_shared_images();
+
+    pt.set_net(of::VOID, of::POWERED_PIN);
+
     pt.add_connection_use(direction::PIN, text("Clock"));
 
     return pt;
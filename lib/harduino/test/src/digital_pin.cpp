@@ -28,22 +28,17 @@ TEST_CASE("Digital pin") {
         }
 
         SECTION("Input") {
-            part npt = duino::parts::constant_pin();
-            sketch_grid_cell ngcl{ npt };
-
-            sgcl.add_connection(direction::PIN, ngcl);
+            sgcl[of::POWERING_PIN] = 5.;
             sgcl[of::PIN_MODE] = uint_t(parts::pin_mode::INPUT);
             sgcl.transit();
 
-            for (auto & volt : { 0., .5, 1. }) {
-                ngcl[of::POWERING_PIN] = volt;
-                ngcl.transit();
-
-                pt.cycle(sgcl);
-                sgcl.transit();
+            pt.cycle(sgcl);
+            sgcl.transit();
 
-                REQUIRE(double_t(sgcl[of::POWERED_PIN]) == volt);
-            }
+            //The pin leaves its net undriven, the net writes its voltage to the pin
+            REQUIRE(std::isnan(double_t(sgcl[of::POWERING_PIN])));
+            REQUIRE(pt.net_drive() == of::POWERING_PIN);
+            REQUIRE(pt.net_sense() == of::POWERED_PIN);
         }
     }
 }
@@ -2,9 +2,17 @@
 // Created by Johannes on 11.09.2020.
 //
 
+#define HAR_ENABLE_REQUEST_MACROS
+
 #include <har/duino.hpp>
+#include <har/program.hpp>
 #include <har/sketch_cell.hpp>
 
+#include "logic/automaton.hpp"
+#include "logic/inner_simulation.hpp"
+
+#include "parts.hpp"
+
 #include <catch2/catch.hpp>
 
 using namespace har;
@@ -35,4 +43,48 @@ TEST_CASE("Push button") {
         REQUIRE(sgcl[of::POWERING_PIN] == sgcl[of::LOW_VOLTAGE]);
         REQUIRE(bool_t(sgcl[of::FIRING]) == false);
     }
+
+    SECTION("Drives the net of connected pins") {
+        inner_simulation isim{ 0, nullptr, nullptr };
+        automaton & automaton = isim.get_automaton();
+        program prog{ };
+
+        isim.attach(prog);
+        isim.include_part(pt);
+        isim.include_part(duino::parts::digital_pin());
+        isim.commence();
+
+        auto & model = isim.get_model();
+        model.resize(grid_t::MODEL_GRID, isim.part_of(pt.id()), dcoords_t(2, 1));
+        auto & grid = model.get_model();
+        auto & pin = grid.at(dcoords_t(1, 0));
+        auto & pin_pt = isim.part_of(PART[parts::standard_ids::DIGITAL_PIN]);
+        pin.set_type(pin_pt);
+        pin_pt.init_standard(pin);
+        pin.set(of::PIN_MODE, value(uint_t(parts::pin_mode::INPUT)));
+        pin.transit();
+        pin.add_connection(direction::PIN, grid.at(dcoords_t(0, 0)));
+
+        auto powered = [&]() {
+            return get<double_t>(pin.get(of::POWERED_PIN));
+        };
+
+        automaton.set_state(PARTICIPANT.no_one(), automaton::state::RUN);
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(powered() == 0.);
+
+        REQUEST(ctx, prog) {
+            auto gcl = ctx.at(gcoords_t(grid_t::MODEL_GRID, 0, 0));
+            gcl.logic().press(gcl, ccoords_t());
+        }
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(powered() == 5.);
+
+        REQUEST(ctx, prog) {
+            auto gcl = ctx.at(gcoords_t(grid_t::MODEL_GRID, 0, 0));
+            gcl.logic().release(gcl, ccoords_t());
+        }
+        REQUIRE_NOTHROW(automaton.cycle());
+        REQUIRE(powered() == 0.);
+    }
 }
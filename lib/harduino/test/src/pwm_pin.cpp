@@ -33,52 +33,32 @@ TEST_CASE("PWM pin") {
         }
 
         SECTION("Input") {
-            SECTION("from PWM enabled") {
-                sketch_grid_cell ngcl{ pt };
+            sgcl[of::PIN_MODE] = uint_t(parts::pin_mode::INPUT);
+            sgcl[of::POWERING_PIN] = 5.;
+            sgcl.transit();
 
-                sgcl.add_connection(direction::PIN, ngcl);
-                sgcl[of::PIN_MODE] = uint_t(parts::pin_mode::INPUT);
-                ngcl[of::PIN_MODE] = uint_t(parts::pin_mode::OUTPUT);
+            //The net writes its mean voltage to the pin, which reads as the full duty cycle of it
+            for (auto & volt : { 0., 2.5, 5. }) {
+                sgcl[of::POWERED_PIN] = volt;
                 sgcl.transit();
 
-                for (auto &[volt, duty] : std::map<double_t, double_t>{{ 1.,  0. },
-                                                                       { 5,   .5 },
-                                                                       { 3.3, 1. }}) {
-                    ngcl[of::PWM_VOLTAGE] = volt;
-                    ngcl[of::PWM_DUTY] = duty;
-                    ngcl.transit();
-
-                    pt.cycle(sgcl);
-                    sgcl.transit();
+                pt.cycle(sgcl);
+                sgcl.transit();
 
-                    REQUIRE(double_t(sgcl[of::PWM_VOLTAGE]) == volt);
-                    REQUIRE(double_t(sgcl[of::PWM_DUTY]) == duty);
-                    REQUIRE(double_t(sgcl[of::POWERED_PIN]) == volt * duty);
-                }
+                REQUIRE(std::isnan(double_t(sgcl[of::POWERING_PIN])));
+                REQUIRE(double_t(sgcl[of::PWM_VOLTAGE]) == volt);
+                REQUIRE(double_t(sgcl[of::PWM_DUTY]) == (volt == 0. ? 0. : 1.));
             }
 
-            SECTION("from other") {
-                part npt = duino::parts::constant_pin();
-                sketch_grid_cell ngcl{ npt };
-                auto volt = 5.;
+            //An undriven net reads as no voltage
+            sgcl[of::POWERED_PIN] = std::nan("1");
+            sgcl.transit();
 
-                sgcl.add_connection(direction::PIN, ngcl);
-                sgcl[of::PIN_MODE] = uint_t(parts::pin_mode::INPUT);
-                sgcl[of::PWM_VOLTAGE] = volt;
+            pt.cycle(sgcl);
+            sgcl.transit();
 
-                for (auto & duty : { 0., .5, 1. }) {
-                    ngcl[of::POWERING_PIN] = volt * duty;
-                    ngcl.transit();
-                    sgcl.transit();
-
-                    pt.cycle(sgcl);
-                    sgcl.transit();
-
-                    REQUIRE(double_t(sgcl[of::PWM_VOLTAGE]) == volt * duty);
-                    REQUIRE(double_t(sgcl[of::PWM_DUTY]) == (duty == 0. ? 0. : 1.));
-                    REQUIRE(double_t(sgcl[of::POWERED_PIN]) == volt * duty);
-                }
-            }
+            REQUIRE(double_t(sgcl[of::PWM_VOLTAGE]) == 0.);
+            REQUIRE(double_t(sgcl[of::PWM_DUTY]) == 0.);
         }
     }
 }
@@ -7,6 +7,7 @@
 
 #include <atomic>
 
+#include <gtkmm/adjustment.h>
 #include <gtkmm/box.h>
 #include <gtkmm/entry.h>
 #include <gtkmm/fixed.h>
@@ -100,6 +101,9 @@ namespace har::gui_ {
 
         std::atomic<bool_t> _updating;
 
+        Glib::RefPtr<Gtk::Adjustment> _hadj;
+        Glib::RefPtr<Gtk::Adjustment> _vadj;
+
         std::vector<GtkTargetEntry> _target_entries;
         drag_data_received_t _ddrf;
 
@@ -117,6 +121,7 @@ namespace har::gui_ {
         drag_data_get_t _drag_data_get_fun;
         std::function<void()> _drag_failed_fun;
         drag_data_received_t _drag_data_received_fun;
+        std::function<void(grid_t, const dcoords_t &, const dcoords_t &)> _view_fun;
 
         cell & create_cell(const gcoords_t& gc);
 
@@ -128,6 +133,8 @@ namespace har::gui_ {
 
         void remove_row();
 
+        void view_changed();
+
     public:
         explicit grid(grid_t grid, uint_t res = 64u);
 
@@ -171,6 +178,8 @@ namespace har::gui_ {
 
         decltype(_drag_data_received_fun) & drag_data_received_fun();
 
+        decltype(_view_fun) & view_fun();
+
         void hide_overlay();
 
         void show_overlay();
@@ -5,6 +5,9 @@
 #ifndef HAR_GUI_MAIN_WIN_HPP
 #define HAR_GUI_MAIN_WIN_HPP
 
+#include <mutex>
+#include <shared_mutex>
+
 #include <gtkmm/window.h>
 #include <glibmm/dispatcher.h>
 
@@ -45,10 +48,15 @@ namespace har::gui_ {
 
 
         cell_h _selected;
+        std::mutex _selex; ///<Guards the selection against reads by the workers of the automaton
         cell_h _pressed;
         Glib::RefPtr<Gdk::Pixbuf> _selected_img;
         std::atomic<std::uint16_t> _updating;
 
+        static constexpr std::size_t LOOKS = 4096u; ///<Maximum number of kept images
+        std::shared_mutex _lookex;
+        har::map<har::look_t, har::map<uint_t, image_out_t>> _looks; ///<Processed images by look and resolution
+
         std::string _path;
         std::string _last_serialized;
 
@@ -59,6 +67,10 @@ namespace har::gui_ {
 
         void bind();
 
+        uint_t resolution_of(const cell_h & hnd);
+
+        bool_t is_selected(const cell_h & hnd);
+
         void btn_new_clicked();
 
         void btn_open_clicked();
@@ -98,6 +110,8 @@ namespace har::gui_ {
 
         bool on_delete_event(GdkEventAny * any_event) override;
 
+        bool on_window_state_event(GdkEventWindowState * state_event) override;
+
     public:
         explicit main_win(har::gui & parti, har::co_queue<std::function<void()>> & queue);
 
@@ -106,6 +120,10 @@ namespace har::gui_ {
 
         har::image_t process_image(har::cell_h hnd, har::image_t & img);
 
+        std::optional<har::image_t> find_image(const cell_h & hnd, const look_t & look);
+
+        void keep_image(const cell_h & hnd, const look_t & look, const har::image_t & img);
+
         void set_grid_size(const gcoords_t & to);
 
         image_out_t get_image_base(const cell_h & hnd);
@@ -2,6 +2,9 @@
 // Created by Johannes on 28.06.2020.
 //
 
+#include <algorithm>
+#include <cmath>
+
 #include <gtkmm/aspectframe.h>
 #include <gtkmm/overlay.h>
 #include <gtkmm/menubutton.h>
@@ -202,11 +205,14 @@ grid::grid(grid_t grid, uint_t res) : Gtk::Box(Gtk::ORIENTATION_VERTICAL),
                                       _img_ref(),
                                       _ref_pixbuf(),
                                       _updating(false),
+                                      _hadj(),
+                                      _vadj(),
                                       _target_entries(),
                                       _inventory(), _properties(res, grid),
                                       _size(), _res(res),
                                       _cargo_map(),
-                                      _grid_hnd(grid) {
+                                      _grid_hnd(grid),
+                                      _view_fun() {
     _inventory.drag_begin_fun() = [&](auto ...) {
         _inv_btn.set_active(false);
         hide_overlay();
@@ -282,6 +288,17 @@ grid::grid(grid_t grid, uint_t res) : Gtk::Box(Gtk::ORIENTATION_VERTICAL),
     scrl.set_min_content_height(240);
     scrl.add(vprt);
 
+    //Scrolling moves the adjustments, resizing changes their page size
+    _hadj = scrl.get_hadjustment();
+    _vadj = scrl.get_vadjustment();
+    for (auto & adj : { _hadj, _vadj }) {
+        adj->signal_value_changed().connect(sigc::mem_fun(*this, &grid::view_changed));
+        adj->signal_changed().connect(sigc::mem_fun(*this, &grid::view_changed));
+    }
+    _grid.signal_size_allocate().connect([this](Gtk::Allocation &) {
+        view_changed();
+    });
+
     Gtk::Box::pack_start(_header, Gtk::PACK_SHRINK);
     Gtk::Box::pack_start(*Gtk::manage(new Gtk::Separator(Gtk::ORIENTATION_HORIZONTAL)),
                          Gtk::PACK_SHRINK);
@@ -386,6 +403,31 @@ void grid::remove_row() {
     show_all_children();
 }
 
+void grid::view_changed() {
+    if (!_view_fun || _size.x <= 0 || _size.y <= 0) {
+        return;
+    }
+    //The homogeneous grid has a header and a padding column and row around the cells
+    auto alloc = _grid.get_allocation();
+    auto width = double_t(alloc.get_width()) / double_t(_size.x + 2);
+    auto height = double_t(alloc.get_height()) / double_t(_size.y + 2);
+    if (width <= 0. || height <= 0.) {
+        return;
+    }
+    auto first = [](double_t px, double_t ext, int_t size) {
+        return std::clamp(int_t(std::floor(px / ext)) - 1, int_t(0), size);
+    };
+    auto last = [](double_t px, double_t ext, int_t size) {
+        return std::clamp(int_t(std::ceil(px / ext)) - 1, int_t(0), size);
+    };
+    auto left = _hadj->get_value() - alloc.get_x();
+    auto top = _vadj->get_value() - alloc.get_y();
+    dcoords_t from{ first(left, width, _size.x), first(top, height, _size.y) };
+    dcoords_t to{ last(left + _hadj->get_page_size(), width, _size.x),
+                  last(top + _vadj->get_page_size(), height, _size.y) };
+    _view_fun(_grid_hnd, from, to);
+}
+
 har::dcoords_t grid::size() const {
     return _properties.size();
 }
@@ -481,6 +523,10 @@ decltype(grid::_drag_data_received_fun) & grid::drag_data_received_fun() {
     return _drag_data_received_fun;
 }
 
+decltype(grid::_view_fun) & grid::view_fun() {
+    return _view_fun;
+}
+
 void grid::hide_overlay() {
     _fixed.set_visible(false);
 }
@@ -4,6 +4,9 @@
 
 #define HAR_ENABLE_REQUEST_MACROS
 
+#include <iterator>
+#include <vector>
+
 #include <giomm.h>
 
 #include <har/gui.hpp>
@@ -49,6 +52,14 @@ har::image_t gui::process_image(har::cell_h hnd, har::image_t & img) {
     return _mwin->process_image(hnd, img);
 }
 
+std::optional<har::image_t> gui::find_image(const cell_h & hnd, const look_t & look) {
+    return _mwin->find_image(hnd, look);
+}
+
+void gui::keep_image(const cell_h & hnd, const look_t & look, const har::image_t & img) {
+    _mwin->keep_image(hnd, look, img);
+}
+
 istream & gui::input() {
 #if defined(UNICODE)
     return std::wcin;
@@ -205,6 +216,25 @@ void gui::on_redraw(const har::cell_h & hnd, har::image_t && img, bool_t commit)
     }
 }
 
+void gui::on_selection_update_batch(span<const update_t> batch) {
+    _queue.push([&win = *_mwin, updates = std::vector<update_t>(batch.begin(), batch.end())]() {
+        for (auto &[hnd, id, val] : updates) {
+            win.selection_update(hnd, id, val);
+        }
+    });
+}
+
+void gui::on_redraw_batch(span<redraw_t> batch) {
+    std::vector<redraw_t> images{ };
+    images.reserve(batch.size());
+    std::move(batch.begin(), batch.end(), std::back_inserter(images));
+    _queue.push([&win = *_mwin, images = std::move(images)]() mutable {
+        for (auto &[hnd, img] : images) {
+            win.redraw(hnd, std::move(img));
+        }
+    });
+}
+
 void gui::on_connection_added(const gcoords_t & from, const gcoords_t & to, direction_t use) {
     _queue.push([&win = *_mwin, from, to, use]() {
         win.connection_added(from, to, use);
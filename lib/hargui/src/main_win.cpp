@@ -35,9 +35,12 @@ main_win::main_win(gui & parti,
                                                                    }),
                                                                    _conn_popover(),
                                                                    _selected(gcoords_t{ grid_t::INVALID_GRID, -1, -1 }),
+                                                                   _selex(),
                                                                    _pressed(gcoords_t{ grid_t::INVALID_GRID, -1, -1 }),
                                                                    _selected_img(nullptr),
                                                                    _updating(0),
+                                                                   _lookex(),
+                                                                   _looks(),
                                                                    _path(),
                                                                    _last_serialized(),
                                                                    _undo_queue(),
@@ -243,6 +246,17 @@ void main_win::bind() {
         _bank.resolution_fun() = [=](uint_t res) {
             _parti.get().redraw_all();
         };
+
+        _model.view_fun() =
+        _bank.view_fun() = [this](grid_t cat, const dcoords_t & from, const dcoords_t & to) {
+            //Cells scrolled out of view are drawn once they are scrolled back in
+            auto & gd = cat == grid_t::MODEL_GRID ? _model : _bank;
+            if (from == dcoords_t(0, 0) && to == gd.size()) {
+                _parti.get().reset_viewport(cat);
+            } else {
+                _parti.get().set_viewport(cat, from, to);
+            }
+        };
     }
 
     /*Action bar*/ {
@@ -270,6 +284,37 @@ void main_win::bind() {
     }
 }
 
+uint_t main_win::resolution_of(const cell_h & hnd) {
+    switch (cell_cat(hnd.index())) {
+        case cell_cat::GRID_CELL: {
+            switch (std::get<uint_t(cell_cat::GRID_CELL)>(hnd).cat) {
+                case MODEL_GRID: {
+                    return _model.get_resolution();
+                }
+                case BANK_GRID: {
+                    return _bank.get_resolution();
+                }
+                case INVALID_GRID:
+                default: {
+                    return 64u;
+                }
+            }
+        }
+        case cell_cat::CARGO_CELL: {
+            return _model.get_resolution();
+        }
+        case cell_cat::INVALID_CELL:
+        default: {
+            return 64u;
+        }
+    }
+}
+
+bool_t main_win::is_selected(const cell_h & hnd) {
+    std::scoped_lock lock{ _selex };
+    return hnd == _selected;
+}
+
 void main_win::btn_new_clicked() {
     //TODO: Implement
 }
@@ -433,7 +478,10 @@ void main_win::cell_clicked(const gcoords_t & pos, const ccoords_t & at, partici
 
 void main_win::cell_selected(const gcoords_t & pos, participant::context & ctx) {
     auto old_selected = _selected;
-    _selected = pos;
+    {
+        std::scoped_lock lock{ _selex };
+        _selected = pos;
+    }
     if (pos.cat != grid_t::INVALID_GRID) {
         auto fgcl = ctx.at(pos);
         _properties.set_cell(fgcl, [&](of id, value && val) {
@@ -491,24 +539,27 @@ void main_win::cell_cycle(const gcoords_t & pos, participant::context & ctx) {
 
 void main_win::draw(const cell_h & hnd, participant::context & ctx) {
     har::image_t img = get_image_base(hnd);
-    uint_t res = 64u;
+    uint_t res = resolution_of(hnd);
+    std::optional<look_t> look;
     {
         switch (cell_cat(hnd.index())) {
             case cell_cat::GRID_CELL: {
-                const gcoords_t & gc = std::get<uint_t(cell_cat::GRID_CELL)>(hnd);
-                if (gc.cat == MODEL_GRID) {
-                    res = _model.get_resolution();
-                } else if (gc.cat == BANK_GRID) {
-                    res = _bank.get_resolution();
+                auto gcl = ctx.at(std::get<uint_t(cell_cat::GRID_CELL)>(hnd));
+                look = gcl.look();
+                if (auto kept = look ? find_image(hnd, *look) : std::nullopt) {
+                    redraw(hnd, std::move(*kept));
+                    return;
                 }
-
-                auto gcl = ctx.at(gc);
                 gcl.logic().draw(gcl, img);
                 break;
             }
             case cell_cat::CARGO_CELL: {
-                res = _model.get_resolution();
                 auto ccl = ctx.at(std::get<uint_t(cell_cat::CARGO_CELL)>(hnd));
+                look = ccl.look();
+                if (auto kept = look ? find_image(hnd, *look) : std::nullopt) {
+                    redraw(hnd, std::move(*kept));
+                    return;
+                }
                 ccl.logic().draw(ccl, img);
                 break;
             }
@@ -537,6 +588,9 @@ void main_win::draw(const cell_h & hnd, participant::context & ctx) {
             img = std::make_pair(sel_img, base_img);
         } else {
             img = base_img;
+            if (look) {
+                keep_image(hnd, *look, img);
+            }
         }
         redraw(hnd, std::move(img));
     }
@@ -559,11 +613,9 @@ Glib::RefPtr<const Gdk::Pixbuf> main_win::get_cell_image(const gcoords_t & pos)
 }
 
 void main_win::dispatch() {
-    auto & queue = _queue.get();
-    while (!queue.empty()) {
-        auto fun = queue.pop();
+    _queue.get().drain([](auto & fun) {
         fun();
-    }
+    });
 }
 
 bool main_win::on_key_release_event(GdkEventKey * key_event) {
@@ -616,6 +668,15 @@ bool main_win::on_key_release_event(GdkEventKey * key_event) {
     return false;
 }
 
+bool main_win::on_window_state_event(GdkEventWindowState * state_event) {
+    if (state_event->changed_mask & (GDK_WINDOW_STATE_ICONIFIED | GDK_WINDOW_STATE_WITHDRAWN)) {
+        //Nothing needs to be drawn while the window can't be seen
+        _parti.get().set_drawing(!(state_event->new_window_state &
+                                   (GDK_WINDOW_STATE_ICONIFIED | GDK_WINDOW_STATE_WITHDRAWN)));
+    }
+    return Gtk::Window::on_window_state_event(state_event);
+}
+
 bool main_win::on_delete_event(GdkEventAny * any_event) {
     if (!_undo_queue.empty()) {
         Gtk::MessageDialog dlg(*this,
@@ -656,38 +717,11 @@ const har::cell_h & main_win::get_selected() const {
 har::image_t main_win::process_image(har::cell_h hnd, har::image_t & img) {
     using ImageType = std::tuple<Cairo::RefPtr<Cairo::Surface>, uint_t>;
     if (img.type() == typeid(ImageType)) {
-        uint_t res = 64u;
-        switch (cell_cat(hnd.index())) {
-            case cell_cat::GRID_CELL: {
-                grid_t g = std::get<uint_t(cell_cat::GRID_CELL)>(hnd).cat;
-                switch (g) {
-                    case MODEL_GRID: {
-                        res = _model.get_resolution();
-                        break;
-                    }
-                    case BANK_GRID: {
-                        res = _bank.get_resolution();
-                        break;
-                    }
-                    case INVALID_GRID: {
-                        res = 64u;
-                        break;
-                    }
-                }
-                break;
-            }
-            case cell_cat::CARGO_CELL: {
-                res = _model.get_resolution();
-                break;
-            }
-            case cell_cat::INVALID_CELL:
-                res = 64u;
-                break;
-        }
+        uint_t res = resolution_of(hnd);
         auto &[sf, dim] = *std::any_cast<ImageType>(&img);
         auto base_img = Gdk::Pixbuf::create(sf, 0, 0, dim, dim)
                 ->scale_simple(res, res, Gdk::INTERP_BILINEAR);
-        if (hnd == _selected) {
+        if (is_selected(hnd)) {
             {
                 auto cr = Cairo::Context::create(sf);
 
@@ -708,6 +742,36 @@ har::image_t main_win::process_image(har::cell_h hnd, har::image_t & img) {
     return img;
 }
 
+std::optional<har::image_t> main_win::find_image(const cell_h & hnd, const look_t & look) {
+    //The selected cell is drawn with an overlay
+    if (is_selected(hnd)) {
+        return std::nullopt;
+    }
+    auto res = resolution_of(hnd);
+    std::shared_lock lock{ _lookex };
+    auto it = _looks.find(look);
+    if (it == _looks.end()) {
+        return std::nullopt;
+    }
+    auto kept = it->second.find(res);
+    if (kept == it->second.end()) {
+        return std::nullopt;
+    }
+    return har::image_t(kept->second);
+}
+
+void main_win::keep_image(const cell_h & hnd, const look_t & look, const har::image_t & img) {
+    if (img.type() != typeid(image_out_t)) {
+        return;
+    }
+    auto res = resolution_of(hnd);
+    std::unique_lock lock{ _lookex };
+    if (_looks.size() >= LOOKS) {
+        _looks.clear();
+    }
+    _looks[look].insert_or_assign(res, std::any_cast<const image_out_t &>(img));
+}
+
 void main_win::set_grid_size(const gcoords_t & to) {
     _updating = true;
     switch (to.cat) {
@@ -729,6 +793,10 @@ image_out_t main_win::get_image_base(const cell_h & hnd) {
 }
 
 void main_win::include_part(const har::part & pt) {
+    {
+        std::unique_lock lock{ _lookex };
+        _looks.clear();
+    }
     auto traits = pt.traits();
     if (traits & traits::COMPONENT_PART) {
         _model.include_part(pt);
@@ -747,6 +815,8 @@ void main_win::include_part(const har::part & pt) {
 void main_win::remove_part(part_h id) {
     _model.remove_part(id);
     _bank.remove_part(id);
+    std::unique_lock lock{ _lookex };
+    _looks.clear();
 }
 
 void main_win::resize_grid(const gcoords_t & to) {
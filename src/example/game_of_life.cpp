@@ -7,6 +7,21 @@
 
 using namespace har;
 
+void cycle_life(const field<bool_t> & in, field<bool_t> & out) {
+    std::vector<std::uint8_t> counts(in.width());
+
+    for (std::size_t y = 0u; y < in.height(); ++y) {
+        moore_count(in, y, counts.data());
+
+        auto alive = in.row(y);
+        auto mask = in.mask(y);
+        auto next = out.row(y);
+        for (std::size_t x = 0u; x < in.width(); ++x) {
+            next[x] = std::uint8_t(mask[x] && (counts[x] == 3u || (alive[x] && counts[x] == 2u)));
+        }
+    }
+}
+
 part gol_cell() {
     part pt{ PART[0],
              text("eg:gol_cell"),
@@ -45,37 +60,7 @@ part gol_cell() {
                         ui_access::CHANGEABLE,
                         serialize::NO_SERIALIZE });
 
-    pt.delegates.cycle = [](cell & cl) {
-        uint_t count{ 0 };
-        bool_t alive{ cl[of::VALUE] };
-
-        auto & gcl = cl.as_grid_cell();
-
-        for (auto dir : direction::cardinal) {
-            auto ncl = gcl[dir];
-            auto nncl = ncl.as_grid_cell()[cw(dir)];
-            if (ncl.is_placed() && ncl.logic() == cl.logic()) {
-                if (bool_t(ncl[of::VALUE])) {
-                    count++;
-                }
-                if (nncl.is_placed() && nncl.logic() == cl.logic()) {
-                    if (bool_t(ncl.as_grid_cell()[cw(dir)][of::VALUE])) {
-                        count++;
-                    }
-                }
-            }
-        }
-
-        if (!alive) {
-            if (count == 3) {
-                cl[of::VALUE] = true;
-            }
-        } else {
-            if (count < 2 || count > 3) {
-                cl[of::VALUE] = false;
-            }
-        }
-    };
+    pt.set_field(of::VALUE, field_kernel<bool_t>(cycle_life));
 
     pt.delegates.draw = [](cell & cl, image_t & im) {
         if (im.type() == typeid(Glib::RefPtr<Gdk::Pixbuf>)) {
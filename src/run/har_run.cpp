@@ -0,0 +1,217 @@
+#define HAR_ENABLE_REQUEST_MACROS
+
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+
+#include <har.hpp>
+#include <har/duino.hpp>
+
+using namespace har;
+
+static std::atomic<bool_t> interrupted{ false };
+
+/// \brief Program cycling a simulation without drawing anything
+class runner : public program {
+private:
+    bool_t _loaded;
+
+public:
+    runner() : program(), _loaded(false) {
+
+    }
+
+    [[nodiscard]]
+    std::string name() const override {
+        return "har_run";
+    }
+
+    [[nodiscard]]
+    bool_t wants_images() const override {
+        return false;
+    }
+
+    void on_attach(int argc, char * const argv[], char * const envp[]) override {
+        for (auto i = 1; i < argc; ++i) {
+            std::string_view option{ argv[i - 1] };
+            if (option == "-m" || option == "--model") {
+                std::string_view path_view{ argv[i] };
+                string_t path{ path_view.begin(), path_view.end() };
+                if (std::filesystem::is_regular_file(std::filesystem::path(path))) {
+                    load_model(std::filesystem::path(path));
+                    _loaded = true;
+                } else {
+                    std::cerr << "Couldn't open model " << path << "\n";
+                }
+            }
+        }
+    }
+
+    void on_message(const string_t & header, const string_t & content) override {
+        std::cerr << header << ": " << content << "\n";
+    }
+
+    [[nodiscard]]
+    bool_t loaded() const {
+        return _loaded;
+    }
+
+    /// \brief Stores the loaded model, in the binary format if the file ends in <tt>.hamb</tt>
+    bool_t store(const std::filesystem::path & path) {
+        std::ofstream ofs{ path, std::ios::binary };
+        if (ofs) {
+            store_model(ofs, path.extension() == ".hamb" ? model_format::BINARY : model_format::TEXT);
+        }
+        return bool_t(ofs);
+    }
+
+    /// \brief Cycles the simulation once
+    void tick() {
+        REQUEST(ctx, *this, UI) {
+            ctx.cycle();
+        }
+    }
+};
+
+/// \brief Includes the standard parts of HARduino into a simulation
+void include_standard_parts(simulation & sim) {
+    sim.include_part(duino::parts::empty());
+
+    sim.include_part(duino::parts::push_button());
+    sim.include_part(duino::parts::switch_button());
+    sim.include_part(duino::parts::lamp());
+    sim.include_part(duino::parts::rgb_led());
+    sim.include_part(duino::parts::seven_segment());
+
+    sim.include_part(duino::parts::proximity_sensor());
+    sim.include_part(duino::parts::color_sensor());
+    sim.include_part(duino::parts::movement_sensor());
+
+    sim.include_part(duino::parts::motor());
+    sim.include_part(duino::parts::conveyor_belt());
+    sim.include_part(duino::parts::thread_rod());
+
+    sim.include_part(duino::parts::producer());
+    sim.include_part(duino::parts::destructor());
+
+    sim.include_part(duino::parts::box_cargo());
+
+    sim.include_part(duino::parts::digital_pin());
+    sim.include_part(duino::parts::analog_pin());
+    sim.include_part(duino::parts::constant_pin());
+    sim.include_part(duino::parts::pwm_pin());
+    sim.include_part(duino::parts::serial_pin());
+
+    sim.include_part(duino::parts::smd_button());
+    sim.include_part(duino::parts::smd_led());
+    sim.include_part(duino::parts::timer());
+
+    sim.include_part(duino::parts::dummy_pin());
+    sim.include_part(duino::parts::keying_pin());
+}
+
+void usage(const char * name) {
+    std::cerr << "Usage: " << name << " -m <model.ham> [-n <ticks>] [--sparse] [--batched] [--replay <log>] [--store <file>]\n"
+              << "  -m, --model   Model to load, in the text or the binary format\n"
+              << "  -n, --ticks   Number of cycles to run, runs until interrupted if omitted or 0\n"
+              << "  --sparse      Only cycle active cells\n"
+              << "  --batched     Cycle runs of cells of the same part in batches\n"
+              << "  --replay      Replay the requests of a run recorded with --record\n"
+              << "  --store       Store the model and exit, in the binary format if the file ends in .hamb\n";
+}
+
+/// \brief Runs a model headless as fast as possible and reports the cycles per second
+int main(int argc, char * argv[], char * envp[]) {
+    using clock = std::chrono::steady_clock;
+
+    uint_t ticks{ 0u };
+    bool_t sparse{ false };
+    bool_t batched{ false };
+    std::ifstream replay{ };
+    std::filesystem::path store{ };
+    for (auto i = 1; i < argc; ++i) {
+        std::string_view option{ argv[i] };
+        if ((option == "-n" || option == "--ticks") && i + 1 < argc) {
+            std::string_view arg{ argv[++i] };
+            auto[end, err] = std::from_chars(arg.data(), arg.data() + arg.size(), ticks);
+            if (err != std::errc() || end != arg.data() + arg.size() || arg.empty()) {
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (option == "--sparse") {
+            sparse = true;
+        } else if (option == "--batched") {
+            batched = true;
+        } else if (option == "--replay" && i + 1 < argc) {
+            replay.open(argv[++i], std::ios::binary);
+            if (!replay) {
+                std::cerr << "Couldn't open log " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (option == "--store" && i + 1 < argc) {
+            store = argv[++i];
+        } else if (option == "-h" || option == "--help") {
+            usage(argv[0]);
+            return 0;
+        }
+    }
+
+    simulation sim{ argc, argv, envp };
+    runner run{ };
+
+    include_standard_parts(sim);
+    sim.attach(run);
+    if (!run.loaded()) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (!store.empty()) {
+        if (run.store(store)) {
+            return 0;
+        }
+        std::cerr << "Couldn't store model " << store << "\n";
+        return 1;
+    }
+
+    sim.set_sparse(sparse);
+    sim.set_batched(batched);
+    if (replay.is_open()) {
+        sim.replay(replay);
+    }
+    sim.commence();
+    run.start();
+
+    std::signal(SIGINT, [](int) {
+        interrupted.store(true, std::memory_order_relaxed);
+    });
+
+    auto start = clock::now();
+    auto report = start;
+    uint_t done{ 0u };
+    uint_t reported{ 0u };
+    while ((ticks == 0u || done < ticks) && !interrupted.load(std::memory_order_relaxed)) {
+        run.tick();
+        ++done;
+
+        if (ticks == 0u) {
+            if (auto now = clock::now(); now - report >= std::chrono::seconds(1)) {
+                std::chrono::duration<double_t> span = now - report;
+                std::cout << (done - reported) / span.count() << " ticks/s" << std::endl;
+                report = now;
+                reported = done;
+            }
+        }
+    }
+
+    std::chrono::duration<double_t> elapsed = clock::now() - start;
+    std::cout << done << " ticks in " << elapsed.count() << " s, "
+              << done / elapsed.count() << " ticks/s" << std::endl;
+
+    return 0;
+}